@@ -1,8 +1,10 @@
 
 #include <bout/derivs.hxx>
+#include <bout/fused_derivs.hxx>
 #include <bout/invert_laplace.hxx>
 #include <bout/physicsmodel.hxx>
 #include <bout/smoothing.hxx>
+#include <bout/thread_pool.hxx>
 
 class HW : public PhysicsModel {
 private:
@@ -18,6 +20,7 @@ private:
   // Poisson brackets: b0 x Grad(f) dot Grad(g) / B = [f, g]
   // Method to use: BRACKET_ARAKAWA, BRACKET_STD or BRACKET_SIMPLE
   BRACKET_METHOD bm; // Bracket method for advection terms
+  bool fused;        // Calculate the derivatives of phi together?
 
   std::unique_ptr<Laplacian> phiSolver; // Laplacian solver for vort -> phi
 
@@ -81,6 +84,11 @@ protected:
       return 1;
     }
 
+    // The fused derivatives always use C2 differences, so can only
+    // replace the usual operators if they would use C2 too
+    fused = (bm == BRACKET_ARAKAWA)
+            and bout::derivatives::PerpDerivatives::defaultMethodsAreC2();
+
     return 0;
   }
 
@@ -102,10 +110,35 @@ protected:
       nonzonal_phi -= averageY(DC(phi));
     }
 
-    ddt(n) =
-        -bracket(phi, n, bm) + alpha * (nonzonal_phi - nonzonal_n) - kappa * DDZ(phi);
+    Field3D phi_n, phi_vort, dphidz;
+    if (fused) {
+      // Calculate all the derivatives of phi in one pass
+      bout::derivatives::PerpDerivatives()
+          .bracket(phi, n, phi_n)
+          .bracket(phi, vort, phi_vort)
+          .DDZ(phi, dphidz)
+          .run();
+    } else {
+      // The operators are independent, so can be calculated at the
+      // same time by the thread pool, if there is one
+      bout::TaskGroup tasks;
+      tasks.run([&]() { phi_n = bracket(phi, n, bm); });
+      tasks.run([&]() { phi_vort = bracket(phi, vort, bm); });
+      tasks.run([&]() { dphidz = DDZ(phi); });
+      tasks.wait();
+    }
 
-    ddt(vort) = -bracket(phi, vort, bm) + alpha * (nonzonal_phi - nonzonal_n);
+    // Both time derivatives in one pass over the grid, rather than a
+    // loop (and parallel region) for each operator
+    Field3D dndt{emptyFrom(n)};
+    Field3D dvortdt{emptyFrom(vort)};
+    bout::parallelFor(n.getRegion("RGN_NOBNDRY"), [&](const Ind3D& i) {
+      const BoutReal coupling = alpha * (nonzonal_phi[i] - nonzonal_n[i]);
+      dndt[i] = -phi_n[i] + coupling - kappa * dphidz[i];
+      dvortdt[i] = -phi_vort[i] + coupling;
+    });
+    ddt(n) = dndt;
+    ddt(vort) = dvortdt;
 
     return 0;
   }
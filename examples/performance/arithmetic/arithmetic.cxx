@@ -12,6 +12,7 @@
 using SteadyClock = std::chrono::time_point<std::chrono::steady_clock>;
 using Duration = std::chrono::duration<double>;
 using namespace std::chrono;
+using bout::expr::lazy;
 
 #define TIMEIT(elapsed, ...)                                                     \
   {                                                                              \
@@ -69,7 +70,7 @@ protected:
           });
 
       // Template expressions
-      TIMEIT(elapsed3, result3 = eval3D(add(mul(2, a), mul(b, c))););
+      TIMEIT(elapsed3, result3 = 2. * lazy(a) + lazy(b) * c;);
 
       // Range iterator
       result4.allocate();
@@ -14,6 +14,7 @@
 using SteadyClock = std::chrono::time_point<std::chrono::steady_clock>;
 using Duration = std::chrono::duration<double>;
 using namespace std::chrono;
+using bout::expr::lazy;
 
 #define TIMEIT(NAME, ...)                                                        \
   {                                                                              \
@@ -75,7 +76,7 @@ protected:
 
       // Template expressions
       result3.allocate();
-      TIMEIT("Templates", result3 = eval3D(add(mul(2, a), mul(b, c))););
+      TIMEIT("Templates", result3 = 2. * lazy(a) + lazy(b) * c;);
 
       // Range iterator
       result4.allocate();
@@ -0,0 +1,12 @@
+#!/usr/bin/env bash
+NP=1
+FLAGS="-q -q -q -q"
+EXE=thread_pool
+
+make
+
+for threads in 1 2 4; do
+  echo "OMP_NUM_THREADS=${threads}, thread_pool_threads=$((threads - 1))"
+  OMP_NUM_THREADS=${threads} mpirun -np ${NP} ./${EXE} ${FLAGS} \
+    thread_pool_threads=$((threads - 1))
+done
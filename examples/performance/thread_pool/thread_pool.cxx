@@ -0,0 +1,122 @@
+/*
+ * Timing of the loops in a Hasegawa-Wakatani-like RHS, using OpenMP
+ * parallel regions (BOUT_FOR) and the persistent thread pool
+ *
+ */
+
+#include <bout/bout.hxx>
+#include <bout/derivs.hxx>
+#include <bout/difops.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include "bout/region.hxx"
+#include "bout/thread_pool.hxx"
+
+using SteadyClock = std::chrono::time_point<std::chrono::steady_clock>;
+using Duration = std::chrono::duration<double>;
+using namespace std::chrono;
+using namespace bout::globals;
+
+#define ITERATOR_TEST_BLOCK(NAME, ...)                                              \
+  {                                                                                 \
+    __VA_ARGS__                                                                     \
+    names.push_back(NAME);                                                          \
+    SteadyClock start = steady_clock::now();                                        \
+    for (int repetitionIndex = 0; repetitionIndex < NUM_LOOPS; repetitionIndex++) { \
+      __VA_ARGS__;                                                                  \
+    }                                                                               \
+    times.push_back(steady_clock::now() - start);                                   \
+  }
+
+int main(int argc, char** argv) {
+  BoutInitialise(argc, argv);
+  std::vector<std::string> names;
+  std::vector<Duration> times;
+
+  auto& modelOpts = Options::root()["thread_pool_test"];
+  const int NUM_LOOPS = modelOpts["NUM_LOOPS"].withDefault(1000);
+
+  ConditionalOutput time_output(Output::getInstance());
+  time_output.enable(true);
+
+  const BoutReal alpha = 1.0;
+  const BoutReal kappa = 0.5;
+
+  Field3D n = 1.0, vort = 2.0, phi = 0.5;
+  Field3D phi_n{emptyFrom(n)}, phi_vort{emptyFrom(n)}, dphidz{emptyFrom(n)};
+  Field3D ddt_n{emptyFrom(n)}, ddt_vort{emptyFrom(n)};
+  phi_n = 0.1;
+  phi_vort = 0.2;
+  dphidz = 0.3;
+
+  const auto& region = mesh->getRegion3D("RGN_NOBNDRY");
+
+  // The combination of terms at the end of the RHS, with a loop for
+  // each operator, as the field operators would, and as one loop
+  ITERATOR_TEST_BLOCK(
+      "BOUT_FOR, loop per term",
+      BOUT_FOR(i, region) { ddt_n[i] = alpha * (phi[i] - n[i]); }
+      BOUT_FOR(i, region) { ddt_vort[i] = ddt_n[i] - phi_vort[i]; }
+      BOUT_FOR(i, region) { ddt_n[i] -= phi_n[i] + kappa * dphidz[i]; });
+
+  ITERATOR_TEST_BLOCK(
+      "parallelFor, loop per term",
+      bout::parallelFor(region,
+                        [&](const Ind3D& i) { ddt_n[i] = alpha * (phi[i] - n[i]); });
+      bout::parallelFor(region,
+                        [&](const Ind3D& i) { ddt_vort[i] = ddt_n[i] - phi_vort[i]; });
+      bout::parallelFor(region, [&](const Ind3D& i) {
+        ddt_n[i] -= phi_n[i] + kappa * dphidz[i];
+      }););
+
+  ITERATOR_TEST_BLOCK(
+      "BOUT_FOR, one loop", BOUT_FOR(i, region) {
+        const BoutReal coupling = alpha * (phi[i] - n[i]);
+        ddt_n[i] = -phi_n[i] + coupling - kappa * dphidz[i];
+        ddt_vort[i] = -phi_vort[i] + coupling;
+      });
+
+  ITERATOR_TEST_BLOCK(
+      "parallelFor, one loop", bout::parallelFor(region, [&](const Ind3D& i) {
+        const BoutReal coupling = alpha * (phi[i] - n[i]);
+        ddt_n[i] = -phi_n[i] + coupling - kappa * dphidz[i];
+        ddt_vort[i] = -phi_vort[i] + coupling;
+      }););
+
+  // The derivatives, one after the other using OpenMP in each, or at
+  // the same time in the pool
+  ITERATOR_TEST_BLOCK("Derivatives in sequence", phi_n = bracket(phi, n, BRACKET_ARAKAWA);
+                      phi_vort = bracket(phi, vort, BRACKET_ARAKAWA);
+                      dphidz = DDZ(phi););
+
+  ITERATOR_TEST_BLOCK(
+      "Derivatives in TaskGroup", bout::TaskGroup tasks;
+      tasks.run([&]() { phi_n = bracket(phi, n, BRACKET_ARAKAWA); });
+      tasks.run([&]() { phi_vort = bracket(phi, vort, BRACKET_ARAKAWA); });
+      tasks.run([&]() { dphidz = DDZ(phi); }); tasks.wait(););
+
+  // Report
+  time_output << "Threads in pool: " << bout::ThreadPool::getInstance().size() << "\n";
+  constexpr auto min_width = 5;
+  const auto width =
+      min_width
+      + std::max_element(begin(names), end(names), [](const auto& a, const auto& b) {
+          return a.size() < b.size();
+        })->size();
+  time_output << std::setw(width) << "Case name"
+              << "\t"
+              << "Time per iteration (s)"
+              << "\n";
+  for (std::size_t i = 0; i < names.size(); i++) {
+    time_output << std::setw(width) << names[i] << "\t" << times[i].count() / NUM_LOOPS
+                << "\n";
+  }
+
+  BoutFinalise();
+  return 0;
+}
@@ -0,0 +1,8 @@
+#!/usr/bin/env bash
+NP=1
+FLAGS="-q -q -q -q"
+EXE=tiling
+
+make
+
+mpirun -np ${NP} ./${EXE} ${FLAGS}
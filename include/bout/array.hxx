@@ -4,10 +4,10 @@
  * Provides an interface to create, iterate over and release
  * arrays of templated types.
  *
- * Each type and array size has an object store, so when
- * arrays are released they are put into a store. Rather
- * than allocating memory, objects are retrieved from the
- * store. This minimises new and delete operations.
+ * Each type has a memory pool, so when arrays are released
+ * they are put into the pool. Rather than allocating memory,
+ * arrays of similar size are retrieved from the pool. This
+ * minimises new and delete operations.
  *
  *
  * Ben Dudson, University of York, 2015
@@ -27,8 +27,15 @@
 #define __ARRAY_H__
 
 #include <algorithm>
-#include <map>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #ifdef _OPENMP
@@ -45,6 +52,10 @@
 #include <bout/assert.hxx>
 #include <bout/openmpwrap.hxx>
 
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 namespace {
 template <typename T>
 using iterator = T*;
@@ -52,13 +63,38 @@ template <typename T>
 using const_iterator = const T*;
 } // namespace
 
+/// How `ArrayData` allocates memory, shared by all types. Changes
+/// only affect arrays allocated afterwards, so these should be set
+/// during initialisation. Not used if memory is allocated by Umpire
+struct ArrayAllocation {
+  /// Alignment in bytes, a power of two which is at least
+  /// sizeof(void*). The default is enough for the widest SIMD loads
+  std::size_t alignment{64};
+  /// Ask the kernel to back allocations of at least `huge_page_size`
+  /// bytes with transparent huge pages. These allocations are
+  /// aligned to, and rounded up to a multiple of, `huge_page_size`
+  bool huge_pages{false};
+  std::size_t huge_page_size{2 * 1024 * 1024};
+  /// Initialise new allocations in parallel, with the same static
+  /// OpenMP schedule as `BOUT_FOR` over the whole array. Each page is
+  /// then placed in the memory closest to the thread which will use
+  /// it, rather than all in the memory of the allocating thread
+  bool first_touch{false};
+};
+
+/// The settings used by all `ArrayData` allocations
+inline ArrayAllocation& arrayAllocation() {
+  static ArrayAllocation settings;
+  return settings;
+}
+
 /*!
  * ArrayData holds the actual data
  * Handles the allocation and deletion of data
  */
 template <typename T>
 struct ArrayData {
-  ArrayData(int size) : len(size) {
+  ArrayData(int size) : len(size), capacity_(size) {
     // Allocate memory array
     // Note: By allocating with Umpire, the raw data
     //       array can be accessed on GPU devices
@@ -72,13 +108,21 @@ struct ArrayData {
 #endif
     data = static_cast<T*>(allocator.allocate(size * sizeof(T)));
 #else // BOUT_HAS_UMPIRE
-    data = new T[len];
+    data = allocate(len);
 #endif
   }
 
+  /// Wrap existing memory \p external of length \p size. This does
+  /// not take ownership: \p external must outlive this object, and
+  /// is not freed by it
+  ArrayData(T* external, int size)
+      : len(size), capacity_(size), data(external), owner(false) {}
+
   /// Move constructor
-  ArrayData(ArrayData&& in) noexcept : len(in.len), data(in.data) {
+  ArrayData(ArrayData&& in) noexcept
+      : len(in.len), capacity_(in.capacity_), data(in.data), owner(in.owner) {
     in.len = 0;
+    in.capacity_ = 0;
     in.data = nullptr;
   }
 
@@ -86,16 +130,28 @@ struct ArrayData {
   ArrayData(const ArrayData& in) = delete;
 
   ~ArrayData() {
+    if (!owner) {
+      return;
+    }
 #if BOUT_HAS_UMPIRE
     auto& rm = umpire::ResourceManager::getInstance();
     rm.deallocate(data);
 #else
-    delete[] data;
+    deallocate(data, capacity_);
 #endif
   }
   iterator<T> begin() const { return data; }
   iterator<T> end() const { return data + len; }
   int size() const { return len; }
+  /// Number of elements allocated, which may be more than size()
+  int capacity() const { return capacity_; }
+  /// Change the size to \p size, which must not be more than capacity()
+  void resize(int size) {
+    ASSERT1(0 <= size and size <= capacity_);
+    len = size;
+  }
+  /// Is the memory owned (and so freed) by this object?
+  bool ownsData() const { return owner; }
 
   /// Copy assignment
   /// Copy the underlying data from one array to the other
@@ -111,19 +167,24 @@ struct ArrayData {
   ArrayData<T>& operator=(ArrayData<T>&& in) noexcept {
     if (this != &in) {
       // Free resources
+      if (owner) {
 #if BOUT_HAS_UMPIRE
-      auto& rm = umpire::ResourceManager::getInstance();
-      rm.deallocate(data);
+        auto& rm = umpire::ResourceManager::getInstance();
+        rm.deallocate(data);
 #else
-      delete[] data;
+        deallocate(data, capacity_);
 #endif
+      }
       // Copy pointers
       len = in.len;
+      capacity_ = in.capacity_;
       data = in.data;
+      owner = in.owner;
 
       // Remove pointer from input so that it is
       // not freed multiple times
       in.len = 0;
+      in.capacity_ = 0;
       in.data = nullptr;
     }
     return *this;
@@ -133,8 +194,96 @@ struct ArrayData {
   inline const T& operator[](int ind) const { return data[ind]; }
 
 private:
-  int len; ///< Size of the array
-  T* data; ///< Array of data
+  int len;          ///< Size of the array
+  int capacity_;    ///< Number of elements allocated
+  T* data;          ///< Array of data
+  bool owner{true}; ///< Free data on destruction?
+
+#if !BOUT_HAS_UMPIRE
+  /// Allocate and initialise \p size elements, using the settings in
+  /// `arrayAllocation()`
+  static T* allocate(int size) {
+    const auto& settings = arrayAllocation();
+
+    std::size_t bytes = std::max<std::size_t>(size * sizeof(T), 1);
+    std::size_t alignment = std::max(settings.alignment, alignof(T));
+    const bool huge = settings.huge_pages and (bytes >= settings.huge_page_size);
+    if (huge) {
+      alignment = std::max(alignment, settings.huge_page_size);
+      bytes = ((bytes + settings.huge_page_size - 1) / settings.huge_page_size)
+              * settings.huge_page_size;
+    }
+
+    void* memory = nullptr;
+#ifdef _WIN32
+    memory = _aligned_malloc(bytes, alignment);
+#else
+    if (posix_memalign(&memory, alignment, bytes) != 0) {
+      memory = nullptr;
+    }
+#endif
+    if (memory == nullptr) {
+      throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge) {
+      // Only advice, so failure can be ignored
+      madvise(memory, bytes, MADV_HUGEPAGE);
+    }
+#endif
+
+    T* result = static_cast<T*>(memory);
+    if (settings.first_touch) {
+      // Writing the values places the pages. Small arrays aren't
+      // worth starting threads for
+      BOUT_OMP(parallel for schedule(static) if (bytes >= first_touch_min_bytes))
+      for (int i = 0; i < size; ++i) {
+        new (result + i) T();
+      }
+    } else {
+      for (int i = 0; i < size; ++i) {
+        new (result + i) T;
+      }
+    }
+    return result;
+  }
+
+  /// Smallest allocation which is initialised in parallel
+  static constexpr std::size_t first_touch_min_bytes = 64 * 1024;
+
+  /// Destroy and free \p size elements allocated with `allocate`
+  static void deallocate(T* memory, int size) {
+    if (memory == nullptr) {
+      return;
+    }
+    if (not std::is_trivially_destructible<T>::value) {
+      for (int i = 0; i < size; ++i) {
+        memory[i].~T();
+      }
+    }
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+  }
+#endif
+};
+
+/// Statistics for the pool of memory used by `Array`, summed over
+/// the caches of all threads
+struct ArrayPoolStats {
+  /// Number of arrays which reused memory from the pool
+  std::size_t hits{0};
+  /// Number of arrays which had to allocate new memory
+  std::size_t misses{0};
+  /// Number of released arrays which were freed because the pool was full
+  std::size_t discarded{0};
+  /// Memory currently held in the pool, in bytes
+  std::size_t bytes_held{0};
+  /// Sum of the most memory each thread's cache has held. With more
+  /// than one thread, this may be more than `bytes_held` ever was
+  std::size_t peak_bytes_held{0};
 };
 
 /*!
@@ -152,10 +301,31 @@ private:
  *
  * When an Array goes out of scope or is deleted,
  * the underlying memory (dataBlock/Backing) is put into
- * a map, rather than being freed.
- * If the same size arrays are used repeatedly then this
+ * a pool, rather than being freed.
+ * If arrays of similar size are used repeatedly then this
  * avoids the need to use new and delete.
  *
+ * The pool sorts blocks into size classes: sizes up to 64 are
+ * rounded up to a multiple of 8, and there are four classes between
+ * each larger power of two. If the Backing has capacity() and
+ * resize() (as ArrayData and std::vector do), blocks are allocated
+ * with the largest size in their class, so a new Array can reuse any
+ * block in its class. Otherwise, only blocks of exactly the same size
+ * are reused.
+ *
+ * Each thread has its own cache of blocks, so taking blocks from and
+ * returning them to the pool doesn't need any locks. A block
+ * released on a different thread to the one which allocated it is
+ * passed back to the allocating thread's cache through a lock-free
+ * list, so that memory doesn't pile up on threads which release more
+ * arrays than they allocate.
+ *
+ * The memory held in each thread's cache can be limited with
+ * setPoolLimit, after which released blocks are freed. poolStats()
+ * returns counts of how often the pool was used, and how much memory
+ * it holds. The counts are kept by each thread, and only added up by
+ * poolStats(), so that threads don't share them.
+ *
  * This behaviour can be disabled by calling the static function useStore:
  *
  * Array<dcomplex>::useStore(false); // Disables memory store
@@ -216,6 +386,25 @@ public:
    */
   Array(Array&& other) noexcept { swap(*this, other); }
 
+  /*!
+   * Create an Array which uses existing memory \p external of length
+   * \p len, without copying it or taking ownership of it
+   *
+   * double buffer[100];
+   * auto a = Array<double>::view(buffer, 100);
+   * a[10] = 1.0; // buffer[10] is now 1.0
+   *
+   * The memory must outlive the Array and any copies of it. Views
+   * are never put into the store. As usual, ensureUnique() on a
+   * shared view copies the data into new memory, after which the
+   * Array no longer refers to \p external
+   */
+  static Array view(T* external, size_type len) {
+    Array result;
+    result.ptr = std::make_shared<dataBlock>(external, len);
+    return result;
+  }
+
   /*!
    * Reallocate the array with size = \p new_size
    *
@@ -254,16 +443,28 @@ public:
   /*!
    * Delete all data from the store and disable the store
    *
-   * Note: After this is called the store cannot be re-enabled
+   * Note: After this is called the store cannot be re-enabled. No
+   * other threads should be using Arrays of this type at the time
    */
   static void cleanup() {
-    // Clean the store, deleting data
-    store(true);
     // Don't use the store anymore. This is so that array releases
     // after cleanup() get deleted rather than put into the store
     useStore(false);
+    // Clean the store, deleting data
+    pool().clear();
   }
 
+  /*!
+   * Limit the memory held in each thread's cache for this type to
+   * \p bytes. Arrays released when the cache is full are freed
+   */
+  static void setPoolLimit(std::size_t bytes) noexcept { pool().limit = bytes; }
+
+  /*!
+   * Statistics on the use of the pool for this type, by all threads
+   */
+  static ArrayPoolStats poolStats() noexcept { return pool().stats(); }
+
   /*!
    * Returns true if the Array is empty
    */
@@ -360,114 +561,356 @@ private:
    */
   dataPtrType ptr;
 
-  using storeType = std::map<size_type, std::vector<dataPtrType>>;
-  using arenaType = std::vector<storeType>;
+  struct ThreadCache;
+
+  /// Deleter for blocks allocated by the pool, which records the
+  /// thread cache that the block belongs to. While the block is
+  /// waiting to be returned to that cache from another thread, it is
+  /// kept alive by `self`, and linked to the next returned block
+  struct PoolDeleter {
+    ThreadCache* owner{nullptr};
+    dataPtrType self{};
+    PoolDeleter* next{nullptr};
+
+    void operator()(dataBlock* block) const { delete block; }
+  };
+
+  /// Blocks owned by one thread, sorted by size class
+  struct ThreadCache {
+    std::vector<std::vector<dataPtrType>> classes;
+    /// Blocks released by other threads, not yet put into `classes`
+    std::atomic<PoolDeleter*> returned{nullptr};
+    /// Is a thread using this cache? Protected by the Pool mutex
+    bool in_use{true};
+
+    /// Statistics of this cache. Only the thread using the cache
+    /// changes them, except `discarded`, so they don't need atomic
+    /// read-modify-writes. They are atomic so that `poolStats` can
+    /// read them from another thread
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+    std::atomic<std::size_t> discarded{0};
+    /// Bytes in `classes`. Blocks in `returned` are counted once
+    /// they are collected
+    std::atomic<std::size_t> bytes_held{0};
+    std::atomic<std::size_t> peak_bytes_held{0};
+
+    /// Add \p value to \p counter, which only this thread changes
+    static void add(std::atomic<std::size_t>& counter, std::size_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value,
+                    std::memory_order_relaxed);
+    }
+
+    /// Put \p block into its size class
+    void store(dataPtrType block) {
+      const std::size_t bytes = blockBytes(*block, 0);
+      sizeClass(sizeClassIndex(block->size())).push_back(std::move(block));
+      add(bytes_held, bytes);
+      const std::size_t held = bytes_held.load(std::memory_order_relaxed);
+      if (held > peak_bytes_held.load(std::memory_order_relaxed)) {
+        peak_bytes_held.store(held, std::memory_order_relaxed);
+      }
+    }
+
+    /// Blocks in size class \p index
+    std::vector<dataPtrType>& sizeClass(std::size_t index) {
+      if (classes.size() <= index) {
+        classes.resize(index + 1);
+      }
+      return classes[index];
+    }
+
+    /// Move the blocks returned by other threads into `classes`
+    void collectReturned() {
+      if (returned.load(std::memory_order_relaxed) == nullptr) {
+        return;
+      }
+      PoolDeleter* deleter = returned.exchange(nullptr, std::memory_order_acquire);
+      while (deleter != nullptr) {
+        PoolDeleter* next = deleter->next;
+        store(std::move(deleter->self));
+        deleter = next;
+      }
+    }
+
+    void clear() {
+      collectReturned();
+      classes.clear();
+      bytes_held = 0;
+    }
+  };
+
+  /// All of the thread caches for this type
+  struct Pool {
+    /// Protects `caches`
+    std::mutex mutex;
+    /// Caches are never deleted, because blocks may be returned to
+    /// them after their thread has finished. Instead they are reused
+    /// by new threads
+    std::vector<std::unique_ptr<ThreadCache>> caches;
+
+    /// Most bytes held by each cache
+    std::atomic<std::size_t> limit{std::numeric_limits<std::size_t>::max()};
+
+    /// Find an unused cache, or create one
+    ThreadCache* adopt() {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto& cache : caches) {
+        if (not cache->in_use) {
+          cache->in_use = true;
+          return cache.get();
+        }
+      }
+      caches.emplace_back(new ThreadCache());
+      return caches.back().get();
+    }
+
+    void abandon(ThreadCache* cache) {
+      std::lock_guard<std::mutex> lock(mutex);
+      cache->in_use = false;
+    }
+
+    /// Free all blocks in all caches
+    void clear() {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto& cache : caches) {
+        cache->clear();
+      }
+    }
+
+    /// Statistics added up over all caches
+    ArrayPoolStats stats() {
+      std::lock_guard<std::mutex> lock(mutex);
+      ArrayPoolStats result;
+      for (const auto& cache : caches) {
+        result.hits += cache->hits.load(std::memory_order_relaxed);
+        result.misses += cache->misses.load(std::memory_order_relaxed);
+        result.discarded += cache->discarded.load(std::memory_order_relaxed);
+        result.bytes_held += cache->bytes_held.load(std::memory_order_relaxed);
+        result.peak_bytes_held += cache->peak_bytes_held.load(std::memory_order_relaxed);
+      }
+      return result;
+    }
+  };
 
   /*!
-   * This maps from array size (size_type) to vectors of pointers to dataBlock objects
+   * The pool for this type
    *
-   * By putting the static store inside a function it is initialised on first use,
-   * and doesn't need to be separately declared for each type T
-   *
-   * Inputs
-   * ------
-   *
-   * @param[in] cleanup   If set to true, deletes all dataBlock and clears the store
+   * By putting the static pool inside a function it is initialised on first use,
+   * and doesn't need to be separately declared for each type T. It is
+   * never deleted, so that threads which finish during program exit
+   * can still give back their caches. The memory in it is freed by
+   * cleanup()
    */
-  static storeType& store(bool cleanup = false) {
-#ifdef _OPENMP
-    static arenaType arena(omp_get_max_threads());
-#else
-    static arenaType arena(1);
-#endif
-    if (!cleanup) {
-#ifdef _OPENMP
-      return arena[omp_get_thread_num()];
-#else
-      return arena[0];
-#endif
-    }
+  static Pool& pool() {
+    static auto* instance = new Pool();
+    return *instance;
+  }
 
-    // Clean by deleting all data -- possible that just stores.clear() is
-    // sufficient rather than looping over each entry.
-    BOUT_OMP(single)
-    {
-      for (auto& stores : arena) {
-        for (auto& p : stores) {
-          auto& v = p.second;
-          for (dataPtrType a : v) {
-            a.reset();
-          }
-          v.clear();
-        }
-        stores.clear();
+  /// Gives the cache back to the pool when the thread finishes
+  struct CacheHandle {
+    ThreadCache* cache{nullptr};
+    ~CacheHandle() {
+      if (cache != nullptr) {
+        pool().abandon(cache);
       }
-      // Here we ensure there is exactly one empty map still
-      // left in the arena as we have to return one such item
-      arena.resize(1);
     }
+  };
 
-    // Store should now be empty but we need to return something,
-    // so return an empty storeType from the arena.
-    return arena[0];
+  /// This thread's cache, which is null until `threadCache` is first called
+  static CacheHandle& cacheHandle() noexcept {
+    static thread_local CacheHandle handle;
+    return handle;
+  }
+
+  static ThreadCache& threadCache() {
+    auto& handle = cacheHandle();
+    if (handle.cache == nullptr) {
+      handle.cache = pool().adopt();
+    }
+    return *handle.cache;
+  }
+
+  /// Four size classes between 2^octave and 2^(octave + 1), for
+  /// \p len greater than 64
+  static int sizeClassOctave(size_type len) {
+    int octave = 0;
+    for (size_type n = len - 1; n > 1; n >>= 1) {
+      ++octave;
+    }
+    return octave;
+  }
+
+  /// Index of the size class for blocks of size \p len
+  static std::size_t sizeClassIndex(size_type len) {
+    if (len <= 64) {
+      return (len + 7) / 8;
+    }
+    const int octave = sizeClassOctave(len);
+    const int shift = octave - 2;
+    const std::size_t steps = ((len - 1) >> shift) + 1; // In the range 5 to 8
+    return 9 + (4 * (octave - 6)) + (steps - 5);
+  }
+
+  /// Largest size in the class of \p len, or \p len if that's too
+  /// large for size_type
+  static size_type sizeClassCapacity(size_type len) {
+    if (len <= 64) {
+      return ((len + 7) / 8) * 8;
+    }
+    const int shift = sizeClassOctave(len) - 2;
+    const std::size_t capacity = ((static_cast<std::size_t>(len - 1) >> shift) + 1)
+                                 << shift;
+    if (capacity > static_cast<std::size_t>(std::numeric_limits<size_type>::max())) {
+      return len;
+    }
+    return static_cast<size_type>(capacity);
+  }
+
+  /// Size to allocate for a block of size \p len: the capacity of its
+  /// size class if the Backing can be resized, so that it can be
+  /// reused for any size in the class
+  template <typename B = dataBlock>
+  static auto allocationSize(size_type len, int)
+      -> decltype(std::declval<B&>().resize(len), std::declval<B&>().capacity(),
+                  size_type{}) {
+    return sizeClassCapacity(len);
+  }
+  template <typename B = dataBlock>
+  static size_type allocationSize(size_type len, long) {
+    return len;
+  }
+
+  /// Can \p block be resized to \p len? If the Backing doesn't have
+  /// capacity() and resize(), then only if it's already the right size
+  template <typename B>
+  static auto fits(const B& block, size_type len, int)
+      -> decltype(block.capacity(), true) {
+    return static_cast<size_type>(block.capacity()) >= len;
+  }
+  template <typename B>
+  static bool fits(const B& block, size_type len, long) {
+    return static_cast<size_type>(block.size()) == len;
+  }
+
+  template <typename B>
+  static auto reuse(B& block, size_type len, int) -> decltype(block.resize(len)) {
+    block.resize(len);
+  }
+  template <typename B>
+  static void reuse(B&, size_type, long) {}
+
+  /// Memory used by \p block in bytes
+  template <typename B>
+  static auto blockBytes(const B& block, int)
+      -> decltype(block.capacity(), std::size_t{}) {
+    return block.capacity() * sizeof(T);
+  }
+  template <typename B>
+  static std::size_t blockBytes(const B& block, long) {
+    return block.size() * sizeof(T);
   }
 
   /*!
    * Returns a pointer to a dataBlock object of size \p len with no
-   * references. This is either from the store, or newly allocated
+   * references. This is either from the pool, or newly allocated
    *
    * Expects \p len >= 0
    */
   dataPtrType get(size_type len) {
     ASSERT3(len >= 0);
 
-    dataPtrType p;
-
-    auto& st = store()[len];
+    if (not useStore()) {
+      return std::make_shared<dataBlock>(len);
+    }
 
-    if (!st.empty()) {
-      p = st.back();
-      st.pop_back();
-    } else {
-      // Ensure that when we release the data block later we'll have
-      // enough space to put it in the store so that `release` can be
-      // noexcept
-      st.reserve(1);
-      p = std::make_shared<dataBlock>(len);
+    auto& cache = threadCache();
+    cache.collectReturned();
+
+    auto& blocks = cache.sizeClass(sizeClassIndex(len));
+    // Search from the most recently released, which is most likely
+    // to still be in cache
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+      if (fits(**it, len, 0)) {
+        dataPtrType block = std::move(*it);
+        *it = std::move(blocks.back());
+        blocks.pop_back();
+
+        cache.bytes_held.store(cache.bytes_held.load(std::memory_order_relaxed)
+                                   - blockBytes(*block, 0),
+                               std::memory_order_relaxed);
+        ThreadCache::add(cache.hits, 1);
+        reuse(*block, len, 0);
+        return block;
+      }
     }
 
-    return p;
+    ThreadCache::add(cache.misses, 1);
+    dataPtrType block(new dataBlock(allocationSize(len, 0)), PoolDeleter{&cache});
+    reuse(*block, len, 0);
+    return block;
   }
 
   /*!
    * Release an dataBlock object, reducing its reference count by one.
-   * If no more references, then put back into the store.
+   * If no more references, then put back into the pool.
    * It's important to pass a reference to the pointer, otherwise we get
    * a copy of the shared_ptr, which therefore increases the use count
    * and doesn't allow us to free the pass pointer directly
    *
-   * Note that this is noexcept only because we've ensure that both a)
-   * store()[<size>] already exists, and b) it has space for at least
-   * one data block. Of course, store() could throw -- in which case
-   * we're doomed anyway, so the only thing we can do is abort
+   * If the block can't be put back into the pool, for example because
+   * the pool is full or memory can't be allocated to store it, then
+   * it is freed
    */
   void release(dataPtrType& d) noexcept {
     if (!d) {
       return;
     }
 
-    // Reduce reference count, and if zero return to store
-    if (d.use_count() == 1) {
-      if (useStore()) {
-        // Put back into store
-        store()[d->size()].push_back(std::move(d));
-        // Could return here but seems to slow things down a lot
+    // Reduce reference count, and if zero return to the pool. Memory
+    // that we don't own (views) must not be reused
+    if (d.use_count() == 1 and ownsData(*d) and useStore()) {
+      auto* deleter = std::get_deleter<PoolDeleter>(d);
+      if (deleter != nullptr) {
+        auto* owner = deleter->owner;
+        const std::size_t bytes = blockBytes(*d, 0);
+        if (owner->bytes_held.load(std::memory_order_relaxed) + bytes > pool().limit) {
+          // May be another thread's cache, so needs an atomic increment
+          ++owner->discarded;
+        } else if (owner == cacheHandle().cache) {
+          try {
+            owner->store(std::move(d));
+          } catch (...) {
+            // Couldn't store, so free the block below
+          }
+        } else {
+          // Return to the thread which allocated the block
+          auto& returned = owner->returned;
+          deleter->self = std::move(d);
+          deleter->next = returned.load(std::memory_order_relaxed);
+          while (not returned.compare_exchange_weak(deleter->next, deleter,
+                                                    std::memory_order_release,
+                                                    std::memory_order_relaxed)) {
+          }
+        }
       }
     }
 
-    // Finish by setting pointer to nullptr if not putting on store
+    // Finish by setting pointer to nullptr if not putting in the pool
     d = nullptr;
   }
+
+  /// Does \p block own its memory? Backings other than `ArrayData`
+  /// always do
+  template <typename B>
+  static auto ownsData(const B& block, int) -> decltype(block.ownsData()) {
+    return block.ownsData();
+  }
+  template <typename B>
+  static bool ownsData(const B&, long) {
+    return true;
+  }
+  static bool ownsData(const dataBlock& block) { return ownsData(block, 0); }
 };
 
 /*!
@@ -189,6 +189,9 @@ private:
   bool stop_check;
   /// Filename for `stop_check`
   std::string stop_check_name;
+  /// Write load imbalance between processors to the output
+  bool imbalance_report;
+  TimerImbalance imbalance;
 };
 
 /*!
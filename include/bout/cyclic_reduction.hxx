@@ -117,6 +117,10 @@ public:
   ///                where N is set in the constructor or setup
   /// @param[in] b   Diagonal values. Should have size [nsys][N]
   /// @param[in] c   Right diagonal. Should have size [nsys][N]
+  ///
+  /// The local part of the matrix is factorised here, so that
+  /// repeated calls to `solve` with the same coefficients only need
+  /// to eliminate and back-substitute the right hand side
   void setCoefs(const Matrix<T>& a, const Matrix<T>& b, const Matrix<T>& c) {
     TRACE("CyclicReduce::setCoefs");
 
@@ -135,6 +139,8 @@ public:
         // 4*i + 3 will contain RHS
       }
     }
+
+    factorise(Nsys, N, coefs, myif);
   }
 
   /// Solve a set of tridiagonal systems
@@ -192,8 +198,9 @@ public:
     }
 
     ///////////////////////////////////////
-    // Reduce local part of the matrix to interface equations
-    reduce(Nsys, N, coefs, myif);
+    // Reduce local part of the RHS to interface equations. The
+    // matrix part of myif was calculated in setCoefs
+    reduce_rhs(Nsys, N, coefs, myif);
 
     ///////////////////////////////////////
     // Gather all interface equations onto single processor
@@ -443,7 +450,7 @@ public:
 
     ///////////////////////////////////////
     // Solve local equations
-    back_solve(Nsys, N, coefs, x1, xn, x);
+    back_solve_factorised(Nsys, N, coefs, x1, xn, x);
     delete[] req;
   }
 
@@ -468,6 +475,10 @@ private:
   Array<T> ifp;         ///< Interface equations returned to processor p
   Array<T> x1, xn;      ///< Interface solutions for back-solving
 
+  /// Multipliers used to eliminate the local RHS, [Nsys, {beta,alpha}*N]
+  Matrix<T> multipliers;
+  Matrix<T> gam, bet; ///< Thomas algorithm factors for local back-solve [Nsys, N]
+
   /// Allocate memory arrays
   /// @param[in] np   Number of processors
   /// @param[in] nsys  Number of independent systems to solve
@@ -520,6 +531,10 @@ private:
 
     x1.reallocate(Nsys);
     xn.reallocate(Nsys);
+
+    multipliers.reallocate(Nsys, 2 * N);
+    gam.reallocate(Nsys, N);
+    bet.reallocate(Nsys, N);
   }
 
   /// Calculate interface equations
@@ -609,6 +624,106 @@ private:
     // Upper system couples {-1. 0, N-1}
   }
 
+  /// Calculate the matrix part of the interface equations
+  ///
+  /// This does the same elimination as `reduce` for the coefficients
+  /// only, storing the multipliers so that `reduce_rhs` can later
+  /// apply them to any RHS. The Thomas algorithm factors used in
+  /// `back_solve_factorised` are also calculated
+  void factorise(int ns, int nloc, const Matrix<T>& co, Matrix<T>& ifc) {
+#ifdef DIAGNOSE
+    if (nloc < 2) {
+      throw BoutException("CyclicReduce::factorise nloc < 2");
+    }
+#endif
+
+    BOUT_OMP(parallel for)
+    for (int j = 0; j < ns; j++) {
+      // Upper interface equation
+      for (int i = 0; i < 3; i++) {
+        ifc(j, i) = co(j, 4 * (nloc - 2) + i);
+      }
+
+      for (int i = nloc - 3; i >= 0; i--) {
+        if (std::abs(ifc(j, 1)) < 1e-10) {
+          throw BoutException("Zero pivot in CyclicReduce::factorise");
+        }
+
+        T beta = co(j, 4 * i + 2) / ifc(j, 1);
+        multipliers(j, i) = beta;
+
+        ifc(j, 1) = co(j, 4 * i + 1) - beta * ifc(j, 0);
+        ifc(j, 0) = co(j, 4 * i);
+        ifc(j, 2) *= -beta;
+      }
+
+      // Lower interface equation
+      for (int i = 0; i < 3; i++) {
+        ifc(j, 4 + i) = co(j, 4 + i);
+      }
+
+      for (int i = 2; i < nloc; i++) {
+        if (std::abs(ifc(j, 4 + 1)) < 1e-10) {
+          throw BoutException("Zero pivot in CyclicReduce::factorise");
+        }
+
+        T alpha = co(j, 4 * i) / ifc(j, 4 + 1);
+        multipliers(j, nloc + i) = alpha;
+
+        ifc(j, 4 + 0) *= -alpha;
+        ifc(j, 4 + 1) = co(j, 4 * i + 1) - alpha * ifc(j, 4 + 2);
+        ifc(j, 4 + 2) = co(j, 4 * i + 2);
+      }
+
+      // Factors for the back-solve between the interface values
+      gam(j, 1) = 0.;
+      for (int i = 1; i < nloc - 1; i++) {
+        bet(j, i) = co(j, 4 * i + 1) - co(j, 4 * i) * gam(j, i);
+        gam(j, i + 1) = co(j, 4 * i + 2) / bet(j, i);
+      }
+    }
+  }
+
+  /// Calculate the RHS of the interface equations, using the
+  /// multipliers from `factorise`
+  void reduce_rhs(int ns, int nloc, const Matrix<T>& co, Matrix<T>& ifc) {
+    BOUT_OMP(parallel for)
+    for (int j = 0; j < ns; j++) {
+      T b_u = co(j, 4 * (nloc - 2) + 3);
+      for (int i = nloc - 3; i >= 0; i--) {
+        b_u = co(j, 4 * i + 3) - multipliers(j, i) * b_u;
+      }
+      ifc(j, 3) = b_u;
+
+      T b_l = co(j, 4 + 3);
+      for (int i = 2; i < nloc; i++) {
+        b_l = co(j, 4 * i + 3) - multipliers(j, nloc + i) * b_l;
+      }
+      ifc(j, 4 + 3) = b_l;
+    }
+  }
+
+  /// Back-solve from x at ends (x1, xn) to obtain remaining values,
+  /// using the factors from `factorise`
+  void back_solve_factorised(int ns, int nloc, const Matrix<T>& co, const Array<T>& x1,
+                             const Array<T>& xn, Matrix<T>& xa) {
+
+    xa.ensureUnique(); // Going to be modified, so call this outside parallel region
+
+    BOUT_OMP(parallel for)
+    for (int i = 0; i < ns; i++) { // Loop over systems
+      xa(i, 0) = x1[i];            // Already know the first
+      for (int j = 1; j < nloc - 1; j++) {
+        xa(i, j) = (co(i, 4 * j + 3) - co(i, 4 * j) * xa(i, j - 1)) / bet(i, j);
+      }
+      xa(i, nloc - 1) = xn[i]; // Know the last value
+
+      for (int j = nloc - 2; j > 0; j--) {
+        xa(i, j) = xa(i, j) - gam(i, j + 1) * xa(i, j + 1);
+      }
+    }
+  }
+
   /// Back-solve from x at ends (x1, xn) to obtain remaining values
   /// Coefficients ordered [ns, nloc*(a,b,c,r)]
   void back_solve(int ns, int nloc, const Matrix<T>& co, const Array<T>& x1,
@@ -399,6 +399,12 @@ struct DerivativeStore {
     }
   }
 
+  /// The method used for \p deriv in \p direction when DIFF_DEFAULT is requested
+  std::string getDefaultMethod(DERIV deriv, DIRECTION direction,
+                               STAGGER stagger = STAGGER::None) const {
+    return defaultMethods.at(getKey(direction, stagger, toString(deriv)));
+  }
+
   /// Provide a method to override/force a specific default method
   void forceDefaultMethod(std::string methodName, DERIV deriv, DIRECTION direction,
                           STAGGER stagger = STAGGER::None) {
@@ -1,10 +1,10 @@
 /**************************************************************************
  *
- * Operators, and support for template expressions
- * 
+ * Expression templates for Field3D and Field2D arithmetic
+ *
  * Originally based on article by Klaus Kreft & Angelika Langer
  * http://www.angelikalanger.com/Articles/Cuj/ExpressionTemplates/ExpressionTemplates.htm
- * 
+ *
  * Parts adapted from Blitz++ library
  *
  **************************************************************************/
@@ -12,197 +12,349 @@
 #ifndef __EXPR_H__
 #define __EXPR_H__
 
-#warning expr.hxx is deprecated. Do not use!
+#include "bout/field2d.hxx"
+#include "bout/field3d.hxx"
+#include "bout/mesh.hxx"
+#include "bout/region.hxx"
+
+#include <initializer_list>
+#include <type_traits>
+
+namespace bout {
+/// Lazy evaluation of arithmetic on fields
+///
+/// Each arithmetic operator on a Field3D allocates a new field and
+/// loops over it, so `a * b + c * d - e / f` makes five passes over
+/// memory, and allocates five fields. Wrapping any one of the operands
+/// in `lazy` instead builds an expression, which is only evaluated
+/// when it is converted to a field, in a single loop:
+///
+///     using bout::expr::lazy;
+///     Field3D result = lazy(a) * b + c * d - e / f;
+///
+/// Note that this follows the usual precedence rules, so `c * d` is
+/// still evaluated eagerly here. Each group of operators which doesn't
+/// contain a lazy operand is evaluated as normal, so either wrap an
+/// operand in each group, or start the expression with `lazy`:
+///
+///     Field3D result = lazy(a) * b + lazy(c) * d - lazy(e) / f;
+///
+/// Expressions can contain Field3D, Field2D and BoutReal operands, and
+/// the `+ - * /` operators and unary minus. If there are any Field3D
+/// operands then the result is a Field3D, otherwise a Field2D. Field2D
+/// operands are broadcast in z, so are loaded once for each z line.
+/// The metadata (location, directions, mesh) is taken from the first
+/// operand with the type of the result, and the other operands are
+/// checked for compatibility, as for the usual operators. All values
+/// are calculated in RGN_ALL.
+///
+/// Expressions refer to their operands, rather than copying them, so
+/// they should be evaluated in the same statement they are created
+/// in. In particular, do not store them in `auto` variables.
+namespace expr {
+
+/// Base class of all expressions, which can be converted to the result
+/// type `Derived::result_type`
+template <typename Derived>
+struct Expression {
+  const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+  /// Evaluate the expression
+  template <typename T, typename D = Derived,
+            typename = std::enable_if_t<std::is_same<T, typename D::result_type>::value>>
+  operator T() const;
+};
+
+template <typename T>
+using is_expression = std::is_base_of<Expression<T>, T>;
 
-#include <bout/field2d.hxx>
-#include <bout/field3d.hxx>
-#include <bout/mesh.hxx>
+/// A constant value
+struct Constant : public Expression<Constant> {
+  using result_type = void;
+  static constexpr bool is_3d = false;
+  static constexpr bool has_field = false;
 
-/// Literal class to capture BoutReal values in expressions
-class Literal {
-public:
-  /// Type of this expression
-  using type = Literal;
+  explicit Constant(BoutReal value) : value(value) {}
 
-  Literal(BoutReal v) : val(v) {}
-  ~Literal() {}
-  BoutReal operator()(int x, int y, int z) const { return val; }
+  BoutReal operator()(int, int) const { return value; }
+
+  template <typename F>
+  void forEachField(F&&) const {}
 
 private:
-  const BoutReal val;
+  BoutReal value;
 };
 
-class Field3DExpr {
-public:
-  using type = Field3D;
+/// A Field3D, read at the 3D index
+struct Field3DRef : public Expression<Field3DRef> {
+  using result_type = Field3D;
+  static constexpr bool is_3d = true;
+  static constexpr bool has_field = true;
+
+  explicit Field3DRef(const Field3D& field)
+      : field(field), data(field.isAllocated() ? &field(0, 0, 0) : nullptr) {}
 
-  Field3DExpr(const Field3D& f) : data(&f(0, 0, 0)) {}
-  const BoutReal& operator()(int x, int y, int z) const {
-    return data[(x * bout::globals::mesh->LocalNy + y) * bout::globals::mesh->LocalNz
-                + z];
+  BoutReal operator()(int, int ind3d) const { return data[ind3d]; }
+
+  template <typename F>
+  void forEachField(F&& function) const {
+    function(field);
   }
 
 private:
+  const Field3D& field;
   const BoutReal* data;
 };
 
-class Field2DExpr {
-public:
-  using type = Field2D;
+/// A Field2D, read at the 2D index
+struct Field2DRef : public Expression<Field2DRef> {
+  using result_type = Field2D;
+  static constexpr bool is_3d = false;
+  static constexpr bool has_field = true;
+
+  explicit Field2DRef(const Field2D& field)
+      : field(field), data(field.isAllocated() ? &field(0, 0) : nullptr) {}
 
-  Field2DExpr(const Field2D& f) : data(&f(0, 0)) {}
-  const BoutReal& operator()(int x, int y, int z) const {
-    return data[x * bout::globals::mesh->LocalNy + y];
+  BoutReal operator()(int ind2d, int) const { return data[ind2d]; }
+
+  template <typename F>
+  void forEachField(F&& function) const {
+    function(field);
   }
 
 private:
+  const Field2D& field;
   const BoutReal* data;
 };
 
-/// Expression traits, to convert doubles etc. to Literal
-
-template <class ExprT>
-struct exprTraits {
-  using expr_type = ExprT;
+namespace details {
+constexpr bool anyOf(std::initializer_list<bool> values) {
+  for (const bool value : values) {
+    if (value) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace details
+
+/// Result of an operation on expressions \p Args
+template <typename... Args>
+struct ResultOf {
+  static constexpr bool is_3d = details::anyOf({Args::is_3d...});
+  static constexpr bool has_field = details::anyOf({Args::has_field...});
+  using type = std::conditional_t<has_field, std::conditional_t<is_3d, Field3D, Field2D>,
+                                  void>;
 };
 
-template <>
-struct exprTraits<double> {
-  using expr_type = Literal;
+template <typename Lhs, typename Rhs, typename Op>
+struct Binary : public Expression<Binary<Lhs, Rhs, Op>> {
+  using result_type = typename ResultOf<Lhs, Rhs>::type;
+  static constexpr bool is_3d = ResultOf<Lhs, Rhs>::is_3d;
+  static constexpr bool has_field = ResultOf<Lhs, Rhs>::has_field;
+
+  Binary(Lhs lhs, Rhs rhs) : lhs(lhs), rhs(rhs) {}
+
+  BoutReal operator()(int ind2d, int ind3d) const {
+    return Op::apply(lhs(ind2d, ind3d), rhs(ind2d, ind3d));
+  }
+
+  template <typename F>
+  void forEachField(F&& function) const {
+    lhs.forEachField(function);
+    rhs.forEachField(function);
+  }
+
+private:
+  Lhs lhs;
+  Rhs rhs;
 };
 
-template <>
-struct exprTraits<float> {
-  using expr_type = Literal;
+template <typename Arg, typename Op>
+struct Unary : public Expression<Unary<Arg, Op>> {
+  using result_type = typename ResultOf<Arg>::type;
+  static constexpr bool is_3d = Arg::is_3d;
+  static constexpr bool has_field = Arg::has_field;
+
+  explicit Unary(Arg arg) : arg(arg) {}
+
+  BoutReal operator()(int ind2d, int ind3d) const {
+    return Op::apply(arg(ind2d, ind3d));
+  }
+
+  template <typename F>
+  void forEachField(F&& function) const {
+    arg.forEachField(function);
+  }
+
+private:
+  Arg arg;
 };
 
-template <>
-struct exprTraits<int> {
-  using expr_type = Literal;
+struct Add {
+  static BoutReal apply(BoutReal a, BoutReal b) { return a + b; }
+};
+struct Subtract {
+  static BoutReal apply(BoutReal a, BoutReal b) { return a - b; }
+};
+struct Multiply {
+  static BoutReal apply(BoutReal a, BoutReal b) { return a * b; }
+};
+struct Divide {
+  static BoutReal apply(BoutReal a, BoutReal b) { return a / b; }
+};
+struct Negate {
+  static BoutReal apply(BoutReal a) { return -a; }
 };
 
-///////////////////////////////////////////////
-// asExpr: convert objects to expressions
+/// Converts operands to expressions
+template <typename T, typename Enable = void>
+struct AsExpression {};
 
 template <typename T>
-struct asExpr {
+struct AsExpression<T, std::enable_if_t<is_expression<T>::value>> {
   using type = T;
-  static const T& getExpr(const T& x) { return x; }
-};
-
-template <>
-struct asExpr<int> {
-  using type = Literal;
-  static const Literal getExpr(const int& x) { return Literal(x); }
+  static const T& get(const T& expression) { return expression; }
 };
 
 template <>
-struct asExpr<double> {
-  using type = Literal;
-  static const Literal getExpr(const double& x) { return Literal(x); }
+struct AsExpression<Field3D> {
+  using type = Field3DRef;
+  static type get(const Field3D& field) { return type{field}; }
 };
 
 template <>
-struct asExpr<float> {
-  using type = Literal;
-  static const Literal getExpr(const float& x) { return Literal(x); }
+struct AsExpression<Field2D> {
+  using type = Field2DRef;
+  static type get(const Field2D& field) { return type{field}; }
 };
 
-template <>
-struct asExpr<Field3D> {
-  using type = Field3DExpr;
-  static const Field3DExpr getExpr(const Field3D& x) { return Field3DExpr(x); }
+template <typename T>
+struct AsExpression<T, std::enable_if_t<std::is_arithmetic<T>::value>> {
+  using type = Constant;
+  static type get(T value) { return type{static_cast<BoutReal>(value)}; }
 };
 
-/////////////////////////////////////////////////////////////
-// Type promotion. Work out the type of a calculation,
-// based on the type of the arguments
+template <typename T>
+using expression_t = typename AsExpression<std::decay_t<T>>::type;
+
+/// Start a lazy expression with \p field
+inline Field3DRef lazy(const Field3D& field) { return Field3DRef{field}; }
+inline Field2DRef lazy(const Field2D& field) { return Field2DRef{field}; }
+
+/// Operators are only defined if at least one operand is already an
+/// expression, so that they don't replace the usual field operators
+template <typename Lhs, typename Rhs, typename Op>
+using BinaryResult = std::enable_if_t<
+    is_expression<std::decay_t<Lhs>>::value or is_expression<std::decay_t<Rhs>>::value,
+    Binary<expression_t<Lhs>, expression_t<Rhs>, Op>>;
+
+template <typename Lhs, typename Rhs>
+BinaryResult<Lhs, Rhs, Add> operator+(const Lhs& lhs, const Rhs& rhs) {
+  return {AsExpression<Lhs>::get(lhs), AsExpression<Rhs>::get(rhs)};
+}
 
-template <typename Lhs, typename Rhs> // If in doubt, convert to Field3D
-struct PromoteType {
-  using type = Field3D;
-};
+template <typename Lhs, typename Rhs>
+BinaryResult<Lhs, Rhs, Subtract> operator-(const Lhs& lhs, const Rhs& rhs) {
+  return {AsExpression<Lhs>::get(lhs), AsExpression<Rhs>::get(rhs)};
+}
 
-/////////////////////////////////////////////////////////////
-// Binary expressions
+template <typename Lhs, typename Rhs>
+BinaryResult<Lhs, Rhs, Multiply> operator*(const Lhs& lhs, const Rhs& rhs) {
+  return {AsExpression<Lhs>::get(lhs), AsExpression<Rhs>::get(rhs)};
+}
 
-template <class ExprT1, class ExprT2, class BinOp>
-class BinaryExpr {
-public:
-  BinaryExpr(const ExprT1& e1, const ExprT2& e2) : _expr1(e1), _expr2(e2) {}
+template <typename Lhs, typename Rhs>
+BinaryResult<Lhs, Rhs, Divide> operator/(const Lhs& lhs, const Rhs& rhs) {
+  return {AsExpression<Lhs>::get(lhs), AsExpression<Rhs>::get(rhs)};
+}
 
-  // Work out the type of the inputs
-  using ltype = typename exprTraits<ExprT1>::expr_type;
-  using rtype = typename exprTraits<ExprT2>::expr_type;
+template <typename Arg>
+Unary<Arg, Negate> operator-(const Expression<Arg>& arg) {
+  return Unary<Arg, Negate>{arg.self()};
+}
 
-  /// Type of the resulting expression
-  using type = typename PromoteType<ltype, rtype>::type;
+namespace details {
+/// Finds the first field of type \p T
+template <typename T>
+struct FirstField {
+  const T* first{nullptr};
 
-  BoutReal operator()(int x, int y, int z) const {
-    return BinOp::apply((_expr1)(x, y, z), (_expr2)(x, y, z));
+  void operator()(const T& field) {
+    if (first == nullptr) {
+      first = &field;
+    }
   }
-
-private:
-  ltype const _expr1;
-  rtype const _expr2;
+  template <typename Other>
+  void operator()(const Other&) {}
 };
 
-template <typename ExprT1, typename ExprT2, class name>
-struct BinaryResult {
-  using arg1 = typename asExpr<ExprT1>::type;
-  using arg2 = typename asExpr<ExprT2>::type;
-  using type = BinaryExpr<arg1, arg2, name>;
+/// Checks that fields have data, and are compatible with \p T
+template <typename T>
+struct CheckField {
+  const T& first;
+
+  template <typename Other>
+  void operator()(const Other& field) const {
+    checkData(field);
+    ASSERT1_FIELDS_COMPATIBLE(first, field);
+  }
 };
+} // namespace details
+
+/// Evaluate \p expression in a single loop. Implicit conversion of an
+/// expression to a field calls this
+template <typename E>
+Field3D evaluate(const Expression<E>& expression,
+                 std::enable_if_t<E::is_3d>* = nullptr) {
+  const E& expr = expression.self();
+
+  details::FirstField<Field3D> first;
+  expr.forEachField(first);
+  expr.forEachField(details::CheckField<Field3D>{*first.first});
+
+  Field3D result{emptyFrom(*first.first)};
+  Mesh* localmesh = result.getMesh();
+  BoutReal* data = &result(0, 0, 0);
+
+  BOUT_FOR(index, localmesh->getRegion2D("RGN_ALL")) {
+    const int base_ind = localmesh->ind2Dto3D(index).ind;
+    for (int jz = 0; jz < localmesh->LocalNz; ++jz) {
+      data[base_ind + jz] = expr(index.ind, base_ind + jz);
+    }
+  }
 
-/// Binary operator classes
+  checkData(result);
+  return result;
+}
 
-#define DEFINE_BINARY_OP(name, op)    \
-  struct name {                       \
-    template <typename T>             \
-    static inline T apply(T a, T b) { \
-      return a op b;                  \
-    }                                 \
-  };
+template <typename E>
+Field2D evaluate(const Expression<E>& expression,
+                 std::enable_if_t<E::has_field and not E::is_3d>* = nullptr) {
+  const E& expr = expression.self();
 
-DEFINE_BINARY_OP(Add, +)
-DEFINE_BINARY_OP(Subtract, -)
-DEFINE_BINARY_OP(Multiply, *)
-DEFINE_BINARY_OP(Divide, /)
+  details::FirstField<Field2D> first;
+  expr.forEachField(first);
+  expr.forEachField(details::CheckField<Field2D>{*first.first});
 
-struct Power {
-  template <typename T>
-  static inline T apply(T a, T b) {
-    return pow(a, b);
-  }
-};
+  Field2D result{emptyFrom(*first.first)};
+  BoutReal* data = &result(0, 0);
 
-/// Define functions add, mul which use operator structs
-#define DEFINE_OVERLOAD_FUNC(name, func)                                     \
-  template <typename ExprT1, typename ExprT2>                                \
-  typename BinaryResult<ExprT1, ExprT2, name>::type func(const ExprT1& e1,   \
-                                                         const ExprT2& e2) { \
-    using type = typename BinaryResult<ExprT1, ExprT2, name>::type;          \
-    return type(asExpr<ExprT1>::getExpr(e1), asExpr<ExprT2>::getExpr(e2));   \
+  BOUT_FOR(index, result.getRegion("RGN_ALL")) {
+    data[index.ind] = expr(index.ind, index.ind);
   }
 
-/// Addition of two Expressions
-DEFINE_OVERLOAD_FUNC(Add, add);
-/// Multiplication of two Expressions
-DEFINE_OVERLOAD_FUNC(Multiply, mul);
-
-/// A function to evaluate expressions
-template <typename Expr>
-const Field3D eval3D(Expr e) {
-  Field3D result;
-  result.allocate();
-  for (int i = 0; i < bout::globals::mesh->LocalNx; i++) {
-    for (int j = 0; j < bout::globals::mesh->LocalNy; j++) {
-      for (int k = 0; k < bout::globals::mesh->LocalNz; k++) {
-        result(i, j, k) = e(i, j, k);
-      }
-    }
-  }
+  checkData(result);
   return result;
 }
 
+template <typename Derived>
+template <typename T, typename D, typename>
+Expression<Derived>::operator T() const {
+  return evaluate(*this);
+}
+
+} // namespace expr
+} // namespace bout
+
 #endif // __EXPR_H__
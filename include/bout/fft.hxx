@@ -73,6 +73,45 @@ void rfft(const BoutReal* in, int length, dcomplex* out);
  */
 void irfft(const dcomplex* in, int length, BoutReal* out);
 
+/*!
+ * Batched version of `rfft`: transform \p howmany real signals, each
+ * of \p length points, in a single call
+ *
+ * Signal `i` is read from `in + i * in_dist` and its (normalised)
+ * transform of `length / 2 + 1` modes is written to `out + i * out_dist`.
+ * For example, all the Z pencils of a Field3D `f` can be transformed
+ * with `rfft_many(&f(0, 0, 0), nz, nx * ny, nz, out, nz / 2 + 1)`.
+ *
+ * This uses FFTW's advanced ("many") interface, with plans cached for
+ * each combination of (\p length, \p howmany, \p in_dist, \p out_dist)
+ *
+ * \param[in] in       Pointer to the first real signal
+ * \param[in] length   Number of points in each signal
+ * \param[in] howmany  Number of signals
+ * \param[in] in_dist  Distance between the start of consecutive signals
+ * \param[out] out     Pointer to the first complex output
+ * \param[in] out_dist Distance between the start of consecutive outputs
+ */
+void rfft_many(const BoutReal* in, int length, int howmany, int in_dist, dcomplex* out,
+               int out_dist);
+
+/*!
+ * Batched version of `irfft`: inverse transform \p howmany signals of
+ * `length / 2 + 1` modes, each producing \p length real points
+ *
+ * Signal `i` is read from `in + i * in_dist` and written to
+ * `out + i * out_dist`. See `rfft_many` for details
+ *
+ * \param[in] in       Pointer to the first complex signal
+ * \param[in] length   Number of points in each real output
+ * \param[in] howmany  Number of signals
+ * \param[in] in_dist  Distance between the start of consecutive inputs
+ * \param[out] out     Pointer to the first real output
+ * \param[in] out_dist Distance between the start of consecutive outputs
+ */
+void irfft_many(const dcomplex* in, int length, int howmany, int in_dist, BoutReal* out,
+                int out_dist);
+
 /*!
  * Discrete Sine Transform
  *
@@ -97,6 +136,24 @@ void fft_init(FFT_MEASUREMENT_FLAG fft_flag);
 /// "fftw_measure". If it is nullptr, use the global `Options` root
 void fft_init(Options* options = nullptr);
 
+/// Load FFTW wisdom from the file given by the "fftw_wisdom_file"
+/// option, so that plans found in previous runs don't need to be
+/// measured again. The file is read on rank 0 of `BoutComm` and
+/// broadcast to all ranks, so this must be called collectively.
+///
+/// If \p options is nullptr, use the "fft" section of the global
+/// `Options` root. Does nothing if "fftw_wisdom_file" is empty
+void fft_import_wisdom(Options* options = nullptr);
+/// Gather the FFTW wisdom accumulated on all ranks, and write it to the
+/// file given to `fft_import_wisdom` on rank 0. Must be called
+/// collectively, before MPI is finalised. Does nothing if
+/// `fft_import_wisdom` was not called with a wisdom file
+void fft_export_wisdom();
+
+/// Destroy all the cached FFTW plans and free FFTW's internal
+/// memory. Called by `BoutFinalise`, after `fft_export_wisdom`
+void fft_cleanup();
+
 /// Returns the fft of a real signal \p in using fftw_forward
 Array<dcomplex> rfft(const Array<BoutReal>& in);
 
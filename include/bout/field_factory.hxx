@@ -42,6 +42,8 @@ class FieldFactory;
 #include <list>
 #include <map>
 #include <string>
+#include <tuple>
+#include <vector>
 
 // Utility routines to create generators from values
 
@@ -128,6 +130,42 @@ private:
   /// don't result in allocating more generators.
   mutable std::map<std::string, FieldGeneratorPtr> cache;
 
+  /// Time-independent parts of a compiled expression
+  struct HoistedValues {
+    int nx{0}, ny{0}, nz{0};
+    /// When these values were last used, for evicting the oldest
+    std::size_t last_used{0};
+    /// Program::numHoisted() lines of nz values for each (x, y)
+    std::vector<BoutReal> values;
+  };
+
+  /// Hoisted values are specific to the expression, the mesh and the
+  /// cell location. The key keeps the generator alive, so its address
+  /// isn't reused
+  using HoistedKey = std::tuple<FieldGeneratorPtr, Mesh*, CELL_LOC>;
+
+  /// Hoisted values of time-dependent expressions passed to create3D
+  mutable std::map<HoistedKey, HoistedValues> hoisted_cache;
+
+  /// Maximum number of values stored in hoisted_cache, over all entries
+  std::size_t max_hoisted_cache_size{0};
+
+  /// Number of values currently stored in hoisted_cache
+  mutable std::size_t hoisted_cache_size{0};
+
+  /// Counts calls to hoistedValues, to order the cache entries by use
+  mutable std::size_t hoisted_cache_uses{0};
+
+  /// Get the hoisted values of \p program, compiled from \p gen, on
+  /// \p localmesh at \p loc. These are evaluated on first use, and
+  /// the least recently used values are removed to keep the cache
+  /// within `max_hoisted_cache_size`. Returns nullptr if the values
+  /// would not fit in the cache at all
+  const BoutReal* hoistedValues(const FieldGeneratorPtr& gen,
+                                const bout::generator::Program& program,
+                                const std::vector<BoutReal>& z, Mesh* localmesh,
+                                CELL_LOC loc) const;
+
   /// Find an Options object which contains the given \p name
   const Options* findOption(const Options* opt, const std::string& name,
                             std::string& val) const;
@@ -155,6 +193,10 @@ class FieldNull : public FieldGenerator {
 public:
   FieldNull() = default;
   BoutReal generate(const bout::generator::Context&) override { return 0.0; }
+  bout::generator::Program::Register
+  compile(bout::generator::Program& program) const override {
+    return program.constant(0.0);
+  }
   FieldGeneratorPtr clone(const std::list<FieldGeneratorPtr> UNUSED(args)) override {
     return get();
   }
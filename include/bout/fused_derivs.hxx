@@ -0,0 +1,117 @@
+/*!************************************************************************
+ * \file fused_derivs.hxx
+ *
+ * Several X-Z derivatives of one or more fields, calculated together
+ * in a single sweep over the mesh.
+ *
+ **************************************************************************/
+
+#ifndef BOUT_FUSED_DERIVS_H
+#define BOUT_FUSED_DERIVS_H
+
+#include "bout/field3d.hxx"
+
+#include <string>
+#include <vector>
+
+namespace bout {
+namespace derivatives {
+
+/// Calculates several X-Z derivatives of one or more fields in a
+/// single sweep over the mesh
+///
+/// Each operator like `DDX` or `bracket` makes a separate pass over
+/// its inputs, so a right hand side which needs several derivatives
+/// of the same fields reads them from memory several times. Here the
+/// outputs are requested first, and then calculated together by
+/// `run`, one (x, y) column at a time: while the z lines at x-1, x
+/// and x+1 are in cache, every requested output which uses them is
+/// calculated.
+///
+///     Field3D n_adv, vort_adv, dphidz;
+///     PerpDerivatives()
+///         .bracket(phi, n, n_adv)       // bracket(phi, n, BRACKET_ARAKAWA)
+///         .bracket(phi, vort, vort_adv) // bracket(phi, vort, BRACKET_ARAKAWA)
+///         .DDZ(phi, dphidz)
+///         .run();
+///
+/// All derivatives use 2nd order central differences (the "C2"
+/// method), whatever methods are set in the input options, so are
+/// only the same as the usual operators (to rounding error) when
+/// those use C2. Check `defaultMethodsAreC2` to decide whether they
+/// can replace the usual operators. `Delp2` is the finite difference form of
+/// `Coordinates::Delp2`, rather than the default FFT method. All
+/// fields must be on the same mesh and at the same location, and the
+/// outputs must not be inputs. The inputs are not copied, so must
+/// still exist when `run` is called. The outputs are calculated in a
+/// 2D region (with all z points) which must not include x guard
+/// cells, by default RGN_NOBNDRY, and are not set outside it.
+class PerpDerivatives {
+public:
+  explicit PerpDerivatives(std::string region = "RGN_NOBNDRY")
+      : region(std::move(region)) {}
+
+  /// \f$\partial f / \partial x\f$
+  PerpDerivatives& DDX(const Field3D& f, Field3D& result) {
+    return add(Kind::DDX, f, f, result);
+  }
+  /// \f$\partial f / \partial z\f$
+  PerpDerivatives& DDZ(const Field3D& f, Field3D& result) {
+    return add(Kind::DDZ, f, f, result);
+  }
+  /// \f$\partial^2 f / \partial x^2\f$, including the correction
+  /// for non-uniform meshes
+  PerpDerivatives& D2DX2(const Field3D& f, Field3D& result) {
+    return add(Kind::D2DX2, f, f, result);
+  }
+  /// \f$\partial^2 f / \partial z^2\f$
+  PerpDerivatives& D2DZ2(const Field3D& f, Field3D& result) {
+    return add(Kind::D2DZ2, f, f, result);
+  }
+  /// \f$\partial^2 f / \partial x \partial z\f$
+  PerpDerivatives& D2DXDZ(const Field3D& f, Field3D& result) {
+    return add(Kind::D2DXDZ, f, f, result);
+  }
+  /// Perpendicular Laplacian, `Delp2(f, CELL_DEFAULT, false)`
+  PerpDerivatives& Delp2(const Field3D& f, Field3D& result) {
+    return add(Kind::Delp2, f, f, result);
+  }
+  /// Arakawa Poisson bracket, `bracket(f, g, BRACKET_ARAKAWA)`
+  PerpDerivatives& bracket(const Field3D& f, const Field3D& g, Field3D& result) {
+    return add(Kind::bracket, f, g, result);
+  }
+
+  /// Calculate all the requested outputs. The requests are kept, so
+  /// this can be called again once the inputs change
+  void run();
+
+  /// Forget all the requested outputs
+  void clear() { outputs.clear(); }
+
+  /// True if the default first and second derivative methods in x and
+  /// z are C2, so the results are the same as the usual operators
+  static bool defaultMethodsAreC2();
+
+private:
+  enum class Kind { DDX, DDZ, D2DX2, D2DZ2, D2DXDZ, Delp2, bracket };
+
+  struct Output {
+    Kind kind;
+    const Field3D* f;
+    const Field3D* g;
+    Field3D* result;
+  };
+
+  PerpDerivatives& add(Kind kind, const Field3D& f, const Field3D& g, Field3D& result) {
+    outputs.push_back({kind, &f, &g, &result});
+    return *this;
+  }
+
+  std::string region;
+  std::vector<Output> outputs;
+};
+
+} // namespace derivatives
+} // namespace bout
+
+#endif // BOUT_FUSED_DERIVS_H
@@ -31,6 +31,7 @@ class GridDataSource;
 #include "mesh.hxx"
 #include "bout/bout_types.hxx"
 #include "bout/options.hxx"
+#include "bout/options_netcdf.hxx"
 
 #include <bout/field2d.hxx>
 #include <bout/field3d.hxx>
@@ -127,11 +128,19 @@ public:
   bool hasYBoundaryGuards() override { return grid_yguards > 0; }
 
 private:
+  /// The grid file. Fields are read from it when needed, and only the
+  /// part on this processor
+  bout::OptionsNetCDF file;
+  /// Variables with at most one dimension, and the attributes of
+  /// larger variables
   Options data;
   std::string filename;
   int grid_yguards{0};
   int ny_inner{0};
 
+  /// Global shape of variable \p name, or empty if it isn't in the file
+  std::vector<int> getShape(const std::string& name);
+
   bool readgrid_3dvar_fft(Mesh* m, const std::string& name, int yread, int ydest,
                           int ysize, int xread, int xdest, int xsize, Field3D& var);
 
@@ -102,15 +102,24 @@ protected:
   // The h00 and h01 basis functions are applied to the function itself
   // and the h10 and h11 basis functions are applied to its derivative
   // along the interpolation direction.
-
-  Field3D h00_x;
-  Field3D h01_x;
-  Field3D h10_x;
-  Field3D h11_x;
-  Field3D h00_z;
-  Field3D h01_z;
-  Field3D h10_z;
-  Field3D h11_z;
+  enum Weight : int { h00_x, h01_x, h10_x, h11_x, h00_z, h01_z, h10_z, h11_z, nweights };
+
+  /// Weights for each point, stored as one contiguous array per
+  /// basis function, indexed as `weights(h00_x, i.ind)`
+  Matrix<BoutReal> weights;
+
+  /// Flat index of the source points at (i_corner, y, k_corner) and
+  /// (i_corner, y, k_corner + 1), wrapping in z. The interpolation
+  /// adds `y_offset` to these, and the points at i_corner + 1 are one
+  /// x-stride further on. Precalculated so the interpolation only has
+  /// to read two indices per point
+  Array<int> corner_index, corner_index_zp1;
+
+  /// Calculate the derivatives of \p f used for the tension: \p fx
+  /// = df/dx, \p fz = df/dz and \p fxz = d2f/dxdz, on index
+  /// coordinates. The y-guard cells needed for interpolating into the
+  /// next y-slice are communicated in a single exchange
+  void calcDerivatives(const Field3D& f, Field3D& fx, Field3D& fz, Field3D& fxz) const;
 
 public:
   XZHermiteSpline(Mesh* mesh = nullptr) : XZHermiteSpline(0, mesh) {}
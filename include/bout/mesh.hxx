@@ -95,6 +95,43 @@ using RegisterMesh = MeshFactory::RegisterInFactory<DerivedType>;
 /// Type used to return pointers to handles
 using comm_handle = void*;
 
+/// A persistent plan for communicating the guard cells of a fixed
+/// group of fields, created by Mesh::createCommPlan
+///
+/// The work of setting up a communication is done once when the plan
+/// is created, so groups of fields which are communicated many times,
+/// for example in every RHS call, only pay for sending the data.
+///
+/// The fields in the group, and the mesh, must outlive the plan. The
+/// fields' data may be reallocated between communications.
+///
+/// Example
+/// -------
+///
+///     auto plan = mesh->createCommPlan(n, vort);
+///     ...
+///     plan->communicate();
+class CommPlan {
+public:
+  CommPlan(Mesh& mesh, FieldGroup group) : mesh(mesh), group(std::move(group)) {}
+  virtual ~CommPlan() = default;
+
+  /// Start communicating the guard cells. Must be followed by wait()
+  /// before the guard cells are used
+  virtual void start() = 0;
+
+  /// Wait for the communication started by start() to finish
+  virtual void wait() = 0;
+
+  /// Communicate the guard cells. Equivalent to Mesh::communicate on
+  /// the group of fields, including calculating parallel slices
+  void communicate();
+
+protected:
+  Mesh& mesh;
+  FieldGroup group;
+};
+
 class Mesh {
 public:
   /// Constructor for a "bare", uninitialised Mesh
@@ -346,6 +383,17 @@ public:
   /// Wait for the handle, return error code
   virtual int wait(comm_handle handle) = 0; ///< Wait for the handle, return error code
 
+  /// Create a persistent plan for communicating the guard cells of a
+  /// group of fields. See CommPlan
+  virtual std::unique_ptr<CommPlan> createCommPlan(FieldGroup& g);
+
+  /// Packs arguments into a FieldGroup and passes to createCommPlan(FieldGroup&)
+  template <typename... Ts>
+  std::unique_ptr<CommPlan> createCommPlan(Ts&... ts) {
+    FieldGroup g(ts...);
+    return createCommPlan(g);
+  }
+
   // non-local communications
 
   virtual int getNXPE() = 0;       ///< The number of processors in the X direction
@@ -768,6 +816,7 @@ protected:
 
   /// Set whether to call calcParallelSlices on all communicated fields (true) or not (false)
   bool calcParallelSlices_on_communicate{true};
+  friend class CommPlan;
 
   /// Read a 1D array of integers
   const std::vector<int> readInts(const std::string& name, int n);
@@ -6,7 +6,11 @@
 #include "bout/utils.hxx"
 
 #include <cmath>
+#include <map>
+#include <string>
+#include <vector>
 
+class Mesh;
 class Options;
 class Solver;
 
@@ -114,6 +118,14 @@ public:
    */
   void outputVars(Options& output_options) const;
 
+  /*!
+   * The maximum of each metric over all processors, with the derived
+   * metrics calculated from them. These are the same on every
+   * processor, so can be written to a file shared by all of them.
+   * Collective over `BoutComm`
+   */
+  RunMetrics maxOverProcessors() const;
+
   /*!
    * Calculates derived metrics
    */
@@ -125,4 +137,49 @@ public:
   void writeProgress(BoutReal simtime, bool output_split);
 };
 
+/// Load imbalance between processors, measured with the named `Timer`s
+///
+/// Each call to `gather` takes the time spent in each timer since the
+/// previous call, on every processor, and finds the minimum, mean and
+/// maximum over processors, and the rank of the slowest one. Timers
+/// which only exist on some processors count as zero time on the
+/// others. The size of the grid on each processor is gathered on the
+/// first call, so that the imbalance can be compared to the amount
+/// of work each processor has.
+///
+/// `gather` is collective over `BoutComm`
+struct TimerImbalance {
+public:
+  struct Stats {
+    BoutReal min = 0;
+    BoutReal mean = 0;
+    BoutReal max = 0;
+    /// Rank of the processor which took the longest
+    int max_rank = 0;
+  };
+
+  /// Statistics for each timer, for the last interval
+  std::map<std::string, Stats> timers;
+
+  /// Number of interior points on each processor, indexed by rank
+  std::vector<int> local_nx, local_ny, local_nz;
+  /// X and Y processor indices of each rank
+  std::vector<int> pe_xind, pe_yind;
+
+  /*!
+   * Collect the times since the last call from all processors
+   */
+  void gather(Mesh& mesh);
+
+  /*!
+   * Adds the statistics to the output file, in the section
+   * "timing_imbalance", with one subsection per timer
+   */
+  void outputVars(Options& output_options) const;
+
+private:
+  /// Total time in each timer on this processor at the last call
+  std::map<std::string, BoutReal> previous_total;
+};
+
 #endif // __MONITOR_H__
@@ -42,6 +42,20 @@ public:
     return ::MPI_Abort(comm, errorcode);
   }
 
+  virtual int MPI_Allgather(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
+                            void* recvbuf, int recvcount, MPI_Datatype recvtype,
+                            MPI_Comm comm) {
+    return ::MPI_Allgather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype,
+                           comm);
+  }
+
+  virtual int MPI_Allgatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
+                             void* recvbuf, const int* recvcounts, const int* displs,
+                             MPI_Datatype recvtype, MPI_Comm comm) {
+    return ::MPI_Allgatherv(sendbuf, sendcount, sendtype, recvbuf, recvcounts, displs,
+                            recvtype, comm);
+  }
+
   virtual int MPI_Allreduce(const void* sendbuf, void* recvbuf, int count,
                             MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
     return ::MPI_Allreduce(sendbuf, recvbuf, count, datatype, op, comm);
@@ -49,6 +63,11 @@ public:
 
   virtual int MPI_Barrier(MPI_Comm comm) { return ::MPI_Barrier(comm); }
 
+  virtual int MPI_Bcast(void* buffer, int count, MPI_Datatype datatype, int root,
+                        MPI_Comm comm) {
+    return ::MPI_Bcast(buffer, count, datatype, root, comm);
+  }
+
   virtual int MPI_Comm_create(MPI_Comm comm, MPI_Group group, MPI_Comm* newcomm) {
     return ::MPI_Comm_create(comm, group, newcomm);
   }
@@ -80,6 +99,13 @@ public:
     return ::MPI_Comm_split(comm, color, key, newcomm);
   }
 
+  virtual int MPI_Gather(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
+                         void* recvbuf, int recvcount, MPI_Datatype recvtype, int root,
+                         MPI_Comm comm) {
+    return ::MPI_Gather(sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root,
+                        comm);
+  }
+
   virtual int MPI_Gatherv(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
                           void* recvbuf, const int* recvcounts, const int* displs,
                           MPI_Datatype recvtype, int root, MPI_Comm comm) {
@@ -93,6 +119,14 @@ public:
 
   virtual int MPI_Group_free(MPI_Group* group) { return ::MPI_Group_free(group); }
 
+  virtual int MPI_Info_create(MPI_Info* info) { return ::MPI_Info_create(info); }
+
+  virtual int MPI_Info_free(MPI_Info* info) { return ::MPI_Info_free(info); }
+
+  virtual int MPI_Info_set(MPI_Info info, const char* key, const char* value) {
+    return ::MPI_Info_set(info, key, value);
+  }
+
   virtual int MPI_Irecv(void* buf, int count, MPI_Datatype datatype, int source, int tag,
                         MPI_Comm comm, MPI_Request* request) {
     return ::MPI_Irecv(buf, count, datatype, source, tag, comm, request);
@@ -108,6 +142,15 @@ public:
     return ::MPI_Recv(buf, count, datatype, source, tag, comm, status);
   }
 
+  virtual int MPI_Recv_init(void* buf, int count, MPI_Datatype datatype, int source,
+                            int tag, MPI_Comm comm, MPI_Request* request) {
+    return ::MPI_Recv_init(buf, count, datatype, source, tag, comm, request);
+  }
+
+  virtual int MPI_Request_free(MPI_Request* request) {
+    return ::MPI_Request_free(request);
+  }
+
   virtual int MPI_Scan(const void* sendbuf, void* recvbuf, int count,
                        MPI_Datatype datatype, MPI_Op op, MPI_Comm comm) {
     return ::MPI_Scan(sendbuf, recvbuf, count, datatype, op, comm);
@@ -125,6 +168,15 @@ public:
     return ::MPI_Send(buf, count, datatype, dest, tag, comm);
   }
 
+  virtual int MPI_Send_init(const void* buf, int count, MPI_Datatype datatype, int dest,
+                            int tag, MPI_Comm comm, MPI_Request* request) {
+    return ::MPI_Send_init(buf, count, datatype, dest, tag, comm, request);
+  }
+
+  virtual int MPI_Startall(int count, MPI_Request array_of_requests[]) {
+    return ::MPI_Startall(count, array_of_requests);
+  }
+
   virtual int MPI_Type_commit(MPI_Datatype* datatype) {
     return ::MPI_Type_commit(datatype);
   }
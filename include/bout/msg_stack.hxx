@@ -39,6 +39,7 @@ class MsgStack;
 #include <cstdarg>
 #include <exception>
 #include <string>
+#include <thread>
 #include <vector>
 
 /// The __PRETTY_FUNCTION__ variable is defined by GCC (and some other families) but is
@@ -64,6 +65,11 @@ class MsgStack;
  * This code is only enabled if CHECK > 1. If CHECK is disabled then this
  * message stack code reverts to empty functions which should be removed by
  * the optimiser
+ *
+ * Only the thread which created the stack (the main thread, for the
+ * global msg_stack) adds messages. Messages from other threads, such as
+ * those in a bout::ThreadPool, are ignored, as they are in OpenMP
+ * regions with more than one thread
  */
 class MsgStack {
 public:
@@ -105,6 +111,11 @@ public:
 private:
   std::vector<std::string> stack;                  ///< Message stack;
   std::vector<std::string>::size_type position{0}; ///< Position in stack
+  std::thread::id owner{std::this_thread::get_id()}; ///< Thread which adds messages
+
+  /// Is the calling thread one which doesn't own the stack, outside an
+  /// OpenMP region?
+  bool otherThread() const;
 };
 
 /*!
@@ -6,35 +6,60 @@
 
 #include "bout/build_config.hxx"
 
-#if !BOUT_HAS_NETCDF || BOUT_HAS_LEGACY_NETCDF
-
+#include <map>
 #include <string>
 
+#if !BOUT_HAS_NETCDF || BOUT_HAS_LEGACY_NETCDF
+
 #include "bout/boutexception.hxx"
 #include "bout/options.hxx"
+#include "bout/unused.hxx"
+
+#include <vector>
 
 namespace bout {
 
 class OptionsNetCDF {
 public:
+  /// How the file is opened by the first write. If it's closed, for
+  /// example by `readShape`, later writes carry on in the same file
   enum class FileMode {
     replace, ///< Overwrite file when writing
     append   ///< Append to file when writing
   };
 
-  OptionsNetCDF(const std::string& filename, FileMode mode = FileMode::replace) {}
+  OptionsNetCDF() {}
+  OptionsNetCDF(const std::string& UNUSED(filename),
+                FileMode UNUSED(mode) = FileMode::replace, int UNUSED(async_queue) = 0) {}
   OptionsNetCDF(const OptionsNetCDF&) = default;
   OptionsNetCDF(OptionsNetCDF&&) = default;
   OptionsNetCDF& operator=(const OptionsNetCDF&) = default;
   OptionsNetCDF& operator=(OptionsNetCDF&&) = default;
 
   /// Read options from file
-  Options read() { throw BoutException("OptionsNetCDF not available\n"); }
+  Options read(int UNUSED(max_dims) = 3) {
+    throw BoutException("OptionsNetCDF not available\n");
+  }
+  std::vector<int> readShape(const std::string& UNUSED(name)) {
+    throw BoutException("OptionsNetCDF not available\n");
+  }
+  Options readHyperslab(const std::string& UNUSED(name),
+                        const std::vector<int>& UNUSED(start),
+                        const std::vector<int>& UNUSED(count)) {
+    throw BoutException("OptionsNetCDF not available\n");
+  }
 
   /// Write options to file
-  void write(const Options& options) {
+  void write(const Options& UNUSED(options)) {
     throw BoutException("OptionsNetCDF not available\n");
   }
+  void write(const Options& UNUSED(options), const std::string& UNUSED(time_dim)) {
+    throw BoutException("OptionsNetCDF not available\n");
+  }
+  void verifyTimesteps() const {}
+  void flush() {}
+  void setDefaultAttributes(
+      std::map<std::string, Options::AttributeType> UNUSED(attributes)) {}
 };
 
 } // namespace bout
@@ -42,7 +67,8 @@ public:
 #else
 
 #include <memory>
-#include <string>
+#include <mpi.h>
+#include <vector>
 
 #include "bout/options.hxx"
 
@@ -54,6 +80,20 @@ class NcFile;
 
 namespace bout {
 
+namespace details {
+struct NcSchema;
+}
+
+/// Processors which write one file together, rather than one file
+/// each, and how they write it
+struct SharedFile {
+  /// All the processors which write the file
+  MPI_Comm comm{MPI_COMM_NULL};
+  /// MPI-IO hints, for example "cb_nodes" or "cb_buffer_size" to tune
+  /// collective buffering
+  std::map<std::string, std::string> hints{};
+};
+
 class OptionsNetCDF {
 public:
   enum class FileMode {
@@ -64,32 +104,128 @@ public:
   // Constructors need to be defined in implementation due to forward
   // declaration of NcFile
   OptionsNetCDF();
-  explicit OptionsNetCDF(std::string filename, FileMode mode = FileMode::replace);
+  /// If \p async_queue is greater than zero, the file is written by a
+  /// separate thread, so that `write` only has to copy the data. Up to
+  /// \p async_queue writes can wait for the thread, after which
+  /// `write` waits until there is space. The NetCDF library isn't
+  /// thread-safe, so calls to it from all files and threads take turns
+  explicit OptionsNetCDF(std::string filename, FileMode mode = FileMode::replace,
+                         int async_queue = 0);
+  /// Write one file from all the processors in \p shared, using
+  /// parallel NetCDF-4. Fields are written as global arrays: each
+  /// processor writes its part, without guard cells or Y boundary
+  /// cells, but with X boundary cells. Other values should be the same
+  /// on all processors. Needs NetCDF built with parallel I/O
+  OptionsNetCDF(std::string filename, SharedFile shared,
+                FileMode mode = FileMode::replace);
   ~OptionsNetCDF();
   OptionsNetCDF(const OptionsNetCDF&) = delete;
   OptionsNetCDF(OptionsNetCDF&&) noexcept;
   OptionsNetCDF& operator=(const OptionsNetCDF&) = delete;
   OptionsNetCDF& operator=(OptionsNetCDF&&) noexcept;
 
-  /// Read options from file
-  Options read();
+  /// Read options from file. Variables with more than \p max_dims
+  /// dimensions only have their attributes read, not their values, so
+  /// that they can be read in parts with `readHyperslab`
+  Options read(int max_dims = 3);
 
-  /// Write options to file
+  /// Shape of top-level variable \p name, or empty if it isn't in the
+  /// file
+  std::vector<int> readShape(const std::string& name);
+
+  /// Read part of top-level variable \p name: \p count points from
+  /// \p start in each dimension. The result is an Array, Matrix or
+  /// Tensor, for 1, 2 or 3 dimensions. The file is kept open between
+  /// reads
+  Options readHyperslab(const std::string& name, const std::vector<int>& start,
+                        const std::vector<int>& count);
+
+  /// Write options to file. The variables are looked up in the file
+  /// the first time they are written, and kept open for later writes.
+  /// Their time indices are kept in memory, and saved in the file
+  /// each time it is synced, after every write.
+  ///
+  /// These attributes of a value change how it's written:
+  ///  - precision        [string] "double" (default) or "float", to
+  ///                     write fields as 32-bit floats. Other values
+  ///                     such as times are always written as doubles
+  ///  - guard_cells      [bool] If false, fields are written to a file
+  ///                     of one processor as in a shared file, without
+  ///                     guard cells or Y boundary cells, and with
+  ///                     dimensions "x_interior" etc. Default true
+  ///  - compress         [string] "zlib" or "zstd" compression of
+  ///                     fields, in chunks of one time record of one
+  ///                     processor's interior, of at most 4 MiB.
+  ///                     Default "none"
+  ///  - compress_level   [int] Level of compression, default 4
+  ///  - significant_bits [int] Bits of the mantissa to keep. The others
+  ///                     are rounded so they compress better. Default
+  ///                     0 keeps them all
+  ///  - per_processor    [bool] If true, the value is different on
+  ///                     each processor, so isn't written to shared
+  ///                     files. Default false
+  ///
+  /// Compression and rounding are only set when a variable is added
+  /// to the file. zstd and rounding need NetCDF 4.9
   void write(const Options& options) { write(options, "t"); }
   void write(const Options& options, const std::string& time_dim);
 
   /// Check that all variables with the same time dimension have the
   /// same size in that dimension. Throws BoutException if there are
-  /// any differences, otherwise is silent
+  /// any differences, otherwise is silent. While the file is open for
+  /// writing, only the variables written through this object are
+  /// checked, without reading the file. If the file is written
+  /// asynchronously, the check is done after the queued writes, and
+  /// any error is thrown by a later call
   void verifyTimesteps() const;
 
+  /// Wait for all queued writes to finish, and save the time indices
+  /// in the file. Throws the first error from the writes, if there
+  /// were any
+  void flush();
+
+  /// Use \p attributes for the variables which don't set them. For
+  /// example, {{"precision", "float"}, {"compress", "zlib"}} writes
+  /// fields as 32-bit floats, and compresses them. See `write` for the attributes which change how variables
+  /// are written
+  void setDefaultAttributes(std::map<std::string, Options::AttributeType> attributes) {
+    default_attributes = std::move(attributes);
+  }
+
 private:
+  class Writer;
+
+  /// Open the file, if it isn't already
+  void openForWriting();
+  /// Finish any queued writes, save the time indices and close the
+  /// file. Throws the first error from the queued writes, after
+  /// closing the file
+  void closeFile();
+  /// Open the file for `readShape` and `readHyperslab`, if it isn't
+  /// already
+  const netCDF::NcFile& openForReading();
+
   /// Name of the file on disk
   std::string filename;
   /// How to open the file for writing
   FileMode file_mode{FileMode::replace};
+  /// Has the file been opened for writing? If so, it's reopened
+  /// without replacing it
+  bool opened{false};
+  /// Processors writing the file, if shared
+  SharedFile shared;
   /// Pointer to netCDF file so we don't introduce direct dependence
   std::unique_ptr<netCDF::NcFile> data_file;
+  /// The file, if opened for reading parts of variables. Closed
+  /// before writing
+  std::unique_ptr<netCDF::NcFile> read_file;
+  /// Variables written to `data_file`, while it's open
+  std::unique_ptr<details::NcSchema> schema;
+  /// Attributes of variables which don't set them
+  std::map<std::string, Options::AttributeType> default_attributes;
+  /// Thread writing to `data_file`, if asynchronous. Must be declared
+  /// after `data_file`, so that it finishes before the file is closed
+  std::unique_ptr<Writer> writer;
 };
 
 } // namespace bout
@@ -107,6 +243,8 @@ std::string getRestartFilename(Options& options, int rank);
 std::string getOutputFilename(Options& options);
 /// Name of the main output file on \p rank
 std::string getOutputFilename(Options& options, int rank);
+/// Name of the main output file, if it is shared by all processors
+std::string getSharedOutputFilename(Options& options);
 /// Write `Options::root()` to the main output file, overwriting any
 /// existing files
 void writeDefaultOutputFile();
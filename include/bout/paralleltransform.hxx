@@ -295,14 +295,17 @@ private:
                    const std::string& region = "RGN_NOX") const;
 
   /*!
-   * Shift a given 1D array, assumed to be in Z, by the given \p zangle
+   * Shift \p npencils contiguous 1D arrays, assumed to be in Z, by the
+   * given phases
    *
-   * @param[in] in  A 1D array of length mesh.LocalNz
-   * @param[in] phs Phase shift, assumed to have length (mesh.LocalNz/2 + 1) i.e. the
-   * number of modes
-   * @param[out] out  A 1D array of length mesh.LocalNz, already allocated
+   * @param[in] in  \p npencils contiguous 1D arrays of length mesh.LocalNz
+   * @param[in] phs Phase shifts, assumed to have length (mesh.LocalNz/2 + 1) i.e. the
+   * number of modes, for each of the \p npencils arrays
+   * @param[out] out  \p npencils 1D arrays of length mesh.LocalNz, already allocated
+   * @param[in] npencils  Number of arrays to shift
    */
-  void shiftZ(const BoutReal* in, const dcomplex* phs, BoutReal* out) const;
+  void shiftZ(const BoutReal* in, const dcomplex* phs, BoutReal* out,
+              int npencils = 1) const;
 
   /// Calculate and store the phases for to/from field aligned and for
   /// the parallel slices using zShift
@@ -237,6 +237,10 @@ public:
   /// variables have the correct length
   void finishOutputTimestep() const;
 
+  /// Wait for the output and restart files to be written, if they are
+  /// written asynchronously
+  void finishOutput();
+
 protected:
   // The init and rhs functions are implemented by user code to specify problem
   /*!
@@ -373,6 +373,11 @@ protected:
   /// Calculate the number of evolving variables on this processor
   int getLocalN();
 
+  /// Number of points which are actually evolved on this processor.
+  /// The same as getLocalN(), except with `zero_copy`, where the
+  /// state vector also holds the guard cells
+  int getLocalEvolvedN();
+
   /// A structure to hold an evolving variable
   template <class T>
   struct VarStr {
@@ -438,6 +443,15 @@ protected:
 
   /// Can this solver handle constraints? Set to true if so.
   bool has_constraints{false};
+  /// Can this solver work with state vectors that store whole fields,
+  /// including guard cells? Set to true if so. This allows the
+  /// `zero_copy` option, where evolving variables share memory with
+  /// the state vectors rather than being copied in and out.
+  ///
+  /// The solver must only use load_vars, save_vars and save_derivs,
+  /// treat the state elementwise, and keep each state vector alive
+  /// until the next load_vars
+  bool can_alias_state{false};
   /// Has init been called yet?
   bool initialised{false};
 
@@ -576,10 +590,45 @@ private:
   /// Should be run after user RHS is called
   void post_rhs(BoutReal t);
 
+  /// A strided run of one variable's data in the state vector:
+  /// elements `[field_start, field_start + count)` of the variable
+  /// are at `state_start + i * state_stride` in the state vector
+  struct StateRun {
+    int var;          ///< Index into f2d, then f3d
+    int field_start;  ///< Flat index of the first element in the field
+    int state_start;  ///< Index of the first element in the state vector
+    int count;        ///< Number of elements in this run
+    int state_stride; ///< Distance between elements in the state vector
+  };
+  /// Where each variable lives in the state vector, which is
+  /// interleaved as [var][z] at each (x, y) point
+  std::vector<StateRun> state_runs;
+  /// Number of variables when `state_runs` was calculated
+  std::size_t state_runs_nvars{0};
+  /// Calculate `state_runs`, which only depends on the mesh and the
+  /// variables being evolved
+  void calculateStateRuns();
+
   /// Loading data from BOUT++ to/from solver
-  void loop_vars_op(Ind2D i2d, BoutReal* udata, int& p, SOLVER_VAR_OP op, bool bndry);
   void loop_vars(BoutReal* udata, SOLVER_VAR_OP op);
 
+  /// Use state vectors which store whole fields, and make the
+  /// evolving variables share memory with them?
+  bool zero_copy{false};
+  /// Value of getLocalN(), once calculated, which depends on `zero_copy`
+  int cached_local_N{-1};
+  /// Points in the state vector which are not evolved when using
+  /// `zero_copy`: the guard cells, and the boundaries unless
+  /// `evolve_bndry` is set. The time derivatives there are set to
+  /// zero, so the solver leaves them unchanged
+  Region<Ind2D> frozen_2d, frozen_2d_evolve_bndry;
+  Region<Ind3D> frozen_3d, frozen_3d_evolve_bndry;
+  /// Equivalent of `loop_vars` for `zero_copy`
+  void alias_vars(BoutReal* udata, SOLVER_VAR_OP op);
+  /// Make evolving variables and their time derivatives own their
+  /// data again, so they don't refer to the solver's state vectors
+  void unalias_vars();
+
   /// Check if a variable has already been added
   bool varAdded(const std::string& name);
 
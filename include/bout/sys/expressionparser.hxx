@@ -42,6 +42,7 @@
 #include <utility>
 
 #include "generator_context.hxx"
+#include "generator_program.hxx"
 
 class FieldGenerator;
 using FieldGeneratorPtr = std::shared_ptr<FieldGenerator>;
@@ -81,6 +82,14 @@ public:
   /// this function will be made pure virtual.
   virtual double generate(const bout::generator::Context& ctx);
 
+  /// Add this generator to \p program, returning the register which
+  /// holds the result. Generators which can't be compiled return -1,
+  /// and are evaluated by calling generate() instead
+  virtual bout::generator::Program::Register
+  compile(bout::generator::Program& UNUSED(program)) const {
+    return -1;
+  }
+
   /// Create a string representation of the generator, for debugging output
   virtual std::string str() const { return std::string("?"); }
 };
@@ -211,6 +220,12 @@ public:
       : lhs(std::move(l)), rhs(std::move(r)), op(o) {}
   FieldGeneratorPtr clone(const std::list<FieldGeneratorPtr> args) override;
   double generate(const bout::generator::Context& context) override;
+  bout::generator::Program::Register
+  compile(bout::generator::Program& program) const override {
+    // Arguments in order, so that constant arguments can be folded
+    const auto lhs_reg = lhs->compile(program);
+    return program.binary(op, lhs_reg, rhs->compile(program));
+  }
 
   std::string str() const override {
     return std::string("(") + lhs->str() + std::string(1, op) + rhs->str()
@@ -232,6 +247,10 @@ public:
   }
 
   double generate(const bout::generator::Context&) override { return value; }
+  bout::generator::Program::Register
+  compile(bout::generator::Program& program) const override {
+    return program.constant(value);
+  }
   std::string str() const override {
     std::stringstream ss;
     ss << value;
@@ -0,0 +1,167 @@
+/*!************************************************************************
+ * \file generator_program.hxx
+ *
+ * Flat, register-based form of a FieldGenerator tree, which can be
+ * evaluated over whole lines of points without virtual calls or
+ * string lookups of the coordinates.
+ *
+ **************************************************************************/
+
+#pragma once
+
+#include "bout/bout_types.hxx"
+
+#include <vector>
+
+class FieldGenerator;
+
+namespace bout {
+namespace generator {
+
+/// A FieldGenerator tree lowered to a list of instructions
+///
+/// Each instruction writes one register, a line of values the length
+/// of the evaluated line. Instructions only read registers written
+/// by earlier instructions, so the program is run from start to end.
+///
+/// Generators add themselves to a program through
+/// `FieldGenerator::compile`, which returns the register holding the
+/// result, or -1 if the generator (or one of its arguments) can't be
+/// compiled. In that case the program is not valid, and the tree
+/// should be evaluated with `FieldGenerator::generate` instead.
+///
+/// Instructions which don't depend on z are evaluated once per line.
+/// Parts of the program which don't depend on time (t or values read
+/// through pointers) can be "hoisted": evaluated once with
+/// `evaluateHoisted`, stored by the caller, and passed back in to
+/// `evaluate` so that only the time-dependent instructions are run.
+///
+/// Example
+/// -------
+///
+///     bout::generator::Program program{*generator};
+///     if (program.valid()) {
+///       program.evaluate(x, y, z_values, t, nz, result, workspace);
+///     }
+class Program {
+public:
+  /// Index of a register. Negative values indicate a compile failure
+  using Register = int;
+
+  /// Coordinates which can be used in a program
+  enum class Variable { x, y, z, t };
+
+  using single_arg_op = BoutReal (*)(BoutReal);
+  using double_arg_op = BoutReal (*)(BoutReal, BoutReal);
+
+  Program() = default;
+
+  /// Compile the tree starting at \p root. If any part of the tree
+  /// can't be compiled, then the program is empty and not valid
+  explicit Program(const FieldGenerator& root);
+
+  /// True if the whole tree was compiled
+  bool valid() const { return output >= 0; }
+
+  /// Number of instructions in the program
+  std::size_t size() const { return instructions.size(); }
+
+  /// True if the result depends on t, or on a value read through a pointer
+  bool dependsOnTime() const { return valid() and instructions[output].depends_t; }
+
+  /// Number of time-independent registers which the time-dependent
+  /// part of the program reads. Zero if the program doesn't depend on time
+  std::size_t numHoisted() const { return hoisted.size(); }
+
+  /// Add a constant value
+  Register constant(BoutReal value);
+  /// Add a value which is read from \p ptr every time the program is evaluated
+  Register pointer(const BoutReal* ptr);
+  /// Add one of the coordinates
+  Register variable(Variable var);
+  /// Add a binary operator, one of + - * / ^. Returns -1 for any
+  /// other operator, or if either argument is invalid
+  Register binary(char op, Register lhs, Register rhs);
+  /// Add a call to a function of one argument
+  Register call(single_arg_op function, Register arg);
+  /// Add a call to a function of two arguments
+  Register call(double_arg_op function, Register arg1, Register arg2);
+
+  /// Evaluate the program at \p n points which share \p x, \p y and
+  /// \p t, with \p z given at each point. The values are written to
+  /// \p result. The registers are stored in \p workspace, which is
+  /// resized as needed so that it can be reused between calls
+  ///
+  /// If \p hoisted_values is given, it must contain the values from
+  /// `evaluateHoisted` for the same points, and only the
+  /// time-dependent part of the program is evaluated
+  void evaluate(BoutReal x, BoutReal y, const BoutReal* z, BoutReal t, int n,
+                BoutReal* result, std::vector<BoutReal>& workspace,
+                const BoutReal* hoisted_values = nullptr) const;
+
+  /// Evaluate the time-independent part of the program at \p n points,
+  /// writing `numHoisted() * n` values to \p hoisted_values
+  void evaluateHoisted(BoutReal x, BoutReal y, const BoutReal* z, int n,
+                       BoutReal* hoisted_values,
+                       std::vector<BoutReal>& workspace) const;
+
+private:
+  enum class Op {
+    constant,
+    pointer,
+    x,
+    y,
+    z,
+    t,
+    add,
+    subtract,
+    multiply,
+    divide,
+    power,
+    call1,
+    call2
+  };
+
+  struct Instruction {
+    Op op;
+    Register lhs{-1}, rhs{-1}; ///< Argument registers
+    BoutReal value{0.0};       ///< Value of a constant
+    const BoutReal* ptr{nullptr};
+    single_arg_op function1{nullptr};
+    double_arg_op function2{nullptr};
+    bool depends_z{false}; ///< False if the same at all points in a line
+    bool depends_t{false}; ///< False if the same at all times
+  };
+
+  /// Which instructions are run by `run`
+  enum class Part { all, hoisted, time_dependent };
+
+  /// Run the instructions in \p part, with registers stored in \p workspace
+  void run(Part part, BoutReal x, BoutReal y, const BoutReal* z, BoutReal t, int n,
+           std::vector<BoutReal>& workspace) const;
+
+  /// True for instructions which are cheaper to evaluate than to load
+  bool isLeaf(Register reg) const { return instructions[reg].op <= Op::t; }
+
+  /// Append \p instruction, returning the register it writes
+  Register add(Instruction instruction);
+
+  bool isConstant(Register reg) const {
+    return instructions[reg].op == Op::constant;
+  }
+
+  /// Remove instructions which the output doesn't depend on, such as
+  /// the arguments of folded constants, and renumber the registers
+  void removeUnused();
+
+  std::vector<Instruction> instructions;
+
+  /// Register holding the result
+  Register output{-1};
+
+  /// Time-independent registers read by time-dependent instructions
+  std::vector<Register> hoisted;
+};
+
+} // namespace generator
+} // namespace bout
@@ -2,9 +2,12 @@
 #define __TIMER_H__
 
 #include <chrono>
+#include <iosfwd>
 #include <map>
+#include <mutex>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "bout/msg_stack.hxx"
 #include "bout/output.hxx"
@@ -106,6 +109,10 @@ private:
   /// Store of existing timing info objects
   static std::map<std::string, timer_info> info;
 
+  /// Protects `info`, so that timers can be used by threads outside
+  /// OpenMP regions, such as those in a `bout::ThreadPool`
+  static std::mutex info_mutex;
+
   /// Get a timing info object by name or return a new instance
   static timer_info& getInfo(const std::string& label);
 
@@ -123,7 +130,10 @@ private:
 
 public:
   /// Return the map of all the individual timers
-  static std::map<std::string, timer_info> getAllInfo() { return info; }
+  static std::map<std::string, timer_info> getAllInfo() {
+    std::lock_guard<std::mutex> lock(info_mutex);
+    return info;
+  }
 
   /// Print a table listing all known timers to `output`
   ///
@@ -134,4 +144,95 @@ public:
 };
 
 #define AUTO_TIME() Timer CONCATENATE(time_, __LINE__)(__thefunc__)
+
+namespace bout {
+namespace timing {
+
+/// Interned name of a timed region
+using RegionId = int;
+
+/// Get the id of the region called \p name, creating it if needed.
+/// This is thread-safe but takes a lock, so should be called once per
+/// call site, for example through `BOUT_TIME_REGION`
+RegionId getRegionId(const std::string& name);
+
+/// Name of the region \p id
+std::string getRegionName(RegionId id);
+
+struct ThreadTimes;
+
+/*!
+ * Low-overhead timing of a region, from construction to destruction
+ *
+ * Unlike `Timer`, there is no lookup by name: the region is given by
+ * an id from `getRegionId`. Each thread accumulates its own times,
+ * in a tree keyed by the enclosing regions, so a region entered from
+ * different places is reported separately. The threads are merged
+ * when the times are reported.
+ *
+ * Usually used through the `BOUT_TIME_REGION` macro:
+ *
+ *     void someFunction() {
+ *       BOUT_TIME_REGION("someFunction");
+ *       ...
+ *     }
+ */
+class ScopedRegion {
+public:
+  explicit ScopedRegion(RegionId id);
+  ~ScopedRegion();
+
+  ScopedRegion(const ScopedRegion&) = delete;
+  ScopedRegion& operator=(const ScopedRegion&) = delete;
+
+private:
+  ThreadTimes* times; ///< Times for the current thread
+  int node;           ///< This region in the thread's tree
+  bool record_event;  ///< Add an event to the trace when finished
+  Timer::clock_type::time_point started;
+};
+
+/// Time spent in one path through the regions, summed over threads
+struct RegionTime {
+  std::string path;   ///< Names of the regions from the outermost, separated by "/"
+  int depth;          ///< Number of enclosing regions
+  double time;        ///< Total time in seconds
+  unsigned long hits; ///< Number of times the region was entered
+  int threads;        ///< Number of threads which entered the region
+};
+
+/// Get the times of all region paths, with each path followed by the
+/// paths it encloses. Should not be called while regions are running
+/// in other threads
+std::vector<RegionTime> getRegionTimes();
+
+/// Print a table of all region times to `output`, indented by depth
+void printRegionReport();
+
+/// Record every region entered, so that `writeTrace` can write a
+/// timeline, rather than only accumulating times
+void setTracing(bool enabled);
+bool isTracing();
+
+/// Write the regions recorded while tracing, in the Chrome trace event
+/// JSON format which can be viewed with chrome://tracing or Perfetto.
+/// \p process is used as the process id, for example the MPI rank
+void writeTrace(std::ostream& out, int process = 0);
+
+/// Clear all region times and trace events. The region ids remain valid.
+/// Should not be called while any regions are running
+void resetRegions();
+
+} // namespace timing
+} // namespace bout
+
+/// Time the rest of the enclosing scope as region \p name. The
+/// region id is looked up once, the first time this line is reached
+#define BOUT_TIME_REGION(name)                                                   \
+  static const bout::timing::RegionId CONCATENATE(bout_region_id_, __LINE__) =   \
+      bout::timing::getRegionId(name);                                           \
+  const bout::timing::ScopedRegion CONCATENATE(bout_region_, __LINE__) {         \
+    CONCATENATE(bout_region_id_, __LINE__)                                       \
+  }
+
 #endif // __TIMER_H__
@@ -0,0 +1,201 @@
+/*!************************************************************************
+ * \file thread_pool.hxx
+ *
+ * A persistent pool of threads with work-stealing task queues, as an
+ * opt-in alternative to OpenMP parallel regions for loops over fields.
+ *
+ **************************************************************************/
+
+#ifndef BOUT_THREAD_POOL_H
+#define BOUT_THREAD_POOL_H
+
+#include "bout/region.hxx"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bout {
+
+/// A fixed set of threads which are kept alive to run tasks
+///
+/// Each `BOUT_FOR` loop starts an OpenMP parallel region, and for
+/// small grids the cost of starting and finishing them can be larger
+/// than the loop itself. The pool's threads wait for tasks between
+/// loops instead. Each thread has its own queue of tasks, and takes
+/// tasks from the other queues when its own is empty, so work is
+/// balanced if some tasks take longer than others.
+///
+/// Usually used through `parallelFor` and `TaskGroup`. The pool has no
+/// threads, and so isn't used, unless the `thread_pool_threads` option
+/// is set, or `resize` is called.
+///
+/// Tasks run with one OpenMP thread, so that operators called from
+/// tasks (e.g. by `TaskGroup`) don't start more threads.
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  /// The pool used by `parallelFor` and `TaskGroup`
+  static ThreadPool& getInstance();
+
+  ThreadPool() = default;
+  ~ThreadPool() { resize(0); }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /// Stop the current threads, once their queues are empty, and start
+  /// \p nthreads new ones. With no threads, tasks are run immediately
+  /// by the thread which submits them. Must not be called while tasks
+  /// are being submitted
+  void resize(int nthreads);
+
+  /// Number of threads, not including threads which wait for tasks
+  int size() const { return static_cast<int>(workers.size()); }
+
+  /// Queue \p task to be run by one of the threads. The task must not
+  /// throw; `TaskGroup` catches exceptions and passes them on
+  void submit(Task task);
+
+  /// Run one queued task on the calling thread, if there are any.
+  /// Returns false if there were none
+  bool runPending();
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /// Take a task, from the back of queue \p own if it is a valid
+  /// index, otherwise from the front of any queue
+  bool take(int own, Task& task);
+
+  void workerLoop(int index);
+
+  /// Queue of the calling thread, if it belongs to this pool, or -1
+  int ownQueue() const;
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+
+  std::atomic<std::size_t> queued{0};    ///< Number of tasks in all queues
+  std::atomic<std::size_t> next_queue{0}; ///< Queue for tasks from other threads
+  bool stopping{false};
+  std::mutex sleep_mutex;
+  std::condition_variable wake;
+};
+
+/// A set of tasks which can be waited for together
+///
+///     TaskGroup tasks;
+///     tasks.run([&]() { dfdx = DDX(f); });
+///     tasks.run([&]() { dgdx = DDX(g); });
+///     tasks.wait();
+///
+/// The waiting thread runs queued tasks while it waits, so groups can
+/// be used inside tasks. Once there are none left, it sleeps until the
+/// group's tasks have finished. If any task throws an exception, the
+/// first one is rethrown by `wait`.
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool& pool = ThreadPool::getInstance()) : pool(pool) {}
+
+  /// Waits for any remaining tasks, ignoring exceptions
+  ~TaskGroup();
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  /// Run \p task in the pool. It is copied, so usually captures
+  /// variables by reference, which must outlive `wait`
+  template <typename F>
+  void run(F&& task) {
+    if (pool.size() == 0) {
+      invoke(task);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      ++pending;
+    }
+    pool.submit([this, task]() {
+      invoke(task);
+      // Last use of this group, which may be destroyed once wait
+      // returns. Notifying with the lock held means that it can't
+      // return until this has finished
+      std::lock_guard<std::mutex> lock(mutex);
+      --pending;
+      finished.notify_all();
+    });
+  }
+
+  /// Wait for all the tasks run so far to finish
+  void wait();
+
+private:
+  template <typename F>
+  void invoke(F& task) {
+    try {
+      task();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (not error) {
+        error = std::current_exception();
+      }
+    }
+  }
+
+  ThreadPool& pool;
+  std::mutex mutex; ///< Protects `pending` and `error`
+  std::condition_variable finished;
+  int pending{0}; ///< Number of tasks which haven't finished
+  std::exception_ptr error;
+};
+
+/// Call \p function(index) for each index in \p region, using the
+/// `ThreadPool`. The blocks of the region are split into a few tasks
+/// for each thread. If the pool has no threads, this is the same as
+///
+///     BOUT_FOR(index, region) { function(index); }
+template <typename T, typename Function>
+void parallelFor(const Region<T>& region, const Function& function) {
+  auto& pool = ThreadPool::getInstance();
+  if (pool.size() == 0) {
+    BOUT_FOR(index, region) { function(index); }
+    return;
+  }
+
+  const auto& blocks = region.getBlocks();
+  const std::size_t nblocks = blocks.size();
+  // Including the waiting thread
+  const auto nthreads = static_cast<std::size_t>(pool.size()) + 1;
+  const std::size_t ntasks = std::min(nblocks, 4 * nthreads);
+
+  TaskGroup group(pool);
+  for (std::size_t task = 0; task < ntasks; ++task) {
+    const std::size_t first = task * nblocks / ntasks;
+    const std::size_t last = (task + 1) * nblocks / ntasks;
+    group.run([&blocks, &function, first, last]() {
+      for (std::size_t block = first; block < last; ++block) {
+        for (auto index = blocks[block].first; index < blocks[block].second; ++index) {
+          function(index);
+        }
+      }
+    });
+  }
+  group.wait();
+}
+
+} // namespace bout
+
+#endif // BOUT_THREAD_POOL_H
@@ -0,0 +1,101 @@
+/*!************************************************************************
+ * \file tiled_loop.hxx
+ *
+ * Runs a sequence of loop kernels one Region block at a time, so that
+ * intermediate values stay in cache between kernels.
+ *
+ **************************************************************************/
+
+#ifndef BOUT_TILED_LOOP_H
+#define BOUT_TILED_LOOP_H
+
+#include "bout/openmpwrap.hxx"
+#include "bout/region.hxx"
+
+#include <functional>
+#include <vector>
+
+namespace bout {
+
+/// A sequence of kernels, which are run over a Region block by block
+///
+/// A right hand side written with field operators, or as a series of
+/// `BOUT_FOR` loops, streams every field through memory once for each
+/// loop. When the fields are larger than the cache, the loops are
+/// limited by memory bandwidth. Instead, the loops can be added to a
+/// `TiledLoop` as stages, and `run` calls every stage on one block of
+/// the region before moving on to the next block. Values written by
+/// one stage and read by the next are then still in cache:
+///
+///     Field3D tmp{emptyFrom(a)}, result{emptyFrom(a)};
+///     TiledLoop<Ind3D>(a.getRegion("RGN_NOBNDRY"))
+///         .then([&](const Ind3D& i) { tmp[i] = a[i] * b[i] + c[i]; })
+///         .then([&](const Ind3D& i) {
+///           result[i] = tmp[i] * (d[i.zp()] - d[i.zm()]);
+///         })
+///         .run();
+///
+/// The blocks are the Region's contiguous blocks, so the tile size is
+/// set by `mesh:maxregionblocksize`. Blocks are shared between OpenMP
+/// threads, as in `BOUT_FOR`.
+///
+/// Because blocks are finished one at a time, a stage must only read
+/// values written by earlier stages at the index it is called
+/// with. Neighbouring points, as in the stencil on `d` above, can only
+/// be read from fields which no stage writes. Fields written by stages
+/// must already be allocated. `runByStage` runs each stage over the
+/// whole region in turn, for comparison.
+template <typename T>
+class TiledLoop {
+public:
+  using Block = typename Region<T>::ContiguousBlock;
+
+  /// The \p region is not copied, so must exist while this is used
+  explicit TiledLoop(const Region<T>& region) : region(region) {}
+
+  /// Add a stage which calls \p kernel(index) for every index in the
+  /// region. The kernel is copied, so usually captures fields by
+  /// reference
+  template <typename Kernel>
+  TiledLoop& then(Kernel kernel) {
+    stages.emplace_back([kernel](const Block& block) {
+      for (auto index = block.first; index < block.second; ++index) {
+        kernel(index);
+      }
+    });
+    return *this;
+  }
+
+  /// Run all the stages on each block in turn
+  void run() const {
+    const auto& blocks = region.getBlocks();
+    BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+    for (auto block = blocks.cbegin(); block < blocks.cend(); ++block) {
+      for (const auto& stage : stages) {
+        stage(*block);
+      }
+    }
+  }
+
+  /// Run each stage on the whole region in turn
+  void runByStage() const {
+    const auto& blocks = region.getBlocks();
+    for (const auto& stage : stages) {
+      BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+      for (auto block = blocks.cbegin(); block < blocks.cend(); ++block) {
+        stage(*block);
+      }
+    }
+  }
+
+  /// Number of stages
+  std::size_t size() const { return stages.size(); }
+
+private:
+  const Region<T>& region;
+  std::vector<std::function<void(const Block&)>> stages;
+};
+
+} // namespace bout
+
+#endif // BOUT_TILED_LOOP_H
@@ -36,6 +36,7 @@ const char DEFAULT_DIR[] = "data";
 #include "bout/boutcomm.hxx"
 #include "bout/boutexception.hxx"
 #include "bout/coordinates_accessor.hxx"
+#include "bout/fft.hxx"
 #include "bout/hyprelib.hxx"
 #include "bout/interpolation_xz.hxx"
 #include "bout/interpolation_z.hxx"
@@ -53,6 +54,7 @@ const char DEFAULT_DIR[] = "data";
 #include "bout/slepclib.hxx"
 #include "bout/solver.hxx"
 #include "bout/sys/timer.hxx"
+#include "bout/thread_pool.hxx"
 #include "bout/version.hxx"
 
 #define BOUT_NO_USING_NAMESPACE_BOUTGLOBALS
@@ -61,8 +63,15 @@ const char DEFAULT_DIR[] = "data";
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <cctype>
 #include <csignal>
 #include <ctime>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -196,6 +205,53 @@ int BoutInitialise(int& argc, char**& argv) {
 
     bout::globals::mpi = new MpiWrapper();
 
+    // Load any saved FFTW plans before anything gets transformed
+    bout::fft::fft_import_wisdom();
+
+    // How Arrays, mostly field data, are allocated
+    auto& allocation = arrayAllocation();
+    allocation.alignment =
+        Options::root()["array_alignment"]
+            .doc("Alignment of Array memory in bytes. Must be a power of two")
+            .withDefault(static_cast<int>(allocation.alignment));
+    if ((allocation.alignment < sizeof(void*))
+        or ((allocation.alignment & (allocation.alignment - 1)) != 0)) {
+      throw BoutException(_("array_alignment must be a power of two, at least {:d}"),
+                          sizeof(void*));
+    }
+    allocation.huge_pages =
+        Options::root()["array_huge_pages"]
+            .doc("Use transparent huge pages for large Arrays, if available")
+            .withDefault(allocation.huge_pages);
+    allocation.first_touch =
+        Options::root()["array_first_touch"]
+            .doc("Initialise new Arrays in parallel, so that memory is placed close "
+                 "to the OpenMP threads which use it")
+            .withDefault(allocation.first_touch);
+
+    // Memory which Arrays keep for reuse
+    const auto pool_limit =
+        Options::root()["array_pool_limit"]
+            .doc("Maximum memory in MB kept for reuse by each thread, for Arrays "
+                 "of each type. By default (< 0), no limit")
+            .withDefault(-1.0);
+    if (pool_limit >= 0.0) {
+      const auto bytes = static_cast<std::size_t>(pool_limit * 1024 * 1024);
+      Array<BoutReal>::setPoolLimit(bytes);
+      Array<dcomplex>::setPoolLimit(bytes);
+    }
+
+    // Threads kept alive for parallelFor and TaskGroup
+    const int pool_threads =
+        Options::root()["thread_pool_threads"]
+            .doc("Number of threads used by bout::parallelFor and bout::TaskGroup. "
+                 "By default (0), these use OpenMP loops instead")
+            .withDefault(0);
+    if (pool_threads < 0) {
+      throw BoutException(_("thread_pool_threads must not be negative"));
+    }
+    bout::ThreadPool::getInstance().resize(pool_threads);
+
     // Create the mesh
     bout::globals::mesh = Mesh::create();
     // Load from sources. Required for Field initialisation
@@ -205,6 +261,13 @@ int BoutInitialise(int& argc, char**& argv) {
     // check for unused options
     Options::root()["time_report"].setConditionallyUsed();
 
+    // Regions must be recorded from the start to be in the trace
+    bout::timing::setTracing(
+        Options::root()["time_report"]["trace"]
+            .doc("Record timed regions, and write them to BOUT.trace.<rank>.json "
+                 "in the data directory")
+            .withDefault(false));
+
   } catch (const BoutException& e) {
     output_error.write(_("Error encountered during initialisation: {:s}\n"), e.what());
     throw;
@@ -723,6 +786,17 @@ void writeSettingsFile(Options& options, const std::string& data_dir,
 } // namespace experimental
 } // namespace bout
 
+namespace {
+void printPoolStats(const std::string& name, const ArrayPoolStats& stats) {
+  constexpr BoutReal megabyte = 1024 * 1024;
+  output.write("Array<{:s}> pool: {:d} hits, {:d} misses, {:d} discarded, "
+               "{:.1f} MB held (peak {:.1f} MB)\n",
+               name, stats.hits, stats.misses, stats.discarded,
+               static_cast<BoutReal>(stats.bytes_held) / megabyte,
+               static_cast<BoutReal>(stats.peak_bytes_held) / megabyte);
+}
+} // namespace
+
 int BoutFinalise(bool write_settings) {
 
   // Output the settings, showing which options were used
@@ -749,6 +823,19 @@ int BoutFinalise(bool write_settings) {
     output.write("\nTimer report \n\n");
     Timer::printTimeReport();
     output.write("\n");
+    bout::timing::printRegionReport();
+    output.write("\n");
+    printPoolStats("BoutReal", Array<BoutReal>::poolStats());
+    printPoolStats("dcomplex", Array<dcomplex>::poolStats());
+    output.write("\n");
+  }
+
+  if (bout::timing::isTracing()) {
+    const auto data_dir =
+        Options::root()["datadir"].withDefault(std::string{DEFAULT_DIR});
+    std::ofstream trace_file{
+        fmt::format("{}/BOUT.trace.{}.json", data_dir, BoutComm::rank())};
+    bout::timing::writeTrace(trace_file, BoutComm::rank());
   }
 
   // Delete the mesh
@@ -757,9 +844,18 @@ int BoutFinalise(bool write_settings) {
   // Make sure all processes have finished writing before exit
   bout::globals::mpi->MPI_Barrier(BoutComm::get());
 
+  // Save FFTW plans for the next run
+  bout::fft::fft_export_wisdom();
+
+  // Stop the thread pool's threads
+  bout::ThreadPool::getInstance().resize(0);
+
   // Laplacian inversion
   Laplacian::cleanup();
 
+  // Cached FFT plans
+  bout::fft::fft_cleanup();
+
   // Delete field memory
   Array<BoutReal>::cleanup();
   Array<dcomplex>::cleanup();
@@ -774,6 +870,7 @@ int BoutFinalise(bool write_settings) {
 
   // Cleanup timer
   Timer::cleanup();
+  bout::timing::resetRegions();
 
   // Options tree
   Options::cleanup();
@@ -821,7 +918,11 @@ BoutMonitor::BoutMonitor(BoutReal timestep, Options& options)
           fmt::format("{}/{}", Options::root()["datadir"].withDefault(DEFAULT_DIR),
                       options["stopCheckName"]
                           .doc(_("Name of file whose existence triggers a stop"))
-                          .withDefault("BOUT.stop"))) {}
+                          .withDefault("BOUT.stop"))),
+      imbalance_report(options["time_report"]["imbalance"]
+                           .doc(_("Write the spread of times between processors for "
+                                  "each Timer to the output file"))
+                           .withDefault(false)) {}
 
 int BoutMonitor::call(Solver* solver, BoutReal t, MAYBE_UNUSED(int iter), int NOUT) {
   TRACE("BoutMonitor::call({:e}, {:d}, {:d})", t, iter, NOUT);
@@ -883,8 +984,14 @@ int BoutMonitor::call(Solver* solver, BoutReal t, MAYBE_UNUSED(int iter), int NO
       time_to_hms(run_data.wtime * static_cast<BoutReal>(NOUT - iteration - 2)));
 
   // Write dump file
+  // The times differ between processors, so the slowest is written,
+  // and the values are the same in every file
   Options run_data_output;
-  run_data.outputVars(run_data_output);
+  run_data.maxOverProcessors().outputVars(run_data_output);
+  if (imbalance_report) {
+    imbalance.gather(*bout::globals::mesh);
+    imbalance.outputVars(run_data_output);
+  }
   solver->writeToModelOutputFile(run_data_output);
 
   if (wall_limit > 0.0) {
@@ -1009,6 +1116,37 @@ void RunMetrics::outputVars(Options& output_options) const {
   output_options["wtime_per_rhs_i"].assignRepeat(wtime_per_rhs_i, "t", true, "Output");
 }
 
+RunMetrics RunMetrics::maxOverProcessors() const {
+  Timer time("io");
+  // The counts are exact as doubles
+  const std::vector<BoutReal> local{t_elapsed,
+                                    wtime,
+                                    static_cast<BoutReal>(ncalls),
+                                    static_cast<BoutReal>(ncalls_e),
+                                    static_cast<BoutReal>(ncalls_i),
+                                    wtime_rhs,
+                                    wtime_invert,
+                                    wtime_comms,
+                                    wtime_io};
+  std::vector<BoutReal> max(local.size());
+  bout::globals::mpi->MPI_Allreduce(local.data(), max.data(),
+                                    static_cast<int>(local.size()), MPI_DOUBLE, MPI_MAX,
+                                    BoutComm::get());
+
+  RunMetrics result;
+  result.t_elapsed = max[0];
+  result.wtime = max[1];
+  result.ncalls = static_cast<int>(max[2]);
+  result.ncalls_e = static_cast<int>(max[3]);
+  result.ncalls_i = static_cast<int>(max[4]);
+  result.wtime_rhs = max[5];
+  result.wtime_invert = max[6];
+  result.wtime_comms = max[7];
+  result.wtime_io = max[8];
+  result.calculateDerivedMetrics();
+  return result;
+}
+
 void RunMetrics::calculateDerivedMetrics() {
   // Terrible hack avoid divide-by-zero, needed because SLEPc solver
   // doesn't call `run_rhs` which increments `ncalls`. Better fix is
@@ -1046,3 +1184,156 @@ void RunMetrics::writeProgress(BoutReal simtime, bool output_split) {
                               / wtime); // Everything else
   }
 }
+
+namespace {
+/// Replace characters which can't be used in an output variable name
+std::string outputName(std::string name) {
+  std::replace_if(
+      name.begin(), name.end(),
+      [](char c) { return std::isalnum(static_cast<unsigned char>(c)) == 0; }, '_');
+  return name;
+}
+
+/// Names of the timers on any processor in \p comm
+std::set<std::string> allTimerNames(MPI_Comm comm) {
+  // Send the names as one string, separated by newlines
+  std::string local_names;
+  for (const auto& it : Timer::getAllInfo()) {
+    if (not it.first.empty()) {
+      local_names += it.first + '\n';
+    }
+  }
+
+  int nprocs = 0;
+  bout::globals::mpi->MPI_Comm_size(comm, &nprocs);
+
+  const int local_length = static_cast<int>(local_names.size());
+  std::vector<int> lengths(nprocs);
+  bout::globals::mpi->MPI_Allgather(&local_length, 1, MPI_INT, lengths.data(), 1,
+                                    MPI_INT, comm);
+
+  std::vector<int> offsets(nprocs + 1, 0);
+  std::partial_sum(lengths.begin(), lengths.end(), offsets.begin() + 1);
+
+  std::string names(offsets[nprocs], '\n');
+  bout::globals::mpi->MPI_Allgatherv(local_names.data(), local_length, MPI_CHAR,
+                                     &names[0], lengths.data(), offsets.data(),
+                                     MPI_CHAR, comm);
+
+  std::set<std::string> result;
+  std::istringstream stream(names);
+  for (std::string name; std::getline(stream, name);) {
+    result.insert(name);
+  }
+  return result;
+}
+} // namespace
+
+void TimerImbalance::gather(Mesh& mesh) {
+  Timer time("io");
+
+  MPI_Comm comm = BoutComm::get();
+  int nprocs = 0;
+  bout::globals::mpi->MPI_Comm_size(comm, &nprocs);
+
+  if (local_nx.empty()) {
+    // The grid doesn't change, so only needs gathering once
+    const std::vector<int> local{mesh.xend - mesh.xstart + 1, mesh.yend - mesh.ystart + 1,
+                                 mesh.LocalNz, mesh.getXProcIndex(),
+                                 mesh.getYProcIndex()};
+    const int nvalues = static_cast<int>(local.size());
+    std::vector<int> all(nvalues * nprocs);
+    bout::globals::mpi->MPI_Allgather(local.data(), nvalues, MPI_INT, all.data(),
+                                      nvalues, MPI_INT, comm);
+
+    for (auto* values : {&local_nx, &local_ny, &local_nz, &pe_xind, &pe_yind}) {
+      values->resize(nprocs);
+    }
+    for (int proc = 0; proc < nprocs; ++proc) {
+      local_nx[proc] = all[(proc * nvalues) + 0];
+      local_ny[proc] = all[(proc * nvalues) + 1];
+      local_nz[proc] = all[(proc * nvalues) + 2];
+      pe_xind[proc] = all[(proc * nvalues) + 3];
+      pe_yind[proc] = all[(proc * nvalues) + 4];
+    }
+  }
+
+  // All processors must reduce the same timers, in the same order
+  const auto names = allTimerNames(comm);
+  const auto local_timers = Timer::getAllInfo();
+
+  const int ntimers = static_cast<int>(names.size());
+  std::vector<BoutReal> times(ntimers, 0.0);
+  int index = 0;
+  for (const auto& name : names) {
+    if (local_timers.count(name) > 0) {
+      const BoutReal total = Timer::getTotalTime(name);
+      times[index] = total - previous_total[name];
+      previous_total[name] = total;
+    }
+    ++index;
+  }
+
+  std::vector<BoutReal> min(ntimers), sum(ntimers);
+  bout::globals::mpi->MPI_Allreduce(times.data(), min.data(), ntimers, MPI_DOUBLE,
+                                    MPI_MIN, comm);
+  bout::globals::mpi->MPI_Allreduce(times.data(), sum.data(), ntimers, MPI_DOUBLE,
+                                    MPI_SUM, comm);
+
+  // Layout needed by MPI_MAXLOC
+  struct TimeRank {
+    double time;
+    int rank;
+  };
+  int rank = 0;
+  bout::globals::mpi->MPI_Comm_rank(comm, &rank);
+  std::vector<TimeRank> local_max(ntimers), max(ntimers);
+  for (int i = 0; i < ntimers; ++i) {
+    local_max[i] = {times[i], rank};
+  }
+  bout::globals::mpi->MPI_Allreduce(local_max.data(), max.data(), ntimers,
+                                    MPI_DOUBLE_INT, MPI_MAXLOC, comm);
+
+  timers.clear();
+  index = 0;
+  for (const auto& name : names) {
+    timers[name] = {min[index], sum[index] / nprocs, max[index].time, max[index].rank};
+    ++index;
+  }
+}
+
+void TimerImbalance::outputVars(Options& output_options) const {
+  Timer time("io");
+  auto& section = output_options["timing_imbalance"];
+
+  // Timer which each output name was used for, to catch names which
+  // only differ in the replaced characters
+  std::map<std::string, std::string> used_names;
+  for (const auto& it : timers) {
+    const auto name = outputName(it.first);
+    const auto used = used_names.emplace(name, it.first);
+    if (not used.second) {
+      throw BoutException("Timers '{:s}' and '{:s}' have the same output name '{:s}'",
+                          used.first->second, it.first, name);
+    }
+    auto& timer = section[name];
+    timer["min"].assignRepeat(it.second.min, "t", true, "Output");
+    timer["mean"].assignRepeat(it.second.mean, "t", true, "Output");
+    timer["max"].assignRepeat(it.second.max, "t", true, "Output");
+    timer["max_rank"].assignRepeat(it.second.max_rank, "t", true, "Output");
+  }
+
+  // Options can't store integer arrays. Each value is indexed by rank
+  const auto setArray = [&section](const std::string& name,
+                                   const std::vector<int>& values) {
+    Array<BoutReal> result(static_cast<int>(values.size()));
+    std::copy(values.begin(), values.end(), result.begin());
+    section[name].force(result, "Output");
+    section[name].attributes["array_dimension"] = "rank";
+  };
+  setArray("local_nx", local_nx);
+  setArray("local_ny", local_ny);
+  setArray("local_nz", local_nz);
+  setArray("pe_xind", pe_xind);
+  setArray("pe_yind", pe_yind);
+}
@@ -617,25 +617,31 @@ Field3D filter(const Field3D& var, int N0, const std::string& rgn) {
           || region_str == "RGN_NOX" || region_str == "RGN_NOY");
 
   const Region<Ind2D>& region = var.getRegion2D(region_str);
+  const int nmodes = (ncz / 2) + 1;
 
-  BOUT_OMP(parallel)
-  {
-    Array<dcomplex> f(ncz / 2 + 1);
+  // Each contiguous block of the 2D region is a contiguous set of Z
+  // pencils, so can be transformed with a single batched FFT
+  BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+  for (auto block = region.getBlocks().cbegin(); block < region.getBlocks().cend();
+       ++block) {
+    const int npencils = block->second.ind - block->first.ind;
+    Matrix<dcomplex> f(npencils, nmodes);
 
-    BOUT_FOR_INNER(i, region) {
-      // Forward FFT
-      rfft(var(i.x(), i.y()), ncz, f.begin());
+    // Forward FFT
+    bout::fft::rfft_many(&var(block->first, 0), ncz, npencils, ncz, &f(0, 0), nmodes);
 
-      for (int jz = 0; jz <= ncz / 2; jz++) {
+    for (int i = 0; i < npencils; i++) {
+      for (int jz = 0; jz < nmodes; jz++) {
         if (jz != N0) {
           // Zero this component
-          f[jz] = 0.0;
+          f(i, jz) = 0.0;
         }
       }
-
-      // Reverse FFT
-      irfft(f.begin(), ncz, result(i.x(), i.y()));
     }
+
+    // Reverse FFT
+    bout::fft::irfft_many(&f(0, 0), ncz, npencils, nmodes, &result(block->first, 0),
+                          ncz);
   }
 
 #if BOUT_USE_TRACK
@@ -667,27 +673,33 @@ Field3D lowPass(const Field3D& var, int zmax, bool keep_zonal, const std::string
           || region_str == "RGN_NOX" || region_str == "RGN_NOY");
 
   const Region<Ind2D>& region = var.getRegion2D(region_str);
+  const int nmodes = (ncz / 2) + 1;
 
-  BOUT_OMP(parallel)
-  {
-    Array<dcomplex> f(ncz / 2 + 1);
+  // Transform each contiguous block of Z pencils with a single batched FFT
+  BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+  for (auto block = region.getBlocks().cbegin(); block < region.getBlocks().cend();
+       ++block) {
+    const int npencils = block->second.ind - block->first.ind;
+    Matrix<dcomplex> f(npencils, nmodes);
 
-    BOUT_FOR_INNER(i, region) {
-      // Take FFT in the Z direction
-      rfft(var(i.x(), i.y()), ncz, f.begin());
+    // Take FFT in the Z direction
+    bout::fft::rfft_many(&var(block->first, 0), ncz, npencils, ncz, &f(0, 0), nmodes);
 
+    for (int i = 0; i < npencils; i++) {
       // Filter in z
-      for (int jz = zmax + 1; jz <= ncz / 2; jz++) {
-        f[jz] = 0.0;
+      for (int jz = zmax + 1; jz < nmodes; jz++) {
+        f(i, jz) = 0.0;
       }
 
       // Filter zonal mode
       if (!keep_zonal) {
-        f[0] = 0.0;
+        f(i, 0) = 0.0;
       }
-      // Reverse FFT
-      irfft(f.begin(), ncz, result(i.x(), i.y()));
     }
+
+    // Reverse FFT
+    bout::fft::irfft_many(&f(0, 0), ncz, npencils, nmodes, &result(block->first, 0),
+                          ncz);
   }
 
   checkData(result);
@@ -23,7 +23,9 @@
 
 #include <bout/field_factory.hxx>
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include <bout/constants.hxx>
 #include <bout/output.hxx>
@@ -34,6 +36,7 @@
 #include "fieldgenerators.hxx"
 
 using bout::generator::Context;
+using bout::generator::Program;
 
 /// Helper function to create a FieldValue generator from a BoutReal
 FieldGeneratorPtr generator(BoutReal value) {
@@ -80,6 +83,16 @@ private:
 
   FieldGeneratorPtr target;
 };
+
+/// The z coordinate along a line of points at cell location \p loc,
+/// as seen by generators through Context::z()
+std::vector<BoutReal> zValues(Mesh* localmesh, CELL_LOC loc, BoutReal t) {
+  std::vector<BoutReal> z(localmesh->LocalNz);
+  for (int iz = 0; iz < localmesh->LocalNz; ++iz) {
+    z[iz] = Context(0, 0, iz, loc, localmesh, t).z();
+  }
+  return z;
+}
 } // namespace
 
 //////////////////////////////////////////////////////////
@@ -110,6 +123,19 @@ FieldFactory::FieldFactory(Mesh* localmesh, Options* opt)
         nonconst_options["input"]["max_recursion_depth"].as<std::string>());
   }
 
+  try {
+    max_hoisted_cache_size = std::stoul(
+        nonconst_options["input"]["max_hoisted_cache_size"]
+            .doc("Maximum number of values to store for the time-independent parts "
+                 "of time-dependent expressions, summed over all expressions. 0 = "
+                 "don't store")
+            .withDefault<std::string>("16777216"));
+  } catch (const std::exception&) {
+    throw ParseException(
+        "Invalid integer given as input:max_hoisted_cache_size: '{:s}'",
+        nonconst_options["input"]["max_hoisted_cache_size"].as<std::string>());
+  }
+
   // Useful values
   addGenerator("pi", std::make_shared<FieldValue>(PI));
   addGenerator("π", std::make_shared<FieldValue>(PI));
@@ -215,9 +241,35 @@ Field3D FieldFactory::create3D(FieldGeneratorPtr gen, Mesh* localmesh, CELL_LOC
 
   auto result = Field3D(localmesh).setLocation(loc).setDirectionY(y_direction).allocate();
 
-  BOUT_FOR(i, result.getRegion("RGN_ALL")) {
-    result[i] = gen->generate(Context(i, loc, localmesh, t));
-  };
+  const Program program{*gen};
+  if (program.valid()) {
+    // Evaluate the compiled expression along whole lines in z
+    const auto z = zValues(localmesh, loc, t);
+    const int nz = localmesh->LocalNz;
+    const int ny = localmesh->LocalNy;
+
+    // Only the time-dependent part is evaluated if the rest is cached
+    const std::size_t line_size = program.numHoisted() * nz;
+    const BoutReal* hoisted =
+        (line_size > 0) ? hoistedValues(gen, program, z, localmesh, loc) : nullptr;
+
+    BOUT_OMP(parallel) {
+      std::vector<BoutReal> workspace;
+      BOUT_OMP(for)
+      for (int ixy = 0; ixy < localmesh->LocalNx * ny; ++ixy) {
+        const int ix = ixy / ny;
+        const int iy = ixy % ny;
+        const Context line(ix, iy, 0, loc, localmesh, t);
+        program.evaluate(line.x(), line.y(), z.data(), t, nz, &result(ix, iy, 0),
+                         workspace,
+                         (hoisted == nullptr) ? nullptr : hoisted + (ixy * line_size));
+      }
+    }
+  } else {
+    BOUT_FOR(i, result.getRegion("RGN_ALL")) {
+      result[i] = gen->generate(Context(i, loc, localmesh, t));
+    };
+  }
 
   if (transform_from_field_aligned) {
     auto coords = result.getCoordinates();
@@ -267,9 +319,24 @@ FieldPerp FieldFactory::createPerp(FieldGeneratorPtr gen, Mesh* localmesh, CELL_
   auto result =
       FieldPerp(localmesh).setLocation(loc).setDirectionY(y_direction).allocate();
 
-  BOUT_FOR(i, result.getRegion("RGN_ALL")) {
-    result[i] = gen->generate(Context(i, loc, localmesh, t));
-  };
+  const Program program{*gen};
+  if (program.valid()) {
+    const auto z = zValues(localmesh, loc, t);
+    const int nz = localmesh->LocalNz;
+    BOUT_OMP(parallel) {
+      std::vector<BoutReal> workspace;
+      BOUT_OMP(for)
+      for (int ix = 0; ix < localmesh->LocalNx; ++ix) {
+        // Same as Context(IndPerp), which always has y index 0
+        const Context line(ix, 0, 0, loc, localmesh, t);
+        program.evaluate(line.x(), line.y(), z.data(), t, nz, &result(ix, 0), workspace);
+      }
+    }
+  } else {
+    BOUT_FOR(i, result.getRegion("RGN_ALL")) {
+      result[i] = gen->generate(Context(i, loc, localmesh, t));
+    };
+  }
 
   if (transform_from_field_aligned) {
     auto coords = result.getCoordinates();
@@ -291,6 +358,64 @@ FieldPerp FieldFactory::createPerp(FieldGeneratorPtr gen, Mesh* localmesh, CELL_
   return result;
 }
 
+const BoutReal* FieldFactory::hoistedValues(const FieldGeneratorPtr& gen,
+                                            const Program& program,
+                                            const std::vector<BoutReal>& z,
+                                            Mesh* localmesh, CELL_LOC loc) const {
+  const int nx = localmesh->LocalNx;
+  const int ny = localmesh->LocalNy;
+  const int nz = localmesh->LocalNz;
+  const std::size_t line_size = program.numHoisted() * nz;
+  const std::size_t size = line_size * nx * ny;
+
+  if (size > max_hoisted_cache_size) {
+    // Too big to store, so the whole program is evaluated every time
+    return nullptr;
+  }
+
+  const HoistedKey key{gen, localmesh, loc};
+  auto existing = hoisted_cache.find(key);
+  if (existing != hoisted_cache.end()) {
+    auto& cached = existing->second;
+    if ((cached.nx == nx) and (cached.ny == ny) and (cached.nz == nz)) {
+      cached.last_used = ++hoisted_cache_uses;
+      return cached.values.data();
+    }
+    // The mesh has changed size
+    hoisted_cache_size -= cached.values.size();
+    hoisted_cache.erase(existing);
+  }
+
+  // Make room by removing the least recently used values
+  while (hoisted_cache_size + size > max_hoisted_cache_size) {
+    auto oldest = std::min_element(hoisted_cache.begin(), hoisted_cache.end(),
+                                   [](const auto& lhs, const auto& rhs) {
+                                     return lhs.second.last_used < rhs.second.last_used;
+                                   });
+    hoisted_cache_size -= oldest->second.values.size();
+    hoisted_cache.erase(oldest);
+  }
+
+  auto& cached = hoisted_cache[key];
+  cached.nx = nx;
+  cached.ny = ny;
+  cached.nz = nz;
+  cached.last_used = ++hoisted_cache_uses;
+  cached.values.resize(size);
+  hoisted_cache_size += size;
+
+  BOUT_OMP(parallel) {
+    std::vector<BoutReal> workspace;
+    BOUT_OMP(for)
+    for (int ixy = 0; ixy < nx * ny; ++ixy) {
+      const Context line(ixy / ny, ixy % ny, 0, loc, localmesh, 0.0);
+      program.evaluateHoisted(line.x(), line.y(), z.data(), nz,
+                              cached.values.data() + (ixy * line_size), workspace);
+    }
+  }
+  return cached.values.data();
+}
+
 const Options* FieldFactory::findOption(const Options* opt, const std::string& name,
                                         std::string& val) const {
   const Options* result = opt;
@@ -465,4 +590,8 @@ FieldFactory* FieldFactory::get() {
   return &instance;
 }
 
-void FieldFactory::cleanCache() { cache.clear(); }
+void FieldFactory::cleanCache() {
+  cache.clear();
+  hoisted_cache.clear();
+  hoisted_cache_size = 0;
+}
@@ -25,6 +25,10 @@ public:
     return std::make_shared<FieldValuePtr>(ptr);
   }
   BoutReal generate(const bout::generator::Context&) override { return *ptr; }
+  bout::generator::Program::Register
+  compile(bout::generator::Program& program) const override {
+    return program.pointer(ptr);
+  }
 
 private:
   BoutReal* ptr;
@@ -50,6 +54,10 @@ public:
   BoutReal generate(const bout::generator::Context& pos) override {
     return Op(gen->generate(pos));
   }
+  bout::generator::Program::Register
+  compile(bout::generator::Program& program) const override {
+    return program.call(Op, gen->compile(program));
+  }
   std::string str() const override {
     return name + std::string("(") + gen->str() + std::string(")");
   }
@@ -77,6 +85,12 @@ public:
   BoutReal generate(const bout::generator::Context& pos) override {
     return Op(A->generate(pos), B->generate(pos));
   }
+  bout::generator::Program::Register
+  compile(bout::generator::Program& program) const override {
+    // Arguments in order, so that constant arguments can be folded
+    const auto a_reg = A->compile(program);
+    return program.call(Op, a_reg, B->compile(program));
+  }
   std::string str() const override {
     return name + std::string("(") + A->str() + "," + B->str() + std::string(")");
   }
@@ -106,6 +120,17 @@ public:
     }
     return atan2(A->generate(pos), B->generate(pos));
   }
+  bout::generator::Program::Register
+  compile(bout::generator::Program& program) const override {
+    using Program = bout::generator::Program;
+    if (B == nullptr) {
+      return program.call(static_cast<Program::single_arg_op>(atan),
+                          A->compile(program));
+    }
+    const auto a_reg = A->compile(program);
+    return program.call(static_cast<Program::double_arg_op>(atan2), a_reg,
+                        B->compile(program));
+  }
 
 private:
   FieldGeneratorPtr A, B;
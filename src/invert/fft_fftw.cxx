@@ -30,18 +30,28 @@
 #include <bout/fft.hxx>
 #include <bout/globals.hxx>
 #include <bout/options.hxx>
+#include <bout/output.hxx>
 #include <bout/unused.hxx>
 
+#include <string>
+
 #if BOUT_HAS_FFTW
+#include <bout/boutcomm.hxx>
 #include <bout/constants.hxx>
+#include <bout/mpi_wrapper.hxx>
 #include <bout/openmpwrap.hxx>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <fftw3.h>
-
-#if BOUT_USE_OPENMP
-#include <omp.h>
-#endif // _OPENMP
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <tuple>
+#include <vector>
 #else
 #include <bout/boutexception.hxx>
 #endif // BOUT_HAS_FFTW
@@ -101,291 +111,358 @@ void fft_init(bool fft_measure) {
 }
 
 /***********************************************************
- * Real FFTs
+ * FFTW wisdom
  ***********************************************************/
 
-#if !BOUT_USE_OPENMP
-// Serial code
-void rfft(MAYBE_UNUSED(const BoutReal* in), MAYBE_UNUSED(int length),
-          MAYBE_UNUSED(dcomplex* out)) {
-#if !BOUT_HAS_FFTW
-  throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
-#else
-  // static variables initialized once
-  static double* fin;
-  static fftw_complex* fout;
-  static fftw_plan p;
-  static int n = 0;
-
-  // If the current length mismatches n
-  if (length != n) {
-    // If n has been used before
-    if (n > 0) {
-      // Free the previously initialized data
-      fftw_destroy_plan(p);
-      fftw_free(fin);
-      fftw_free(fout);
-    }
-
-    fft_init();
+namespace {
+/// File to save FFTW wisdom to at the end of the run. Empty if not
+/// set by `fft_import_wisdom`
+std::string fftw_wisdom_file;
+} // namespace
 
-    // Initialize the input for the fourier transformation
-    fin = static_cast<double*>(fftw_malloc(sizeof(double) * length));
-    // Initialize the output of the fourier transformation
-    /* NOTE: Only the non-redundant output is given
-     *       I.e the offset and the positive frequencies (so no mirroring
-     *       around the Nyquist frequency)
-     */
-    fout =
-        static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1)));
-
-    auto flags = get_measurement_flag(fft_measurement_flag);
-
-    /* fftw call
-     * Plan a real-input/complex-output discrete Fourier transform (DFT)
-     * in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
-     * r2c = real to complex
-     */
-    p = fftw_plan_dft_r2c_1d(length, fin, fout, flags);
-
-    n = length;
+void fft_import_wisdom(Options* options) {
+  if (options == nullptr) {
+    options = Options::getRoot()->getSection("fft");
+  }
+  const auto wisdom_file =
+      (*options)["fftw_wisdom_file"]
+          .doc("File to read FFTW wisdom from at startup, and write it to at the end "
+               "of the run. Useful with fft_measurement_flag = measure or exhaustive, "
+               "so that plans don't have to be measured again on every restart. Empty "
+               "to disable")
+          .withDefault<std::string>("");
+
+  if (wisdom_file.empty()) {
+    return;
   }
 
-  // Put the input to fin
-  for (int i = 0; i < n; i++) {
-    fin[i] = in[i];
+#if BOUT_HAS_FFTW
+  fftw_wisdom_file = wisdom_file;
+
+  // Read on one processor only, and broadcast to everyone else, to
+  // avoid hammering the filesystem
+  std::string wisdom;
+  if (BoutComm::rank() == 0) {
+    std::ifstream wisdom_stream(wisdom_file);
+    if (wisdom_stream.good()) {
+      std::stringstream buffer;
+      buffer << wisdom_stream.rdbuf();
+      wisdom = buffer.str();
+    } else {
+      output_info.write("No FFTW wisdom found in '{:s}', will create it\n", wisdom_file);
+    }
   }
 
-  // fftw call executing the fft
-  fftw_execute(p);
+  int wisdom_size = static_cast<int>(wisdom.size());
+  bout::globals::mpi->MPI_Bcast(&wisdom_size, 1, MPI_INT, 0, BoutComm::get());
 
-  //Normalising factor
-  const BoutReal fac = 1.0 / n;
-  const int nmodes = (n / 2) + 1;
+  if (wisdom_size == 0) {
+    return;
+  }
 
-  // Store the output in out, and normalize
-  for (int i = 0; i < nmodes; i++) {
-    out[i] = dcomplex(fout[i][0], fout[i][1]) * fac; // Normalise
+  wisdom.resize(wisdom_size);
+  bout::globals::mpi->MPI_Bcast(&wisdom[0], wisdom_size, MPI_CHAR, 0,
+                                BoutComm::get());
+
+  if (fftw_import_wisdom_from_string(wisdom.c_str()) == 0) {
+    output_warn.write("Could not import FFTW wisdom from '{:s}', ignoring\n",
+                      wisdom_file);
+  } else {
+    output_info.write("Imported FFTW wisdom from '{:s}'\n", wisdom_file);
   }
+#else
+  output_warn.write("Ignoring fft:fftw_wisdom_file as BOUT++ was compiled without FFTW\n");
 #endif
 }
 
-void irfft(MAYBE_UNUSED(const dcomplex* in), MAYBE_UNUSED(int length),
-           MAYBE_UNUSED(BoutReal* out)) {
-#if !BOUT_HAS_FFTW
-  throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
-#else
-  // static variables initialized once
-  static fftw_complex* fin;
-  static double* fout;
-  static fftw_plan p;
-  static int n = 0;
-
-  // If the current length mismatches n
-  if (length != n) {
-    // If n has been used before
-    if (n > 0) {
-      // Free the previously initialized data
-      fftw_destroy_plan(p);
-      fftw_free(fin);
-      fftw_free(fout);
+void fft_export_wisdom() {
+#if BOUT_HAS_FFTW
+  if (fftw_wisdom_file.empty()) {
+    return;
+  }
+
+  // Different ranks may have planned different transforms, for
+  // example batched transforms on boundary processors, so collect all
+  // the wisdom on rank 0
+  std::unique_ptr<char, decltype(&free)> local_wisdom{fftw_export_wisdom_to_string(),
+                                                      &free};
+  const int local_size =
+      (local_wisdom == nullptr) ? 0 : static_cast<int>(std::strlen(local_wisdom.get()));
+
+  const int nprocs = BoutComm::size();
+  const int myrank = BoutComm::rank();
+  std::vector<int> sizes(myrank == 0 ? nprocs : 0);
+  bout::globals::mpi->MPI_Gather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0,
+                                 BoutComm::get());
+
+  std::vector<int> offsets(sizes.size(), 0);
+  std::vector<char> all_wisdom;
+  if (myrank == 0) {
+    for (int proc = 1; proc < nprocs; ++proc) {
+      offsets[proc] = offsets[proc - 1] + sizes[proc - 1];
     }
+    all_wisdom.resize(offsets.back() + sizes.back());
+  }
 
-    fft_init();
+  bout::globals::mpi->MPI_Gatherv(local_wisdom.get(), local_size, MPI_CHAR,
+                                  all_wisdom.data(), sizes.data(), offsets.data(),
+                                  MPI_CHAR, 0, BoutComm::get());
 
-    // Initilaize the input for the inverse fourier transformation
-    /* NOTE: Only the non-redundant input is given
-     *       I.e the offset and the positive frequencies (so no mirroring
-     *       around the Nyquist frequency)
-     */
-    fin =
-        static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1)));
-    // Initialize the output of the fourier transformation
-    fout = static_cast<double*>(fftw_malloc(sizeof(double) * length));
-
-    auto flags = get_measurement_flag(fft_measurement_flag);
-
-    /* fftw call
-     * Plan a complex-input/real-output discrete Fourier transform (DFT)
-     * in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
-     * c2r = complex to real
-     */
-    p = fftw_plan_dft_c2r_1d(length, fin, fout, flags);
-
-    n = length;
+  if (myrank != 0) {
+    return;
   }
 
-  // Store the real and imaginary parts in the proper way
-  const int nmodes = (n / 2) + 1;
-  for (int i = 0; i < nmodes; i++) {
-    fin[i][0] = in[i].real();
-    fin[i][1] = in[i].imag();
+  // Merge wisdom from the other ranks into ours. Rank 0's own
+  // wisdom is already loaded
+  for (int proc = 1; proc < nprocs; ++proc) {
+    if (sizes[proc] == 0) {
+      continue;
+    }
+    const std::string wisdom(all_wisdom.data() + offsets[proc], sizes[proc]);
+    fftw_import_wisdom_from_string(wisdom.c_str());
   }
 
-  // fftw call executing the fft
-  fftw_execute(p);
-
-  // Store the output of the fftw to the out
-  for (int i = 0; i < n; i++) {
-    out[i] = fout[i];
+  if (fftw_export_wisdom_to_filename(fftw_wisdom_file.c_str()) == 0) {
+    output_warn.write("Could not write FFTW wisdom to '{:s}'\n", fftw_wisdom_file);
   }
 #endif
 }
-#else
-// Parallel thread-safe version of rfft and irfft
-void rfft(MAYBE_UNUSED(const BoutReal* in), MAYBE_UNUSED(int length),
-          MAYBE_UNUSED(dcomplex* out)) {
-#if !BOUT_HAS_FFTW
-  throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
-#else
-  // ensure we are not nested
-  ASSERT1(omp_get_active_level() < 2);
-  static double* finall;
-  static fftw_complex* foutall;
-  static fftw_plan* p;
-  static int size = 0, nthreads = 0;
-
-  int th_id = omp_get_thread_num();
-  int n_th = omp_get_num_threads(); // Number of threads
-
-  // Sort out memory. Also, FFTW planning routines not thread safe
-  if ((size != length) || (nthreads < n_th)) {
-    // We make the check to see if the problem size has changed twice
-    // intentionally. The first check ensures we don't pay the cost of
-    // obtaining a lock for the critical section if we don't need to do
-    // any work here. The second check is required to make sure that
-    // only one thread does the actual setup when required. Note we can't
-    // use a `single` block here as that requires all threads to reach the
-    // block (implicit barrier) which may not be true in all cases (e.g.
-    // if there are 8 threads but only 4 call the fft routine).
-    BOUT_OMP(critical(rfft))
-    if ((size != length) || (nthreads < n_th)) {
-      if (size > 0) {
-        // Free all memory
-        for (int i = 0; i < nthreads; i++) {
-          fftw_destroy_plan(p[i]);
-        }
-        delete[] p;
-        fftw_free(finall);
-        fftw_free(foutall);
-      }
 
-      fft_init();
+/***********************************************************
+ * Plan registry
+ ***********************************************************/
+
+#if BOUT_HAS_FFTW
+namespace {
+/// Which kind of transform a plan is for
+enum class PlanKind { r2c, c2r };
+
+/// Everything that makes a plan unique: the kind of transform, its
+/// shape (length, howmany, in_dist, out_dist), and the alignment of
+/// the input and output arrays
+using PlanKey = std::tuple<PlanKind, int, int, int, int, int, int>;
+
+/// Deleter for memory allocated with fftw_malloc
+struct FFTWFree {
+  void operator()(void* ptr) const { fftw_free(ptr); }
+};
+
+/// Cache of FFTW plans
+///
+/// Any number of plans can be held at once, so alternating between
+/// different lengths doesn't cause any replanning. Plans are executed
+/// with FFTW's new-array execute functions, which are thread-safe, so
+/// a single plan is shared between all threads, at any level of
+/// OpenMP nesting. Plans are only valid for arrays with the same
+/// alignment as the arrays they were planned with, so the alignment
+/// is part of the key, and SIMD codelets can still be used when the
+/// arrays allow it
+class PlanRegistry {
+public:
+  static PlanRegistry& instance() {
+    static PlanRegistry registry;
+    return registry;
+  }
 
-      finall = static_cast<double*>(fftw_malloc(sizeof(double) * length * n_th));
-      foutall = static_cast<fftw_complex*>(
-          fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1) * n_th));
-      p = new fftw_plan[n_th]; //Never freed
+  /// Get a plan for \p howmany transforms of \p length, creating it if
+  /// this is the first time it is requested
+  fftw_plan get(PlanKind kind, int length, int howmany, int in_dist, int out_dist,
+                int in_align, int out_align) {
+    const PlanKey key{kind, length, howmany, in_dist, out_dist, in_align, out_align};
+
+    fftw_plan plan{nullptr};
+
+    // FFTW planning routines are not thread safe, and we also need to
+    // protect the cache itself
+    BOUT_OMP(critical(fftw_plan_registry))
+    {
+      auto it = plans.find(key);
+      if (it != plans.end()) {
+        plan = it->second;
+      } else {
+        plan = create(kind, length, howmany, in_dist, out_dist, in_align, out_align);
+        if (plan != nullptr) {
+          plans.emplace(key, plan);
+        }
+      }
+    }
 
-      auto flags = get_measurement_flag(fft_measurement_flag);
+    if (plan == nullptr) {
+      throw BoutException(
+          "FFTW could not create a plan for {:d} transforms of length {:d}", howmany,
+          length);
+    }
+    return plan;
+  }
 
-      for (int i = 0; i < n_th; i++) {
-        // fftw call
-        // Plan a real-input/complex-output discrete Fourier transform (DFT)
-        // in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
-        p[i] = fftw_plan_dft_r2c_1d(length, finall + i * length,
-                                    foutall + i * (length / 2 + 1), flags);
+  /// Destroy all the plans
+  void clear() {
+    BOUT_OMP(critical(fftw_plan_registry))
+    {
+      for (auto& it : plans) {
+        fftw_destroy_plan(it.second);
       }
-      size = length;
-      nthreads = n_th;
+      plans.clear();
     }
   }
 
-  // Get working arrays for this thread
-  double* fin = finall + th_id * size;
-  fftw_complex* fout = foutall + th_id * (size / 2 + 1);
+private:
+  std::map<PlanKey, fftw_plan> plans;
+
+  static fftw_plan create(PlanKind kind, int length, int howmany, int in_dist,
+                          int out_dist, int in_align, int out_align) {
+    fft_init();
 
-  for (int i = 0; i < size; i++) {
-    fin[i] = in[i];
+    const bool forward = kind == PlanKind::r2c;
+    const int nmodes = (length / 2) + 1;
+    const auto flags = get_measurement_flag(fft_measurement_flag);
+
+    // Scratch arrays just for planning, as the arrays may be
+    // overwritten when measuring. These are offset from the
+    // (maximally aligned) allocation so that they have the same
+    // alignment as the arrays the plan will be executed on
+    const int real_size = ((howmany - 1) * (forward ? in_dist : out_dist)) + length;
+    const int complex_size = ((howmany - 1) * (forward ? out_dist : in_dist)) + nmodes;
+    const int real_align = forward ? in_align : out_align;
+    const int complex_align = forward ? out_align : in_align;
+
+    std::unique_ptr<char, FFTWFree> real_buffer{static_cast<char*>(
+        fftw_malloc((sizeof(double) * real_size) + real_align))};
+    std::unique_ptr<char, FFTWFree> complex_buffer{static_cast<char*>(
+        fftw_malloc((sizeof(fftw_complex) * complex_size) + complex_align))};
+
+    auto* real_data = reinterpret_cast<double*>(real_buffer.get() + real_align);
+    auto* complex_data =
+        reinterpret_cast<fftw_complex*>(complex_buffer.get() + complex_align);
+
+    if (forward) {
+      return fftw_plan_many_dft_r2c(1, &length, howmany, real_data, nullptr, 1, in_dist,
+                                    complex_data, nullptr, 1, out_dist, flags);
+    }
+    return fftw_plan_many_dft_c2r(1, &length, howmany, complex_data, nullptr, 1,
+                                  in_dist, real_data, nullptr, 1, out_dist, flags);
+  }
+};
+
+/// Aligned working memory for the calling thread, of at least \p size
+/// elements. Each thread, including those in nested parallel regions,
+/// has its own buffer for each type, which is freed when the thread exits
+template <typename T>
+T* thread_scratch(int size) {
+  thread_local std::unique_ptr<T, FFTWFree> buffer{nullptr};
+  thread_local int capacity{0};
+  if (size > capacity) {
+    buffer.reset(static_cast<T*>(fftw_malloc(sizeof(T) * size)));
+    capacity = size;
   }
+  return buffer.get();
+}
 
-  // fftw call executing the fft
-  fftw_execute(p[th_id]);
+int alignment_of(const BoutReal* ptr) {
+  return fftw_alignment_of(const_cast<BoutReal*>(ptr)); // NOLINT
+}
+int alignment_of(const dcomplex* ptr) {
+  return alignment_of(reinterpret_cast<const BoutReal*>(ptr));
+}
 
-  //Normalising factor
-  const BoutReal fac = 1.0 / static_cast<BoutReal>(size);
-  const int nmodes = (size / 2) + 1;
+/// Execute \p howmany real-to-complex transforms, without normalising
+void execute_r2c(const BoutReal* in, int length, int howmany, int in_dist,
+                 dcomplex* out, int out_dist) {
+  auto plan = PlanRegistry::instance().get(PlanKind::r2c, length, howmany, in_dist,
+                                           out_dist, alignment_of(in), alignment_of(out));
+
+  // Out-of-place real-to-complex transforms preserve their input,
+  // so we can safely cast away the const here. std::complex is
+  // guaranteed to be layout-compatible with fftw_complex
+  fftw_execute_dft_r2c(plan, const_cast<BoutReal*>(in), // NOLINT
+                       reinterpret_cast<fftw_complex*>(out));
+}
 
-  for (int i = 0; i < nmodes; i++) {
-    out[i] = dcomplex(fout[i][0], fout[i][1]) * fac; // Normalise
-  }
+/// Execute \p howmany complex-to-real transforms. Note that \p in is
+/// overwritten!
+void execute_c2r(dcomplex* in, int length, int howmany, int in_dist, BoutReal* out,
+                 int out_dist) {
+  auto plan = PlanRegistry::instance().get(PlanKind::c2r, length, howmany, in_dist,
+                                           out_dist, alignment_of(in), alignment_of(out));
+  fftw_execute_dft_c2r(plan, reinterpret_cast<fftw_complex*>(in), out);
+}
+} // namespace
+#endif
+
+void fft_cleanup() {
+#if BOUT_HAS_FFTW
+  PlanRegistry::instance().clear();
+  fftw_cleanup();
 #endif
 }
 
-void irfft(MAYBE_UNUSED(const dcomplex* in), MAYBE_UNUSED(int length),
-           MAYBE_UNUSED(BoutReal* out)) {
+/***********************************************************
+ * Real FFTs
+ ***********************************************************/
+
+void rfft(const BoutReal* in, int length, dcomplex* out) {
+  rfft_many(in, length, 1, length, out, (length / 2) + 1);
+}
+
+void irfft(const dcomplex* in, int length, BoutReal* out) {
+  irfft_many(in, length, 1, (length / 2) + 1, out, length);
+}
+
+void rfft_many(MAYBE_UNUSED(const BoutReal* in), MAYBE_UNUSED(int length),
+               MAYBE_UNUSED(int howmany), MAYBE_UNUSED(int in_dist),
+               MAYBE_UNUSED(dcomplex* out), MAYBE_UNUSED(int out_dist)) {
 #if !BOUT_HAS_FFTW
   throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
 #else
-  static fftw_complex* finall;
-  static double* foutall;
-  static fftw_plan* p;
-  static int size = 0, nthreads = 0;
-
-  int th_id = omp_get_thread_num();
-  int n_th = omp_get_num_threads(); // Number of threads
-
-  // Sort out memory. Also, FFTW planning routines not thread safe
-  if ((size != length) || (nthreads < n_th)) {
-    // We make the check to see if the problem size has changed twice
-    // intentionally. The first check ensures we don't pay the cost of
-    // obtaining a lock for the critical section if we don't need to do
-    // any work here. The second check is required to make sure that
-    // only one thread does the actual setup when required. Note we can't
-    // use a `single` block here as that requires all threads to reach the
-    // block (implicit barrier) which may not be true in all cases (e.g.
-    // if there are 8 threads but only 4 call the fft routine).
-    BOUT_OMP(critical(irfft))
-    if ((size != length) || (nthreads < n_th)) {
-      if (size > 0) {
-        // Free all memory
-        for (int i = 0; i < nthreads; i++) {
-          fftw_destroy_plan(p[i]);
-        }
-        delete[] p;
-        fftw_free(finall);
-        fftw_free(foutall);
-      }
-
-      fft_init();
-
-      finall = static_cast<fftw_complex*>(
-          fftw_malloc(sizeof(fftw_complex) * (length / 2 + 1) * n_th));
-      foutall = static_cast<double*>(fftw_malloc(sizeof(double) * length * n_th));
+  ASSERT1(length > 0);
+  ASSERT1(in_dist >= length);
+  ASSERT1(out_dist >= (length / 2) + 1);
 
-      p = new fftw_plan[n_th]; // Never freed
+  if (howmany <= 0) {
+    return;
+  }
 
-      auto flags = get_measurement_flag(fft_measurement_flag);
+  execute_r2c(in, length, howmany, in_dist, out, out_dist);
 
-      for (int i = 0; i < n_th; i++) {
-        p[i] = fftw_plan_dft_c2r_1d(length, finall + i * (length / 2 + 1),
-                                    foutall + i * length, flags);
-      }
-      size = length;
-      nthreads = n_th;
+  // Normalise
+  const BoutReal fac = 1.0 / static_cast<BoutReal>(length);
+  const int nmodes = (length / 2) + 1;
+  for (int i = 0; i < howmany; i++) {
+    dcomplex* out_i = out + (i * out_dist);
+    for (int k = 0; k < nmodes; k++) {
+      out_i[k] *= fac;
     }
   }
+#endif
+}
 
-  // Get working arrays for this thread
-  fftw_complex* fin = finall + th_id * (size / 2 + 1);
-  double* fout = foutall + th_id * size;
-
-  const int nmodes = (size / 2) + 1;
+void irfft_many(MAYBE_UNUSED(const dcomplex* in), MAYBE_UNUSED(int length),
+                MAYBE_UNUSED(int howmany), MAYBE_UNUSED(int in_dist),
+                MAYBE_UNUSED(BoutReal* out), MAYBE_UNUSED(int out_dist)) {
+#if !BOUT_HAS_FFTW
+  throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
+#else
+  ASSERT1(length > 0);
+  ASSERT1(in_dist >= (length / 2) + 1);
+  ASSERT1(out_dist >= length);
 
-  for (int i = 0; i < nmodes; i++) {
-    fin[i][0] = in[i].real();
-    fin[i][1] = in[i].imag();
+  if (howmany <= 0) {
+    return;
   }
 
-  // fftw call executing the fft
-  fftw_execute(p[th_id]);
+  const int nmodes = (length / 2) + 1;
 
-  for (int i = 0; i < size; i++) {
-    out[i] = fout[i];
+  // Complex-to-real transforms destroy their input, so work on a
+  // packed copy. Note the plan is for this packed layout
+  dcomplex* work = thread_scratch<dcomplex>(howmany * nmodes);
+  for (int i = 0; i < howmany; i++) {
+    std::copy(in + (i * in_dist), in + (i * in_dist) + nmodes, work + (i * nmodes));
   }
+
+  execute_c2r(work, length, howmany, nmodes, out, out_dist);
 #endif
 }
-#endif
+
 //  Discrete sine transforms (B Shanahan)
 
 void DST(MAYBE_UNUSED(const BoutReal* in), MAYBE_UNUSED(int length),
@@ -393,55 +470,29 @@ void DST(MAYBE_UNUSED(const BoutReal* in), MAYBE_UNUSED(int length),
 #if !BOUT_HAS_FFTW
   throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
 #else
-  static double* fin;
-  static fftw_complex* fout;
-  static fftw_plan p;
-  static int n = 0;
-
   ASSERT1(length > 0);
 
-  if (length != n) {
-    if (n > 0) {
-      fftw_destroy_plan(p);
-      fftw_free(fin);
-      fftw_free(fout);
-    }
-
-    //  fft_init();
-
-    // Could be optimized better
-    fin = static_cast<double*>(fftw_malloc(sizeof(double) * 2 * length));
-    fout = static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * 2 * length));
-
-    auto flags = get_measurement_flag(fft_measurement_flag);
+  // Transform the odd extension of the input
+  const int n = 2 * (length - 1);
 
-    // fftw call
-    // Plan a real-input/complex-output discrete Fourier transform (DFT)
-    // in 1 dimensions. Returns a fftw_plan (containing pointers etc.)
-    p = fftw_plan_dft_r2c_1d(2 * (length - 1), fin, fout, flags);
-
-    n = length;
-  }
-  for (int i = 0; i < n; i++) {
-    fin[i] = in[i];
-  }
+  auto* fin = thread_scratch<BoutReal>(n);
+  auto* fout = thread_scratch<dcomplex>((n / 2) + 1);
 
   fin[0] = 0.;
   fin[length - 1] = 0.;
 
   for (int j = 1; j < length - 1; j++) {
     fin[j] = in[j];
-    fin[2 * (length - 1) - j] = -in[j];
+    fin[n - j] = -in[j];
   }
 
-  // fftw call executing the fft
-  fftw_execute(p);
+  execute_r2c(fin, n, 1, n, fout, (n / 2) + 1);
 
   out[0] = 0.0;
   out[length - 1] = 0.0;
 
   for (int i = 1; i < length - 1; i++) {
-    out[i] = -fout[i][1] / (static_cast<BoutReal>(length) - 1); // Normalise
+    out[i] = -fout[i].imag() / (static_cast<BoutReal>(length) - 1); // Normalise
   }
 #endif
 }
@@ -451,53 +502,23 @@ void DST_rev(MAYBE_UNUSED(dcomplex* in), MAYBE_UNUSED(int length),
 #if !BOUT_HAS_FFTW
   throw BoutException("This instance of BOUT++ has been compiled without fftw support.");
 #else
-  static fftw_complex* fin;
-  static double* fout;
-  static fftw_plan p;
-  static int n = 0;
-
   ASSERT1(length > 0);
 
-  if (length != n) {
-    if (n > 0) {
-      fftw_destroy_plan(p);
-      fftw_free(fin);
-      fftw_free(fout);
-    }
-
-    //fft_init();
-
-    // Could be optimized better
-    fin =
-        static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * 2 * (length - 1)));
-    fout = static_cast<double*>(fftw_malloc(sizeof(double) * 2 * (length - 1)));
+  const int n = 2 * (length - 1);
 
-    auto flags = get_measurement_flag(fft_measurement_flag);
+  // Only the first n / 2 + 1 == length modes are used by the
+  // complex-to-real transform
+  auto* fin = thread_scratch<dcomplex>(length);
+  auto* fout = thread_scratch<BoutReal>(n);
 
-    p = fftw_plan_dft_c2r_1d(2 * (length - 1), fin, fout, flags);
-
-    n = length;
-  }
-
-  for (int i = 0; i < n; i++) {
-    fin[i][0] = in[i].real();
-    fin[i][1] = in[i].imag();
-  }
-
-  fin[0][0] = 0.;
-  fin[0][1] = 0.;
-  fin[length - 1][0] = 0.;
-  fin[length - 1][1] = 0.;
+  fin[0] = 0.;
+  fin[length - 1] = 0.;
 
   for (int j = 1; j < length - 1; j++) {
-    fin[j][0] = 0.;
-    fin[j][1] = -in[j].real() / 2.;
-    fin[2 * (length - 1) - j][0] = 0.;
-    fin[2 * (length - 1) - j][1] = in[j].real() / 2.;
+    fin[j] = dcomplex(0., -in[j].real() / 2.);
   }
 
-  // fftw call executing the fft
-  fftw_execute(p);
+  execute_c2r(fin, n, 1, length, fout, n);
 
   out[0] = 0.0;
   out[length - 1] = 0.0;
@@ -116,6 +116,9 @@ FieldPerp LaplaceCyclic::solve(const FieldPerp& rhs, const FieldPerp& x0) {
   int jy = rhs.getIndex(); // Get the Y index
   x.setIndex(jy);
 
+  // The matrices for this Y index replace any stored for Field3D solves
+  updateRequired = true;
+
   // Get the width of the boundary
 
   // If the flags to assign that only one guard cell should be used is set
@@ -309,6 +312,7 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
   ASSERT1(localmesh == rhs.getMesh() && localmesh == x0.getMesh());
 
   Timer timer("invert");
+  BOUT_TIME_REGION("invert:cyclic");
 
   Field3D x{emptyFrom(rhs)}; // Result
 
@@ -350,9 +354,20 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
   const int nsys = nmode * ny;  // Number of systems of equations to solve
   const int nxny = nx * ny;     // Number of points in X-Y
 
-  auto a3D = Matrix<dcomplex>(nsys, nx);
-  auto b3D = Matrix<dcomplex>(nsys, nx);
-  auto c3D = Matrix<dcomplex>(nsys, nx);
+  // The matrices stored in cr from the previous solve can be reused
+  // unless the coefficients, flags or Y range have changed
+  const bool recalculate = updateRequired or (ys != cached_ys) or (ye != cached_ye);
+
+  Matrix<dcomplex> a3D, b3D, c3D;
+  if (recalculate) {
+    a3D.reallocate(nsys, nx);
+    b3D.reallocate(nsys, nx);
+    c3D.reallocate(nsys, nx);
+
+    findZeroRHS(ys, not dst);
+    cached_ys = ys;
+    cached_ye = ye;
+  }
 
   auto xcmplx3D = Matrix<dcomplex>(nsys, nx);
   auto bcmplx3D = Matrix<dcomplex>(nsys, nx);
@@ -393,27 +408,34 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
       // Get elements of the tridiagonal matrix
       // including boundary conditions
       const BoutReal zlen = getUniform(coords->dz) * (localmesh->LocalNz - 3);
-      BOUT_OMP(for nowait)
-      for (int ind = 0; ind < nsys; ind++) {
-        // ind = (iy - ys) * nmode + kz
-        int iy = ys + ind / nmode;
-        int kz = ind % nmode;
-
-        // wave number is 1/[rad]; DST has extra 2.
-        BoutReal kwave = kz * 2.0 * PI / (2. * zlen);
-
-        tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
-                     kz,    // wave number index
-                     kwave, // kwave (inverse wave length)
-                     global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
-                     &C1coef, &C2coef, &Dcoef,
-                     false,  // Don't include guard cells in arrays
-                     false); // Z domain not periodic
+      if (recalculate) {
+        BOUT_OMP(for nowait)
+        for (int ind = 0; ind < nsys; ind++) {
+          // ind = (iy - ys) * nmode + kz
+          int iy = ys + ind / nmode;
+          int kz = ind % nmode;
+
+          // wave number is 1/[rad]; DST has extra 2.
+          BoutReal kwave = kz * 2.0 * PI / (2. * zlen);
+
+          tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
+                       kz,    // wave number index
+                       kwave, // kwave (inverse wave length)
+                       global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
+                       &C1coef, &C2coef, &Dcoef,
+                       false,  // Don't include guard cells in arrays
+                       false); // Z domain not periodic
+        }
       }
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a3D, b3D, c3D);
+    if (recalculate) {
+      cr->setCoefs(a3D, b3D, c3D);
+      updateRequired = false;
+    } else {
+      zeroRHS(bcmplx3D);
+    }
     cr->solve(bcmplx3D, xcmplx3D);
 
     // FFT back to real space
@@ -445,59 +467,67 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
     }
   } else {
     const BoutReal zlength = getUniform(coords->zlength());
+    const int ncz = localmesh->LocalNz;
+    const int nmodes_fft = (ncz / 2) + 1; // Number of modes returned by the FFT
     BOUT_OMP(parallel)
     {
       /// Create a local thread-scope working array
-      // ZFFT routine expects input of this length
-      auto k1d = Array<dcomplex>(localmesh->LocalNz / 2 + 1);
+      // ZFFT routine expects input of this length for each Y point
+      auto k2d = Matrix<dcomplex>(ny, nmodes_fft);
 
-      // Loop over X and Y indices, including boundaries but not guard cells
-      // (unless periodic in x)
+      // Loop over X indices, including boundaries but not guard cells
+      // (unless periodic in x). All the Y points at one X are contiguous,
+      // so can be transformed with a single batched FFT
 
       BOUT_OMP(for)
-      for (int ind = 0; ind < nxny; ++ind) {
-        // ind = (ix - xs)*(ye - ys + 1) + (iy - ys)
-        int ix = xs + ind / ny;
-        int iy = ys + ind % ny;
-
-        // Take FFT in Z direction, apply shift, and put result in k1d
+      for (int ix = xs; ix <= xe; ix++) {
+        // Take FFT in Z direction, apply shift, and put result in k2d
 
-        if (((ix < inbndry) && ((inner_boundary_flags & INVERT_SET) != 0)
+        const bool use_x0 =
+            ((ix < inbndry) && ((inner_boundary_flags & INVERT_SET) != 0)
              && localmesh->firstX())
             || ((localmesh->LocalNx - ix - 1 < outbndry)
-                && ((outer_boundary_flags & INVERT_SET) != 0) && localmesh->lastX())) {
-          // Use the values in x0 in the boundary
-          rfft(x0(ix, iy), localmesh->LocalNz, std::begin(k1d));
-        } else {
-          rfft(rhs(ix, iy), localmesh->LocalNz, std::begin(k1d));
-        }
+                && ((outer_boundary_flags & INVERT_SET) != 0) && localmesh->lastX());
+
+        // Use the values in x0 in the boundary
+        const Field3D& source = use_x0 ? x0 : rhs;
+        bout::fft::rfft_many(source(ix, ys), ncz, ny, ncz, &k2d(0, 0), nmodes_fft);
 
         // Copy into array, transposing so kz is first index
-        for (int kz = 0; kz < nmode; kz++) {
-          bcmplx3D((iy - ys) * nmode + kz, ix - xs) = k1d[kz];
+        for (int iy = ys; iy <= ye; iy++) {
+          for (int kz = 0; kz < nmode; kz++) {
+            bcmplx3D((iy - ys) * nmode + kz, ix - xs) = k2d(iy - ys, kz);
+          }
         }
       }
 
       // Get elements of the tridiagonal matrix
       // including boundary conditions
-      BOUT_OMP(for nowait)
-      for (int ind = 0; ind < nsys; ind++) {
-        // ind = (iy - ys) * nmode + kz
-        int iy = ys + ind / nmode;
-        int kz = ind % nmode;
-
-        BoutReal kwave = kz * 2.0 * PI / zlength; // wave number is 1/[rad]
-        tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
-                     kz,    // True for the component constant (DC) in Z
-                     kwave, // Z wave number
-                     global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
-                     &C1coef, &C2coef, &Dcoef,
-                     false); // Don't include guard cells in arrays
+      if (recalculate) {
+        BOUT_OMP(for nowait)
+        for (int ind = 0; ind < nsys; ind++) {
+          // ind = (iy - ys) * nmode + kz
+          int iy = ys + ind / nmode;
+          int kz = ind % nmode;
+
+          BoutReal kwave = kz * 2.0 * PI / zlength; // wave number is 1/[rad]
+          tridagMatrix(&a3D(ind, 0), &b3D(ind, 0), &c3D(ind, 0), &bcmplx3D(ind, 0), iy,
+                       kz,    // True for the component constant (DC) in Z
+                       kwave, // Z wave number
+                       global_flags, inner_boundary_flags, outer_boundary_flags, &Acoef,
+                       &C1coef, &C2coef, &Dcoef,
+                       false); // Don't include guard cells in arrays
+        }
       }
     }
 
     // Solve tridiagonal systems
-    cr->setCoefs(a3D, b3D, c3D);
+    if (recalculate) {
+      cr->setCoefs(a3D, b3D, c3D);
+      updateRequired = false;
+    } else {
+      zeroRHS(bcmplx3D);
+    }
     cr->solve(bcmplx3D, xcmplx3D);
 
     if (localmesh->periodicX) {
@@ -527,30 +557,27 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
     BOUT_OMP(parallel)
     {
       /// Create a local thread-scope working array
-      auto k1d = Array<dcomplex>((localmesh->LocalNz) / 2
-                                 + 1); // ZFFT routine expects input of this length
+      auto k2d = Matrix<dcomplex>(ny, nmodes_fft); // ZFFT routine expects this length
 
       const bool zero_DC = (global_flags & INVERT_ZERO_DC) != 0;
 
       BOUT_OMP(for nowait)
-      for (int ind = 0; ind < nxny; ++ind) { // Loop over X and Y
-        // ind = (ix - xs)*(ye - ys + 1) + (iy - ys)
-        int ix = xs + ind / ny;
-        int iy = ys + ind % ny;
-
-        if (zero_DC) {
-          k1d[0] = 0.;
-        }
-
-        for (int kz = static_cast<int>(zero_DC); kz < nmode; kz++) {
-          k1d[kz] = xcmplx3D((iy - ys) * nmode + kz, ix - xs);
+      for (int ix = xs; ix <= xe; ix++) { // Loop over X, batching over Y
+        for (int iy = ys; iy <= ye; iy++) {
+          if (zero_DC) {
+            k2d(iy - ys, 0) = 0.;
+          }
+
+          for (int kz = static_cast<int>(zero_DC); kz < nmode; kz++) {
+            k2d(iy - ys, kz) = xcmplx3D((iy - ys) * nmode + kz, ix - xs);
+          }
+
+          for (int kz = nmode; kz < nmodes_fft; kz++) {
+            k2d(iy - ys, kz) = 0.0; // Filtering out all higher harmonics
+          }
         }
 
-        for (int kz = nmode; kz < localmesh->LocalNz / 2 + 1; kz++) {
-          k1d[kz] = 0.0; // Filtering out all higher harmonics
-        }
-
-        irfft(std::begin(k1d), localmesh->LocalNz, x(ix, iy));
+        bout::fft::irfft_many(&k2d(0, 0), ncz, ny, nmodes_fft, x(ix, ys), ncz);
       }
     }
   }
@@ -560,6 +587,48 @@ Field3D LaplaceCyclic::solve(const Field3D& rhs, const Field3D& x0) {
   return x;
 }
 
+void LaplaceCyclic::findZeroRHS(int jy, bool zperiodic) {
+  const int nx = xe - xs + 1;
+  auto avec = Array<dcomplex>(nx);
+  auto bvec = Array<dcomplex>(nx);
+  auto cvec = Array<dcomplex>(nx);
+  auto bk = Array<dcomplex>(nx);
+
+  zero_rhs_dc.clear();
+  zero_rhs_ac.clear();
+
+  // The boundary conditions only depend on whether this is the DC
+  // mode, so try one of each with a RHS which is non-zero everywhere
+  for (int kz = 0; kz < std::min(nmode, 2); kz++) {
+    std::fill(std::begin(bk), std::end(bk), 1.0);
+    tridagMatrix(std::begin(avec), std::begin(bvec), std::begin(cvec), std::begin(bk), jy,
+                 kz, static_cast<BoutReal>(kz), global_flags, inner_boundary_flags,
+                 outer_boundary_flags, &Acoef, &C1coef, &C2coef, &Dcoef,
+                 false, // Don't include guard cells in arrays
+                 zperiodic);
+
+    auto& zero_rhs = (kz == 0) ? zero_rhs_dc : zero_rhs_ac;
+    for (int ix = 0; ix < nx; ix++) {
+      if (bk[ix] == 0.0) {
+        zero_rhs.push_back(ix);
+      }
+    }
+  }
+}
+
+void LaplaceCyclic::zeroRHS(Matrix<dcomplex>& bcmplx3D) const {
+  const int nsys = std::get<0>(bcmplx3D.shape());
+
+  BOUT_OMP(parallel for)
+  for (int ind = 0; ind < nsys; ind++) {
+    // ind = (iy - ys) * nmode + kz
+    const auto& zero_rhs = (ind % nmode == 0) ? zero_rhs_dc : zero_rhs_ac;
+    for (const int ix : zero_rhs) {
+      bcmplx3D(ind, ix) = 0.0;
+    }
+  }
+}
+
 void LaplaceCyclic ::verify_solution(const Matrix<dcomplex>& a_ver,
                                      const Matrix<dcomplex>& b_ver,
                                      const Matrix<dcomplex>& c_ver,
@@ -49,13 +49,19 @@ RegisterUnavailableLaplace registerlaplacecycle(LAPLACE_CYCLIC,
 
 #include "bout/utils.hxx"
 
+#include <vector>
+
 namespace {
 RegisterLaplace<LaplaceCyclic> registerlaplacecycle(LAPLACE_CYCLIC);
 }
 
 /// Solves the 2D Laplacian equation using the CyclicReduce class
 /*!
- * 
+ * The tridiagonal matrices for Field3D solves are only recalculated
+ * when the coefficients, boundary flags or Y range change, so
+ * repeated solves with the same coefficients only transform and
+ * back-substitute the right hand side. The metric is assumed to be
+ * fixed between solves.
  */
 class LaplaceCyclic : public Laplacian {
 public:
@@ -68,6 +74,7 @@ public:
     ASSERT1(val.getLocation() == location);
     ASSERT1(localmesh == val.getMesh());
     Acoef = val;
+    updateRequired = true;
   }
   using Laplacian::setCoefC;
   void setCoefC(const Field2D& val) override {
@@ -79,18 +86,21 @@ public:
     ASSERT1(val.getLocation() == location);
     ASSERT1(localmesh == val.getMesh());
     C1coef = val;
+    updateRequired = true;
   }
   using Laplacian::setCoefC2;
   void setCoefC2(const Field2D& val) override {
     ASSERT1(val.getLocation() == location);
     ASSERT1(localmesh == val.getMesh());
     C2coef = val;
+    updateRequired = true;
   }
   using Laplacian::setCoefD;
   void setCoefD(const Field2D& val) override {
     ASSERT1(val.getLocation() == location);
     ASSERT1(localmesh == val.getMesh());
     Dcoef = val;
+    updateRequired = true;
   }
   using Laplacian::setCoefEx;
   void setCoefEx(const Field2D& UNUSED(val)) override {
@@ -101,6 +111,19 @@ public:
     throw BoutException("LaplaceCyclic does not have Ez coefficient");
   }
 
+  void setGlobalFlags(int f) override {
+    updateRequired = updateRequired or (f != global_flags);
+    Laplacian::setGlobalFlags(f);
+  }
+  void setInnerBoundaryFlags(int f) override {
+    updateRequired = updateRequired or (f != inner_boundary_flags);
+    Laplacian::setInnerBoundaryFlags(f);
+  }
+  void setOuterBoundaryFlags(int f) override {
+    updateRequired = updateRequired or (f != outer_boundary_flags);
+    Laplacian::setOuterBoundaryFlags(f);
+  }
+
   using Laplacian::solve;
   FieldPerp solve(const FieldPerp& b) override { return solve(b, b); }
   FieldPerp solve(const FieldPerp& b, const FieldPerp& x0) override;
@@ -121,6 +144,20 @@ private:
   bool dst;
 
   CyclicReduce<dcomplex>* cr; ///< Tridiagonal solver
+
+  /// True if the matrices in cr need to be recalculated before the
+  /// next Field3D solve
+  bool updateRequired{true};
+  int cached_ys{0}, cached_ye{-1}; ///< Y range of the matrices in cr
+
+  /// X indices (from xs) where tridagMatrix sets the RHS to zero, for
+  /// the kz = 0 mode and the other modes
+  std::vector<int> zero_rhs_dc, zero_rhs_ac;
+
+  /// Set zero_rhs_dc and zero_rhs_ac from the boundary conditions at \p jy
+  void findZeroRHS(int jy, bool zperiodic);
+  /// Set the RHS to zero where tridagMatrix would, when the matrices are reused
+  void zeroRHS(Matrix<dcomplex>& bcmplx3D) const;
 };
 
 #endif // BOUT_USE_METRIC_3D
@@ -1464,8 +1464,10 @@ void LaplaceIPT::Level::synchronize_reduced_field(const LaplaceIPT& l,
 
 void LaplaceIPT::outputVars(Options& output_options,
                             const std::string& time_dimension) const {
-  output_options[fmt::format("{}_mean_its", getPerformanceName())].assignRepeat(
-      ipt_mean_its, time_dimension);
+  const auto name = fmt::format("{}_mean_its", getPerformanceName());
+  output_options[name].assignRepeat(ipt_mean_its, time_dimension);
+  // Each processor averages over the Y slices it solves
+  output_options[name].attributes["per_processor"] = true;
 }
 
 #endif // BOUT_USE_METRIC_3D
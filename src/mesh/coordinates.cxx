@@ -1673,21 +1673,22 @@ Field3D Coordinates::Delp2(const Field3D& f, CELL_LOC outloc, bool useFFT) {
 
   if (useFFT and not bout::build::use_metric_3d) {
     int ncz = localmesh->LocalNz;
+    const int nmodes = (ncz / 2) + 1;
+    const int nxinterior = localmesh->xend - localmesh->xstart + 1;
 
     // Allocate memory
-    auto ft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
-    auto delft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
+    auto ft = Matrix<dcomplex>(localmesh->LocalNx, nmodes);
+    auto delft = Matrix<dcomplex>(localmesh->LocalNx, nmodes);
 
     // Loop over y indices
     // Note: should not include y-guard or y-boundary points here as that would
     // use values from corner cells in dx, which may not be initialised.
     for (int jy = localmesh->ystart; jy <= localmesh->yend; jy++) {
 
-      // Take forward FFT
-
-      for (int jx = 0; jx < localmesh->LocalNx; jx++) {
-        rfft(&f(jx, jy, 0), ncz, &ft(jx, 0));
-      }
+      // Take forward FFT of all the X points at this Y in one go. These
+      // are strided by LocalNy * LocalNz in the field's data
+      bout::fft::rfft_many(&f(0, jy, 0), ncz, localmesh->LocalNx,
+                           localmesh->LocalNy * ncz, &ft(0, 0), nmodes);
 
       // Loop over kz
       for (int jz = 0; jz <= ncz / 2; jz++) {
@@ -1704,10 +1705,8 @@ Field3D Coordinates::Delp2(const Field3D& f, CELL_LOC outloc, bool useFFT) {
       }
 
       // Reverse FFT
-      for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
-
-        irfft(&delft(jx, 0), ncz, &result(jx, jy, 0));
-      }
+      bout::fft::irfft_many(&delft(localmesh->xstart, 0), ncz, nxinterior, nmodes,
+                            &result(localmesh->xstart, jy, 0), localmesh->LocalNy * ncz);
     }
   } else {
     result = G1 * ::DDX(f, outloc) + G3 * ::DDZ(f, outloc) + g11 * ::D2DX2(f, outloc)
@@ -1742,15 +1741,15 @@ FieldPerp Coordinates::Delp2(const FieldPerp& f, CELL_LOC outloc, bool useFFT) {
 
   if (useFFT) {
     int ncz = localmesh->LocalNz;
+    const int nmodes = (ncz / 2) + 1;
+    const int nxinterior = localmesh->xend - localmesh->xstart + 1;
 
     // Allocate memory
-    auto ft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
-    auto delft = Matrix<dcomplex>(localmesh->LocalNx, ncz / 2 + 1);
+    auto ft = Matrix<dcomplex>(localmesh->LocalNx, nmodes);
+    auto delft = Matrix<dcomplex>(localmesh->LocalNx, nmodes);
 
-    // Take forward FFT
-    for (int jx = 0; jx < localmesh->LocalNx; jx++) {
-      rfft(&f(jx, 0), ncz, &ft(jx, 0));
-    }
+    // Take forward FFT of the whole slab
+    bout::fft::rfft_many(&f(0, 0), ncz, localmesh->LocalNx, ncz, &ft(0, 0), nmodes);
 
     // Loop over kz
     for (int jz = 0; jz <= ncz / 2; jz++) {
@@ -1767,9 +1766,8 @@ FieldPerp Coordinates::Delp2(const FieldPerp& f, CELL_LOC outloc, bool useFFT) {
     }
 
     // Reverse FFT
-    for (int jx = localmesh->xstart; jx <= localmesh->xend; jx++) {
-      irfft(&delft(jx, 0), ncz, &result(jx, 0));
-    }
+    bout::fft::irfft_many(&delft(localmesh->xstart, 0), ncz, nxinterior, nmodes,
+                          &result(localmesh->xstart, 0), ncz);
 
   } else {
     throw BoutException("Non-fourier Delp2 not currently implented for FieldPerp.");
@@ -14,7 +14,7 @@
 #include <utility>
 
 GridFile::GridFile(std::string gridfilename)
-    : GridDataSource(true), data(bout::OptionsNetCDF(gridfilename).read()),
+    : GridDataSource(true), file(gridfilename), data(file.read(1)),
       filename(std::move(gridfilename)) {
   TRACE("GridFile constructor");
 
@@ -30,7 +30,7 @@ GridFile::GridFile(std::string gridfilename)
  * Tests whether a variable exists in the file
  *
  */
-bool GridFile::hasVar(const std::string& name) { return data.isSet(name); }
+bool GridFile::hasVar(const std::string& name) { return not getShape(name).empty(); }
 
 /*!
  * Read a string from file. If the string is not
@@ -153,6 +153,14 @@ struct GetDimensions {
 };
 } // namespace
 
+std::vector<int> GridFile::getShape(const std::string& name) {
+  if (data.isSet(name)) {
+    return bout::utils::visit(GetDimensions{}, data[name].value);
+  }
+  // Larger variables are only read when needed
+  return file.readShape(name);
+}
+
 template <typename T>
 bool GridFile::getField(Mesh* m, T& var, const std::string& name, BoutReal def,
                         CELL_LOC location) {
@@ -163,7 +171,10 @@ bool GridFile::getField(Mesh* m, T& var, const std::string& name, BoutReal def,
   Timer timer("io");
   AUTO_TRACE();
 
-  if (not data.isSet(name)) {
+  // Global (x, y, z) dimensions of field
+  const std::vector<int> size = getShape(name);
+
+  if (size.empty()) {
     // Variable not found
     output_warn.write("\tWARNING: Could not read '{:s}' from grid. Setting to {:e}\n",
                       name, def);
@@ -172,11 +183,6 @@ bool GridFile::getField(Mesh* m, T& var, const std::string& name, BoutReal def,
     return false;
   }
 
-  Options option = data[name];
-
-  // Global (x, y, z) dimensions of field
-  const std::vector<int> size = bout::utils::visit(GetDimensions{}, option.value);
-
   switch (size.size()) {
   case 1: {
     // 0 or 1 dimension
@@ -185,7 +191,7 @@ bool GridFile::getField(Mesh* m, T& var, const std::string& name, BoutReal def,
           "Expecting a 2D variable, but '{:s}' is 1D with {:d} elements\n", name,
           size[0]);
     }
-    var = option.as<BoutReal>();
+    var = data[name].as<BoutReal>();
     var.setLocation(location);
     return true;
   }
@@ -375,11 +381,13 @@ void GridFile::readField(Mesh* UNUSED(m), const std::string& name, int ys, int y
 
   var.allocate();
 
-  const auto full_var = data[name].as<Matrix<BoutReal>>();
+  // Only the part of the variable on this processor
+  const auto part =
+      file.readHyperslab(name, {xs, ys}, {nx_to_read, ny_to_read}).as<Matrix<BoutReal>>();
 
   for (int x = xs; x < xs + nx_to_read; ++x) {
     for (int y = ys; y < ys + ny_to_read; ++y) {
-      var(x - xs + xd, y - ys + yd) = full_var(x, y);
+      var(x - xs + xd, y - ys + yd) = part(x - xs, y - ys);
     }
   }
 }
@@ -499,8 +507,7 @@ bool GridFile::get(Mesh* UNUSED(m), std::vector<BoutReal>& var, const std::strin
 bool GridFile::hasXBoundaryGuards(Mesh* m) {
   // Global (x,y) dimensions of some field
   // a grid file should always contain "dx"
-  Options option = data["dx"];
-  const std::vector<int> size = bout::utils::visit(GetDimensions{}, option.value);
+  const std::vector<int> size = getShape("dx");
 
   if (size.empty()) {
     // handle case where "dx" is not present - non-standard grid file
@@ -535,8 +542,7 @@ bool GridFile::readgrid_3dvar_fft(Mesh* m, const std::string& name, int yread, i
   }
 
   /// Check the size of the data
-  Options option = data[name];
-  const std::vector<int> size = bout::utils::visit(GetDimensions{}, option.value);
+  const std::vector<int> size = getShape(name);
 
   if (size.size() != 3) {
     output_warn.write("\tWARNING: Number of dimensions of {:s} incorrect\n", name);
@@ -579,14 +585,15 @@ bool GridFile::readgrid_3dvar_fft(Mesh* m, const std::string& name, int yread, i
   Array<dcomplex> fdata(ncz / 2 + 1);
   Array<BoutReal> zdata(size[2]);
 
-  const auto full_var = data[name].as<Tensor<BoutReal>>();
+  const auto part = file.readHyperslab(name, {xread, yread, 0}, {xsize, ysize, size[2]})
+                        .as<Tensor<BoutReal>>();
 
   for (int jx = xread; jx < xread + xsize; jx++) {
     // jx is global x-index to start from
     for (int jy = yread; jy < yread + ysize; jy++) {
       // jy is global y-index to start from
       for (int jz = 0; jz < size[2]; ++jz) {
-        zdata[jz] = full_var(jx, jy, jz);
+        zdata[jz] = part(jx - xread, jy - yread, jz);
       }
 
       /// Load into dcomplex array
@@ -622,24 +629,24 @@ bool GridFile::readgrid_3dvar_real(const std::string& name, int yread, int ydest
     return false;
   }
 
-  Options option = data[name];
-
   /// Check the size of the data
-  const std::vector<int> size = bout::utils::visit(GetDimensions{}, option.value);
+  const std::vector<int> size = getShape(name);
 
   if (size.size() != 3) {
     output_warn.write("\tWARNING: Number of dimensions of {:s} incorrect\n", name);
     return false;
   }
 
-  const auto full_var = option.as<Tensor<BoutReal>>();
+  const auto part = file.readHyperslab(name, {xread, yread, 0}, {xsize, ysize, size[2]})
+                        .as<Tensor<BoutReal>>();
 
   for (int jx = xread; jx < xread + xsize; jx++) {
     // jx is global x-index to start from
     for (int jy = yread; jy < yread + ysize; jy++) {
       // jy is global y-index to start from
       for (int jz = 0; jz < size[2]; ++jz) {
-        var(jx - xread + xdest, jy - yread + ydest, jz) = full_var(jx, jy, jz);
+        var(jx - xread + xdest, jy - yread + ydest, jz) =
+            part(jx - xread, jy - yread, jz);
       }
     }
   }
@@ -665,8 +672,7 @@ bool GridFile::readgrid_perpvar_fft(Mesh* m, const std::string& name, int xread,
   }
 
   /// Check the size of the data
-  Options option = data[name];
-  const std::vector<int> size = bout::utils::visit(GetDimensions{}, option.value);
+  const std::vector<int> size = getShape(name);
 
   if (size.size() != 2) {
     output_warn.write("\tWARNING: Number of dimensions of {:s} incorrect\n", name);
@@ -709,12 +715,13 @@ bool GridFile::readgrid_perpvar_fft(Mesh* m, const std::string& name, int xread,
   Array<dcomplex> fdata(ncz / 2 + 1);
   Array<BoutReal> zdata(size[1]);
 
-  const auto full_var = option.as<Matrix<BoutReal>>();
+  const auto part =
+      file.readHyperslab(name, {xread, 0}, {xsize, size[1]}).as<Matrix<BoutReal>>();
 
   for (int jx = xread; jx < xread + xsize; jx++) {
     // jx is global x-index to start from
     for (int jz = 0; jz < size[1]; ++jz) {
-      zdata[jz] = full_var(jx, jz);
+      zdata[jz] = part(jx - xread, jz);
     }
 
     /// Load into dcomplex array
@@ -748,20 +755,20 @@ bool GridFile::readgrid_perpvar_real(const std::string& name, int xread, int xde
   }
 
   /// Check the size of the data
-  Options option = data[name];
-  const std::vector<int> size = bout::utils::visit(GetDimensions{}, option.value);
+  const std::vector<int> size = getShape(name);
 
   if (size.size() != 2) {
     output_warn.write("\tWARNING: Number of dimensions of {:s} incorrect\n", name);
     return false;
   }
 
-  const auto full_var = option.as<Matrix<BoutReal>>();
+  const auto part =
+      file.readHyperslab(name, {xread, 0}, {xsize, size[1]}).as<Matrix<BoutReal>>();
 
   for (int jx = xread; jx < xread + xsize; jx++) {
     // jx is global x-index to start from
     for (int jz = 0; jz < size[1]; ++jz) {
-      var(jx - xread + xdest, jz) = full_var(jx, jz);
+      var(jx - xread + xdest, jz) = part(jx - xread, jz);
     }
   }
 
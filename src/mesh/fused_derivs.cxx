@@ -0,0 +1,196 @@
+#include "bout/fused_derivs.hxx"
+#include "bout/assert.hxx"
+#include "bout/boutexception.hxx"
+#include "bout/build_config.hxx"
+#include "bout/coordinates.hxx"
+#include "bout/deriv_store.hxx"
+#include "bout/mesh.hxx"
+#include "bout/region.hxx"
+
+namespace bout {
+namespace derivatives {
+
+namespace {
+/// Reads a metric component at a point, which is either 2D or 3D
+class Metric {
+public:
+  Metric() = default;
+  explicit Metric(const Coordinates::FieldMetric& field) : data(&field(0, 0, 0)) {}
+
+  BoutReal operator()(int ind2d, int ind3d) const {
+    return data[bout::build::use_metric_3d ? ind3d : ind2d];
+  }
+
+private:
+  const BoutReal* data{nullptr};
+};
+
+/// Calls \p function(jz, jzp, jzm) for each point along a periodic z
+/// line of length \p ncz. The first and last points are handled
+/// separately, so that the loop over the middle can vectorise
+template <typename Function>
+void forZ(int ncz, Function&& function) {
+  function(0, (ncz > 1) ? 1 : 0, ncz - 1);
+  for (int jz = 1; jz < ncz - 1; ++jz) {
+    function(jz, jz + 1, jz - 1);
+  }
+  if (ncz > 1) {
+    function(ncz - 1, 0, ncz - 2);
+  }
+}
+} // namespace
+
+bool PerpDerivatives::defaultMethodsAreC2() {
+  const auto& store = DerivativeStore<Field3D>::getInstance();
+  for (const auto direction : {DIRECTION::X, DIRECTION::Z}) {
+    for (const auto deriv : {DERIV::Standard, DERIV::StandardSecond}) {
+      if (store.getDefaultMethod(deriv, direction) != "C2") {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void PerpDerivatives::run() {
+  if (outputs.empty()) {
+    return;
+  }
+
+  const Field3D& first = *outputs.front().f;
+  Mesh* mesh = first.getMesh();
+  Coordinates* coords = first.getCoordinates();
+
+  if (mesh->IncIntShear) {
+    throw BoutException("PerpDerivatives does not support the IncIntShear option");
+  }
+  ASSERT2(mesh->xstart > 0); // Need at least one guard cell
+
+  // Brackets are zero without both x and z directions
+  const bool zero_bracket = (mesh->GlobalNx == 1) or (mesh->GlobalNz == 1);
+
+  std::vector<Output> active;
+  for (const auto& output : outputs) {
+    ASSERT1_FIELDS_COMPATIBLE(first, *output.f);
+    ASSERT1_FIELDS_COMPATIBLE(first, *output.g);
+#if CHECK > 0
+    for (const auto& other : outputs) {
+      if ((output.result == other.f) or (output.result == other.g)) {
+        throw BoutException("PerpDerivatives outputs must not also be inputs");
+      }
+    }
+#endif
+    *output.result = emptyFrom(*output.g);
+
+    if (zero_bracket and (output.kind == Kind::bracket)) {
+      *output.result = 0.0;
+      continue;
+    }
+    active.push_back(output);
+  }
+
+  const Metric dx{coords->dx}, dz{coords->dz};
+  const Metric G1{coords->G1}, G3{coords->G3};
+  const Metric g11{coords->g11}, g33{coords->g33}, g13{coords->g13};
+  const bool non_uniform = coords->non_uniform;
+  const Metric d1_dx = non_uniform ? Metric{coords->d1_dx} : Metric{};
+
+  const int ncz = mesh->LocalNz;
+
+  BOUT_FOR(i2d, mesh->getRegion2D(region)) {
+    const int jx = i2d.x(), jy = i2d.y();
+    const int base = i2d.ind * ncz;
+
+    for (const auto& output : active) {
+      const Field3D& f = *output.f;
+      const BoutReal *fxm = f(jx - 1, jy), *fx = f(jx, jy), *fxp = f(jx + 1, jy);
+      BoutReal* result = (*output.result)(jx, jy);
+
+      switch (output.kind) {
+      case Kind::DDX:
+        forZ(ncz, [&](int jz, int, int) {
+          result[jz] = 0.5 * (fxp[jz] - fxm[jz]) / dx(i2d.ind, base + jz);
+        });
+        break;
+      case Kind::DDZ:
+        forZ(ncz, [&](int jz, int jzp, int jzm) {
+          result[jz] = 0.5 * (fx[jzp] - fx[jzm]) / dz(i2d.ind, base + jz);
+        });
+        break;
+      case Kind::D2DX2:
+        forZ(ncz, [&](int jz, int, int) {
+          const int m = base + jz;
+          const BoutReal dx_m = dx(i2d.ind, m);
+          result[jz] = (fxp[jz] + fxm[jz] - 2. * fx[jz]) / (dx_m * dx_m);
+          if (non_uniform) {
+            result[jz] += d1_dx(i2d.ind, m) * 0.5 * (fxp[jz] - fxm[jz]) / dx_m;
+          }
+        });
+        break;
+      case Kind::D2DZ2:
+        forZ(ncz, [&](int jz, int jzp, int jzm) {
+          const BoutReal dz_m = dz(i2d.ind, base + jz);
+          result[jz] = (fx[jzp] + fx[jzm] - 2. * fx[jz]) / (dz_m * dz_m);
+        });
+        break;
+      case Kind::D2DXDZ:
+        forZ(ncz, [&](int jz, int jzp, int jzm) {
+          const int m = base + jz;
+          result[jz] = 0.25 * (fxp[jzp] - fxp[jzm] - fxm[jzp] + fxm[jzm])
+                       / (dx(i2d.ind, m) * dz(i2d.ind, m));
+        });
+        break;
+      case Kind::Delp2:
+        forZ(ncz, [&](int jz, int jzp, int jzm) {
+          const int m = base + jz;
+          const BoutReal dx_m = dx(i2d.ind, m);
+          const BoutReal dz_m = dz(i2d.ind, m);
+
+          const BoutReal ddx = 0.5 * (fxp[jz] - fxm[jz]) / dx_m;
+          const BoutReal ddz = 0.5 * (fx[jzp] - fx[jzm]) / dz_m;
+          BoutReal d2dx2 = (fxp[jz] + fxm[jz] - 2. * fx[jz]) / (dx_m * dx_m);
+          if (non_uniform) {
+            d2dx2 += d1_dx(i2d.ind, m) * ddx;
+          }
+          const BoutReal d2dz2 = (fx[jzp] + fx[jzm] - 2. * fx[jz]) / (dz_m * dz_m);
+          const BoutReal d2dxdz =
+              0.25 * (fxp[jzp] - fxp[jzm] - fxm[jzp] + fxm[jzm]) / (dx_m * dz_m);
+
+          result[jz] = G1(i2d.ind, m) * ddx + G3(i2d.ind, m) * ddz
+                       + g11(i2d.ind, m) * d2dx2 + g33(i2d.ind, m) * d2dz2
+                       + 2 * g13(i2d.ind, m) * d2dxdz;
+        });
+        break;
+      case Kind::bracket: {
+        const Field3D& g = *output.g;
+        const BoutReal *gxm = g(jx - 1, jy), *gx = g(jx, jy), *gxp = g(jx + 1, jy);
+
+        forZ(ncz, [&](int jz, int jzp, int jzm) {
+          const int m = base + jz;
+          const BoutReal spacing_factor = 1.0 / (12 * dz(i2d.ind, m) * dx(i2d.ind, m));
+
+          // J++ = DDZ(f)*DDX(g) - DDX(f)*DDZ(g)
+          const BoutReal Jpp = ((fx[jzp] - fx[jzm]) * (gxp[jz] - gxm[jz])
+                                - (fxp[jz] - fxm[jz]) * (gx[jzp] - gx[jzm]));
+
+          // J+x
+          const BoutReal Jpx =
+              (gxp[jz] * (fxp[jzp] - fxp[jzm]) - gxm[jz] * (fxm[jzp] - fxm[jzm])
+               - gx[jzp] * (fxp[jzp] - fxm[jzp]) + gx[jzm] * (fxp[jzm] - fxm[jzm]));
+
+          // Jx+
+          const BoutReal Jxp =
+              (gxp[jzp] * (fx[jzp] - fxp[jz]) - gxm[jzm] * (fxm[jz] - fx[jzm])
+               - gxm[jzp] * (fx[jzp] - fxm[jz]) + gxp[jzm] * (fxp[jz] - fx[jzm]));
+
+          result[jz] = (Jpp + Jpx + Jxp) * spacing_factor;
+        });
+        break;
+      }
+      }
+    }
+  }
+}
+
+} // namespace derivatives
+} // namespace bout
@@ -1133,6 +1133,7 @@ void BoutMesh::post_receiveY(CommHandle& ch) {
 comm_handle BoutMesh::send(FieldGroup& g) {
   /// Start timer
   Timer timer("comms");
+  BOUT_TIME_REGION("comms:send");
 
   if (include_corner_cells) {
     throw BoutException("Cannot use send() when include_corner_cells==true as it sends "
@@ -1157,6 +1158,7 @@ comm_handle BoutMesh::send(FieldGroup& g) {
 comm_handle BoutMesh::sendX(FieldGroup& g, comm_handle handle, bool disable_corners) {
   /// Start timer
   Timer timer("comms");
+  BOUT_TIME_REGION("comms:send");
 
   const bool with_corners = include_corner_cells and not disable_corners;
 
@@ -1218,6 +1220,7 @@ comm_handle BoutMesh::sendX(FieldGroup& g, comm_handle handle, bool disable_corn
 comm_handle BoutMesh::sendY(FieldGroup& g, comm_handle handle) {
   /// Start timer
   Timer timer("comms");
+  BOUT_TIME_REGION("comms:send");
 
   CommHandle* ch;
   if (handle == nullptr) {
@@ -1327,6 +1330,7 @@ int BoutMesh::wait(comm_handle handle) {
 
   /// Start timer
   Timer timer("comms");
+  BOUT_TIME_REGION("comms:wait");
 
   ///////////// WAIT FOR DATA //////////////
 
@@ -1411,60 +1415,415 @@ int BoutMesh::wait(comm_handle handle) {
   }
 
   if (ch->has_y_communication) {
-    // TWIST-SHIFT CONDITION
-    // Loop over 3D fields
-    for (const auto& var : ch->var_list.field3d()) {
-      if (var->requiresTwistShift(TwistShift)) {
-        // Twist-shift only needed for field-aligned fields
-        int jx = 0;
-        int jy = 0;
-
-        // Perform Twist-shift using shifting method
-        // Lower boundary
-        if (TS_down_in && (DDATA_INDEST != -1)) {
-          for (jx = 0; jx < DDATA_XSPLIT; jx++) {
-            for (jy = 0; jy != MYG; jy++) {
-              shiftZ(*var, jx, jy, ShiftAngle[jx]);
-            }
+    applyTwistShift(ch->var_list);
+  }
+
+#if CHECK > 0
+  // Keeping track of whether communications have been done
+  for (const auto& var : ch->var_list) {
+    var->doneComms();
+  }
+#endif
+
+  free_handle(ch);
+
+  return 0;
+}
+
+void BoutMesh::applyTwistShift(FieldGroup& g) {
+  // TWIST-SHIFT CONDITION
+  // Loop over 3D fields
+  for (const auto& var : g.field3d()) {
+    if (var->requiresTwistShift(TwistShift)) {
+      // Twist-shift only needed for field-aligned fields
+      int jx = 0;
+      int jy = 0;
+
+      // Perform Twist-shift using shifting method
+      // Lower boundary
+      if (TS_down_in && (DDATA_INDEST != -1)) {
+        for (jx = 0; jx < DDATA_XSPLIT; jx++) {
+          for (jy = 0; jy != MYG; jy++) {
+            shiftZ(*var, jx, jy, ShiftAngle[jx]);
           }
         }
-        if (TS_down_out && (DDATA_OUTDEST != -1)) {
-          for (jx = DDATA_XSPLIT; jx < LocalNx; jx++) {
-            for (jy = 0; jy != MYG; jy++) {
-              shiftZ(*var, jx, jy, ShiftAngle[jx]);
-            }
+      }
+      if (TS_down_out && (DDATA_OUTDEST != -1)) {
+        for (jx = DDATA_XSPLIT; jx < LocalNx; jx++) {
+          for (jy = 0; jy != MYG; jy++) {
+            shiftZ(*var, jx, jy, ShiftAngle[jx]);
           }
         }
+      }
 
-        // Upper boundary
-        if (TS_up_in && (UDATA_INDEST != -1)) {
-          for (jx = 0; jx < UDATA_XSPLIT; jx++) {
-            for (jy = LocalNy - MYG; jy != LocalNy; jy++) {
-              shiftZ(*var, jx, jy, -ShiftAngle[jx]);
-            }
+      // Upper boundary
+      if (TS_up_in && (UDATA_INDEST != -1)) {
+        for (jx = 0; jx < UDATA_XSPLIT; jx++) {
+          for (jy = LocalNy - MYG; jy != LocalNy; jy++) {
+            shiftZ(*var, jx, jy, -ShiftAngle[jx]);
           }
         }
-        if (TS_up_out && (UDATA_OUTDEST != -1)) {
-          for (jx = UDATA_XSPLIT; jx < LocalNx; jx++) {
-            for (jy = LocalNy - MYG; jy != LocalNy; jy++) {
-              shiftZ(*var, jx, jy, -ShiftAngle[jx]);
-            }
+      }
+      if (TS_up_out && (UDATA_OUTDEST != -1)) {
+        for (jx = UDATA_XSPLIT; jx < LocalNx; jx++) {
+          for (jy = LocalNy - MYG; jy != LocalNy; jy++) {
+            shiftZ(*var, jx, jy, -ShiftAngle[jx]);
           }
         }
       }
     }
   }
+}
+
+namespace {
+/// Fewest points in a message before the fields are packed in parallel
+constexpr int min_parallel_pack = 1 << 14;
+
+/// Pointer to the data of a Field2D or Field3D
+BoutReal* getFieldData(FieldData* var) {
+  if (var->is3D()) {
+    auto& field = *static_cast<Field3D*>(var);
+    ASSERT2(field.isAllocated());
+    return &field(0, 0, 0);
+  }
+  auto& field = *static_cast<Field2D*>(var);
+  ASSERT2(field.isAllocated());
+  return &field(0, 0);
+}
+
+/// Copy the points with x in [xge, xlt) and y in [yge, ylt) between
+/// \p data, stored as [x][y][z] with \p ny points in y and \p nz in
+/// z, and the contiguous \p buffer. If \p pack then copy from the
+/// field into the buffer, otherwise from the buffer into the field
+template <bool pack>
+void copyBlock(BoutReal* data, int ny, int nz, int xge, int xlt, int yge, int ylt,
+               BoutReal* buffer) {
+  // All the points at one x are contiguous
+  const int count = (ylt - yge) * nz;
+  if ((count <= 0) or (xlt <= xge)) {
+    return;
+  }
+
+  // If the whole y range is included, then all x are contiguous too
+  const bool all_y = (count == ny * nz);
+  const int length = all_y ? (xlt - xge) * count : count;
+  const int nblocks = all_y ? 1 : xlt - xge;
+
+  for (int block = 0; block < nblocks; ++block) {
+    BoutReal* field = data + ((((xge + block) * ny) + yge) * nz);
+    if (pack) {
+      std::copy(field, field + length, buffer);
+    } else {
+      std::copy(buffer, buffer + length, field);
+    }
+    buffer += length;
+  }
+}
+
+/// Pack or unpack all fields in \p var_list, returning the total length
+template <bool pack>
+int copyFields(const std::vector<FieldData*>& var_list, int ny, int nz, int xge,
+               int xlt, int yge, int ylt, BoutReal* buffer) {
+  const int nvars = static_cast<int>(var_list.size());
+
+  // Offset of each field in the buffer, so they can be copied independently
+  std::vector<int> offsets(nvars + 1, 0);
+  for (int i = 0; i < nvars; ++i) {
+    const int points_per_y = var_list[i]->is3D() ? nz : 1;
+    offsets[i + 1] =
+        offsets[i] + (std::max(xlt - xge, 0) * std::max(ylt - yge, 0) * points_per_y);
+  }
+
+  BOUT_OMP(parallel for if ((nvars > 1) and (offsets[nvars] >= min_parallel_pack)))
+  for (int i = 0; i < nvars; ++i) {
+    FieldData* var = var_list[i];
+    copyBlock<pack>(getFieldData(var), ny, var->is3D() ? nz : 1, xge, xlt, yge, ylt,
+                    buffer + offsets[i]);
+  }
+
+  return offsets[nvars];
+}
+} // namespace
+
+class BoutMesh::PersistentCommPlan : public CommPlan {
+public:
+  PersistentCommPlan(BoutMesh& mesh, FieldGroup& g);
+  ~PersistentCommPlan() override;
+
+  PersistentCommPlan(const PersistentCommPlan&) = delete;
+  PersistentCommPlan& operator=(const PersistentCommPlan&) = delete;
+
+  void start() override;
+  void wait() override;
+
+private:
+  /// A contiguous range of points in one of the fields
+  struct Run {
+    int var;   ///< Index into vars
+    int start; ///< Index of the first point in the field's data
+    int count;
+  };
+
+  /// A message to or from one neighbour, with the points it contains
+  /// in the same order as pack_data/unpack_data
+  struct Message {
+    std::vector<Run> runs;
+    Array<BoutReal> buffer;
+  };
+
+  /// Add a message for the points with x in [xge, xlt) and y in [yge, ylt)
+  void addMessage(std::vector<Message>& messages, int xge, int xlt, int yge, int ylt);
+
+  /// Pointer to the start of each field's data
+  std::vector<BoutReal*> fieldData() const;
+
+  BoutMesh& bout_mesh;
+
+  /// Fields in the group, in communication order
+  std::vector<FieldData*> vars;
+
+  std::vector<Message> receives, sends;
+
+  /// Persistent requests: receives followed by sends
+  std::vector<MPI_Request> requests;
+
+  bool in_progress{false};
+  bool has_y_communication{false};
+};
+
+BoutMesh::PersistentCommPlan::PersistentCommPlan(BoutMesh& mesh, FieldGroup& g)
+    : CommPlan(mesh, g), bout_mesh(mesh), vars(group.get()) {
+  TRACE("BoutMesh::PersistentCommPlan");
+
+  for (const auto& var : vars) {
+    if (var->getMesh() != &mesh) {
+      throw BoutException("Fields in a communication plan must be on the same mesh");
+    }
+  }
+
+  // Same messages, tags and ordering as send(): x without corners, then y
+  struct Neighbour {
+    int proc;
+    int tag;
+    int xge, xlt, yge, ylt;
+  };
+  const int MXSUB = bout_mesh.MXSUB;
+  const int MYSUB = bout_mesh.MYSUB;
+  const int LocalNx = bout_mesh.LocalNx;
+  const int MXG = bout_mesh.MXG;
+  const int MYG = bout_mesh.MYG;
+
+  const std::vector<Neighbour> to_receive = {
+      {bout_mesh.UDATA_INDEST, IN_SENT_DOWN, 0, bout_mesh.UDATA_XSPLIT, MYSUB + MYG,
+       MYSUB + 2 * MYG},
+      {bout_mesh.UDATA_OUTDEST, OUT_SENT_DOWN, bout_mesh.UDATA_XSPLIT, LocalNx,
+       MYSUB + MYG, MYSUB + 2 * MYG},
+      {bout_mesh.DDATA_INDEST, IN_SENT_UP, 0, bout_mesh.DDATA_XSPLIT, 0, MYG},
+      {bout_mesh.DDATA_OUTDEST, OUT_SENT_UP, bout_mesh.DDATA_XSPLIT, LocalNx, 0, MYG},
+      {bout_mesh.IDATA_DEST, OUT_SENT_IN, 0, MXG, MYG, MYG + MYSUB},
+      {bout_mesh.ODATA_DEST, IN_SENT_OUT, MXSUB + MXG, MXSUB + 2 * MXG, MYG,
+       MYG + MYSUB},
+  };
+  const std::vector<Neighbour> to_send = {
+      {bout_mesh.IDATA_DEST, IN_SENT_OUT, MXG, 2 * MXG, MYG, MYG + MYSUB},
+      {bout_mesh.ODATA_DEST, OUT_SENT_IN, MXSUB, MXSUB + MXG, MYG, MYG + MYSUB},
+      {bout_mesh.UDATA_INDEST, IN_SENT_UP, 0, bout_mesh.UDATA_XSPLIT, MYSUB,
+       MYSUB + MYG},
+      {bout_mesh.UDATA_OUTDEST, OUT_SENT_UP, bout_mesh.UDATA_XSPLIT, LocalNx, MYSUB,
+       MYSUB + MYG},
+      {bout_mesh.DDATA_INDEST, IN_SENT_DOWN, 0, bout_mesh.DDATA_XSPLIT, MYG, 2 * MYG},
+      {bout_mesh.DDATA_OUTDEST, OUT_SENT_DOWN, bout_mesh.DDATA_XSPLIT, LocalNx, MYG,
+       2 * MYG},
+  };
+
+  // Requests are created after all messages are added, so that the
+  // buffers don't move
+  std::vector<const Neighbour*> receive_from, send_to;
+  for (const auto& neighbour : to_receive) {
+    if (neighbour.proc != -1) {
+      addMessage(receives, neighbour.xge, neighbour.xlt, neighbour.yge, neighbour.ylt);
+      receive_from.push_back(&neighbour);
+      has_y_communication = has_y_communication or (neighbour.tag <= OUT_SENT_DOWN);
+    }
+  }
+  for (const auto& neighbour : to_send) {
+    if (neighbour.proc != -1) {
+      addMessage(sends, neighbour.xge, neighbour.xlt, neighbour.yge, neighbour.ylt);
+      send_to.push_back(&neighbour);
+    }
+  }
+
+  requests.resize(receives.size() + sends.size(), MPI_REQUEST_NULL);
+  auto* mpi = bout_mesh.mpi;
+  for (std::size_t i = 0; i < receives.size(); ++i) {
+    auto& buffer = receives[i].buffer;
+    if (mpi->MPI_Recv_init(std::begin(buffer), buffer.size(), PVEC_REAL_MPI_TYPE,
+                           receive_from[i]->proc, receive_from[i]->tag, BoutComm::get(),
+                           &requests[i])
+        != MPI_SUCCESS) {
+      throw BoutException("MPI_Recv_init failed for processor {:d}, tag {:d}",
+                          receive_from[i]->proc, receive_from[i]->tag);
+    }
+  }
+  for (std::size_t i = 0; i < sends.size(); ++i) {
+    auto& buffer = sends[i].buffer;
+    if (mpi->MPI_Send_init(std::begin(buffer), buffer.size(), PVEC_REAL_MPI_TYPE,
+                           send_to[i]->proc, send_to[i]->tag, BoutComm::get(),
+                           &requests[receives.size() + i])
+        != MPI_SUCCESS) {
+      throw BoutException("MPI_Send_init failed for processor {:d}, tag {:d}",
+                          send_to[i]->proc, send_to[i]->tag);
+    }
+  }
+}
+
+BoutMesh::PersistentCommPlan::~PersistentCommPlan() {
+  if (in_progress) {
+    // Can't free requests which are still active
+    wait();
+  }
+  for (auto& request : requests) {
+    if (request != MPI_REQUEST_NULL) {
+      // Can't throw from a destructor
+      bout_mesh.mpi->MPI_Request_free(&request);
+    }
+  }
+}
+
+void BoutMesh::PersistentCommPlan::addMessage(std::vector<Message>& messages, int xge,
+                                              int xlt, int yge, int ylt) {
+  const int ny = bout_mesh.LocalNy;
+  const int nz = bout_mesh.LocalNz;
+
+  Message message;
+  int length = 0;
+  for (int var = 0; var < static_cast<int>(vars.size()); ++var) {
+    const int points_per_y = vars[var]->is3D() ? nz : 1;
+    const int count = (ylt - yge) * points_per_y;
+    if (count <= 0) {
+      continue;
+    }
+    for (int jx = xge; jx < xlt; ++jx) {
+      const int start = ((jx * ny) + yge) * points_per_y;
+      // Consecutive x ranges are contiguous if they cover all y
+      if (not message.runs.empty() and (message.runs.back().var == var)
+          and (message.runs.back().start + message.runs.back().count == start)) {
+        message.runs.back().count += count;
+      } else {
+        message.runs.push_back({var, start, count});
+      }
+      length += count;
+    }
+  }
+  message.buffer.reallocate(length);
+  messages.push_back(std::move(message));
+}
+
+std::vector<BoutReal*> BoutMesh::PersistentCommPlan::fieldData() const {
+  std::vector<BoutReal*> data;
+  data.reserve(vars.size());
+  for (const auto& var : vars) {
+    data.push_back(getFieldData(var));
+  }
+  return data;
+}
+
+void BoutMesh::PersistentCommPlan::start() {
+  Timer timer("comms");
+  BOUT_TIME_REGION("comms:send");
+
+  if (in_progress) {
+    throw BoutException("Communication plan started again before wait()");
+  }
+
+  auto* mpi = bout_mesh.mpi;
+  if (not receives.empty()
+      and (mpi->MPI_Startall(static_cast<int>(receives.size()), requests.data())
+           != MPI_SUCCESS)) {
+    throw BoutException("MPI_Startall failed for receives");
+  }
+
+  const auto data = fieldData();
+  for (auto& message : sends) {
+    BoutReal* buffer = std::begin(message.buffer);
+    for (const auto& run : message.runs) {
+      const BoutReal* source = data[run.var] + run.start;
+      std::copy(source, source + run.count, buffer);
+      buffer += run.count;
+    }
+  }
+  if (not sends.empty()
+      and (mpi->MPI_Startall(static_cast<int>(sends.size()),
+                             requests.data() + receives.size())
+           != MPI_SUCCESS)) {
+    throw BoutException("MPI_Startall failed for sends");
+  }
+
+  in_progress = true;
+}
+
+void BoutMesh::PersistentCommPlan::wait() {
+  TRACE("BoutMesh::PersistentCommPlan::wait()");
+
+  if (not in_progress) {
+    return;
+  }
+
+  Timer timer("comms");
+  BOUT_TIME_REGION("comms:wait");
+
+  auto* mpi = bout_mesh.mpi;
+  const auto data = fieldData();
+
+  // Unpack messages in the order they arrive
+  for (std::size_t received = 0; received < receives.size(); ++received) {
+    int ind = MPI_UNDEFINED;
+    MPI_Status status;
+    if (mpi->MPI_Waitany(static_cast<int>(receives.size()), requests.data(), &ind,
+                         &status)
+        != MPI_SUCCESS) {
+      in_progress = false;
+      throw BoutException("MPI_Waitany failed");
+    }
+    if (ind == MPI_UNDEFINED) {
+      break;
+    }
+    const BoutReal* buffer = std::begin(receives[ind].buffer);
+    for (const auto& run : receives[ind].runs) {
+      std::copy(buffer, buffer + run.count, data[run.var] + run.start);
+      buffer += run.count;
+    }
+  }
+
+  if (not sends.empty()
+      and (mpi->MPI_Waitall(static_cast<int>(sends.size()),
+                            requests.data() + receives.size(), MPI_STATUSES_IGNORE)
+           != MPI_SUCCESS)) {
+    in_progress = false;
+    throw BoutException("MPI_Waitall failed");
+  }
+
+  if (has_y_communication) {
+    bout_mesh.applyTwistShift(group);
+  }
 
 #if CHECK > 0
   // Keeping track of whether communications have been done
-  for (const auto& var : ch->var_list) {
+  for (const auto& var : group) {
     var->doneComms();
   }
 #endif
 
-  free_handle(ch);
+  in_progress = false;
+}
 
-  return 0;
+std::unique_ptr<CommPlan> BoutMesh::createCommPlan(FieldGroup& g) {
+  if (include_corner_cells) {
+    // Corner cells need y then x communication, which isn't
+    // supported by persistent plans
+    return Mesh::createCommPlan(g);
+  }
+  return bout::utils::make_unique<PersistentCommPlan>(*this, g);
 }
 
 /***************************************************************
@@ -2245,66 +2604,12 @@ void BoutMesh::overlapHandleMemory(BoutMesh* yup, BoutMesh* ydown, BoutMesh* xin
 
 int BoutMesh::pack_data(const std::vector<FieldData*>& var_list, int xge, int xlt,
                         int yge, int ylt, BoutReal* buffer) {
-
-  int len = 0;
-
-  /// Loop over variables
-  for (const auto& var : var_list) {
-    if (var->is3D()) {
-      // 3D variable
-      auto& var3d_ref = *dynamic_cast<Field3D*>(var);
-      ASSERT2(var3d_ref.isAllocated());
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++) {
-          for (int jz = 0; jz < LocalNz; jz++, len++) {
-            buffer[len] = var3d_ref(jx, jy, jz);
-          }
-        }
-      }
-    } else {
-      // 2D variable
-      auto& var2d_ref = *dynamic_cast<Field2D*>(var);
-      ASSERT2(var2d_ref.isAllocated());
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++, len++) {
-          buffer[len] = var2d_ref(jx, jy);
-        }
-      }
-    }
-  }
-
-  return (len);
+  return copyFields<true>(var_list, LocalNy, LocalNz, xge, xlt, yge, ylt, buffer);
 }
 
 int BoutMesh::unpack_data(const std::vector<FieldData*>& var_list, int xge, int xlt,
                           int yge, int ylt, BoutReal* buffer) {
-
-  int len = 0;
-
-  /// Loop over variables
-  for (const auto& var : var_list) {
-    if (var->is3D()) {
-      // 3D variable
-      auto& var3d_ref = *dynamic_cast<Field3D*>(var);
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++) {
-          for (int jz = 0; jz < LocalNz; jz++, len++) {
-            var3d_ref(jx, jy, jz) = buffer[len];
-          }
-        }
-      }
-    } else {
-      // 2D variable
-      auto& var2d_ref = *dynamic_cast<Field2D*>(var);
-      for (int jx = xge; jx != xlt; jx++) {
-        for (int jy = yge; jy < ylt; jy++, len++) {
-          var2d_ref(jx, jy) = buffer[len];
-        }
-      }
-    }
-  }
-
-  return (len);
+  return copyFields<false>(var_list, LocalNy, LocalNz, xge, xlt, yge, ylt, buffer);
 }
 
 /****************************************************************
@@ -3132,6 +3437,9 @@ void BoutMesh::outputVars(Options& output_options) {
   output_options["PE_XIND"].force(PE_XIND, "BoutMesh");
   output_options["PE_YIND"].force(PE_YIND, "BoutMesh");
   output_options["MYPE"].force(MYPE, "BoutMesh");
+  for (const auto* name : {"PE_XIND", "PE_YIND", "MYPE"}) {
+    output_options[name].attributes["per_processor"] = true;
+  }
   output_options["MXG"].force(MXG, "BoutMesh");
   output_options["MYG"].force(MYG, "BoutMesh");
   output_options["MZG"].force(MZG, "BoutMesh");
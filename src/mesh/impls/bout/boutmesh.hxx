@@ -55,6 +55,13 @@ public:
   /// @param[in] handle  The handle returned by send()
   int wait(comm_handle handle) override;
 
+  /// Create a plan which uses persistent MPI requests, so that the
+  /// messages only need to be set up once. If corner cells are
+  /// communicated this falls back to Mesh::createCommPlan
+  std::unique_ptr<CommPlan> createCommPlan(FieldGroup& g) override;
+  /// Make the overload taking fields visible
+  using Mesh::createCommPlan;
+
   /////////////////////////////////////////////
   // non-local communications
 
@@ -392,6 +399,13 @@ protected:
   /// Adds 2D and 3D regions for boundaries
   void addBoundaryRegions();
 
+  /// Take data from objects and put into a buffer
+  int pack_data(const std::vector<FieldData*>& var_list, int xge, int xlt, int yge,
+                int ylt, BoutReal* buffer);
+  /// Copy data from a buffer back into the fields
+  int unpack_data(const std::vector<FieldData*>& var_list, int xge, int xlt, int yge,
+                  int ylt, BoutReal* buffer);
+
 private:
   std::vector<BoundaryRegion*> boundary;        // Vector of boundary regions
   std::vector<BoundaryRegionPar*> par_boundary; // Vector of parallel boundary regions
@@ -430,6 +444,13 @@ private:
   void clear_handles();
   std::list<CommHandle*> comm_list; // List of allocated communication handles
 
+  /// Communication plan using persistent MPI requests
+  class PersistentCommPlan;
+
+  /// Shift the y-guard cells of field-aligned fields in \p g across
+  /// the twist-shift location, after they have been communicated
+  void applyTwistShift(FieldGroup& g);
+
   //////////////////////////////////////////////////
   // X communicator
 
@@ -455,13 +476,6 @@ private:
   /// Create the MPI requests to receive data in the y-direction. Non-blocking call.
   void post_receiveY(CommHandle& ch);
 
-  /// Take data from objects and put into a buffer
-  int pack_data(const std::vector<FieldData*>& var_list, int xge, int xlt, int yge,
-                int ylt, BoutReal* buffer);
-  /// Copy data from a buffer back into the fields
-
-  int unpack_data(const std::vector<FieldData*>& var_list, int xge, int xlt, int yge,
-                  int ylt, BoutReal* buffer);
 };
 
 namespace {
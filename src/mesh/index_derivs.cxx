@@ -446,34 +446,36 @@ public:
     }
     const int kmax = ncz / 2 - kfilter; // Up to and including this wavenumber index
 
-    BOUT_OMP(parallel)
-    {
-      Array<dcomplex> cv(ncz / 2 + 1);
-      const BoutReal kwaveFac = TWOPI / ncz;
-
-      // Note we lookup a 2D region here even though we're operating on a Field3D
-      // as we only want to loop over {x, y} and then handle z differently. The
-      // Region<Ind2D> blocks are constructed for elements contiguous assuming nz=1,
-      // as that isn't the case for Field3D (in general) this shouldn't be expected
-      // to vectorise (not that it would anyway) but it should still OpenMP parallelise
-      // ok.
-      // With this in mind we could perhaps avoid the use of the BOUT_FOR_INNER macro
-      // here,
-      // but should be ok for now.
-      BOUT_FOR_INNER(i, theMesh->getRegion2D(region)) {
-        auto i3D = theMesh->ind2Dto3D(i, 0);
-        rfft(&var[i3D], ncz, cv.begin()); // Forward FFT
-
+    const int nmodes = (ncz / 2) + 1;
+    const BoutReal kwaveFac = TWOPI / ncz;
+    const auto& region2D = theMesh->getRegion2D(region);
+
+    // Note we lookup a 2D region here even though we're operating on a Field3D
+    // as we only want to loop over {x, y} and then handle z differently. Each
+    // contiguous block of the Region<Ind2D> corresponds to a contiguous set of
+    // Z pencils in the Field3D, which we transform with a single batched FFT.
+    BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+    for (auto block = region2D.getBlocks().cbegin(); block < region2D.getBlocks().cend();
+         ++block) {
+      const int npencils = block->second.ind - block->first.ind;
+      const auto i3D = theMesh->ind2Dto3D(block->first, 0);
+      Matrix<dcomplex> cv(npencils, nmodes);
+
+      // Forward FFT
+      bout::fft::rfft_many(&var[i3D], ncz, npencils, ncz, &cv(0, 0), nmodes);
+
+      for (int i = 0; i < npencils; i++) {
         for (int jz = 0; jz <= kmax; jz++) {
           const BoutReal kwave = jz * kwaveFac; // wave number is 1/[rad]
-          cv[jz] *= dcomplex(0, kwave);
+          cv(i, jz) *= dcomplex(0, kwave);
         }
-        for (int jz = kmax + 1; jz <= ncz / 2; jz++) {
-          cv[jz] = 0.0;
+        for (int jz = kmax + 1; jz < nmodes; jz++) {
+          cv(i, jz) = 0.0;
         }
-
-        irfft(cv.begin(), ncz, &result[i3D]); // Reverse FFT
       }
+
+      // Reverse FFT
+      bout::fft::irfft_many(&cv(0, 0), ncz, npencils, nmodes, &result[i3D], ncz);
     }
   }
 
@@ -505,34 +507,36 @@ public:
     const int ncz = theMesh->getNpoints(direction);
     const int kmax = ncz / 2;
 
-    BOUT_OMP(parallel)
-    {
-      Array<dcomplex> cv(ncz / 2 + 1);
-      const BoutReal kwaveFac = TWOPI / ncz;
-
-      // Note we lookup a 2D region here even though we're operating on a Field3D
-      // as we only want to loop over {x, y} and then handle z differently. The
-      // Region<Ind2D> blocks are constructed for elements contiguous assuming nz=1,
-      // as that isn't the case for Field3D (in general) this shouldn't be expected
-      // to vectorise (not that it would anyway) but it should still OpenMP parallelise
-      // ok.
-      // With this in mind we could perhaps avoid the use of the BOUT_FOR_INNER macro
-      // here,
-      // but should be ok for now.
-      BOUT_FOR_INNER(i, theMesh->getRegion2D(region)) {
-        auto i3D = theMesh->ind2Dto3D(i, 0);
-        rfft(&var[i3D], ncz, cv.begin()); // Forward FFT
-
+    const int nmodes = (ncz / 2) + 1;
+    const BoutReal kwaveFac = TWOPI / ncz;
+    const auto& region2D = theMesh->getRegion2D(region);
+
+    // Note we lookup a 2D region here even though we're operating on a Field3D
+    // as we only want to loop over {x, y} and then handle z differently. Each
+    // contiguous block of the Region<Ind2D> corresponds to a contiguous set of
+    // Z pencils in the Field3D, which we transform with a single batched FFT.
+    BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+    for (auto block = region2D.getBlocks().cbegin(); block < region2D.getBlocks().cend();
+         ++block) {
+      const int npencils = block->second.ind - block->first.ind;
+      const auto i3D = theMesh->ind2Dto3D(block->first, 0);
+      Matrix<dcomplex> cv(npencils, nmodes);
+
+      // Forward FFT
+      bout::fft::rfft_many(&var[i3D], ncz, npencils, ncz, &cv(0, 0), nmodes);
+
+      for (int i = 0; i < npencils; i++) {
         for (int jz = 0; jz <= kmax; jz++) {
           const BoutReal kwave = jz * kwaveFac; // wave number is 1/[rad]
-          cv[jz] *= -kwave * kwave;
+          cv(i, jz) *= -kwave * kwave;
         }
-        for (int jz = kmax + 1; jz <= ncz / 2; jz++) {
-          cv[jz] = 0.0;
+        for (int jz = kmax + 1; jz < nmodes; jz++) {
+          cv(i, jz) = 0.0;
         }
-
-        irfft(cv.begin(), ncz, &result[i3D]); // Reverse FFT
       }
+
+      // Reverse FFT
+      bout::fft::irfft_many(&cv(0, 0), ncz, npencils, nmodes, &result[i3D], ncz);
     }
   }
 
@@ -25,36 +25,40 @@
 #include "bout/interpolation_xz.hxx"
 #include "bout/mesh.hxx"
 
+#include <algorithm>
 #include <vector>
 
 XZHermiteSpline::XZHermiteSpline(int y_offset, Mesh* mesh)
-    : XZInterpolation(y_offset, mesh), h00_x(localmesh), h01_x(localmesh),
-      h10_x(localmesh), h11_x(localmesh), h00_z(localmesh), h01_z(localmesh),
-      h10_z(localmesh), h11_z(localmesh) {
+    : XZInterpolation(y_offset, mesh) {
+
+  const int nx = localmesh->LocalNx;
+  const int ny = localmesh->LocalNy;
+  const int nz = localmesh->LocalNz;
 
   // Index arrays contain guard cells in order to get subscripts right
-  i_corner.reallocate(localmesh->LocalNx, localmesh->LocalNy, localmesh->LocalNz);
-  k_corner.reallocate(localmesh->LocalNx, localmesh->LocalNy, localmesh->LocalNz);
+  i_corner.reallocate(nx, ny, nz);
+  k_corner.reallocate(nx, ny, nz);
 
   // Initialise in order to avoid 'uninitialized value' errors from Valgrind when using
   // guard-cell values
   i_corner = -1;
   k_corner = -1;
 
-  // Allocate Field3D members
-  h00_x.allocate();
-  h01_x.allocate();
-  h10_x.allocate();
-  h11_x.allocate();
-  h00_z.allocate();
-  h01_z.allocate();
-  h10_z.allocate();
-  h11_z.allocate();
+  weights.reallocate(nweights, nx * ny * nz);
+  weights = 0.0;
+
+  // Points without weights read from the start of the field, so that
+  // the indices are always valid
+  corner_index.reallocate(nx * ny * nz);
+  corner_index_zp1.reallocate(nx * ny * nz);
+  std::fill(std::begin(corner_index), std::end(corner_index), 0);
+  std::fill(std::begin(corner_index_zp1), std::end(corner_index_zp1), 0);
 }
 
 void XZHermiteSpline::calcWeights(const Field3D& delta_x, const Field3D& delta_z,
                                   const std::string& region) {
 
+  const int ny = localmesh->LocalNy;
   const int ncz = localmesh->LocalNz;
   BOUT_FOR(i, delta_x.getRegion(region)) {
     const int x = i.x();
@@ -100,17 +104,21 @@ void XZHermiteSpline::calcWeights(const Field3D& delta_x, const Field3D& delta_z
           x, y, z, delta_z(x, y, z), k_corner(x, y, z));
     }
 
-    h00_x(x, y, z) = (2. * t_x * t_x * t_x) - (3. * t_x * t_x) + 1.;
-    h00_z(x, y, z) = (2. * t_z * t_z * t_z) - (3. * t_z * t_z) + 1.;
+    const int k_corner_p1 = (k_corner(x, y, z) + 1) % ncz;
+    corner_index[i.ind] = ((i_corner(x, y, z) * ny) + y) * ncz + k_corner(x, y, z);
+    corner_index_zp1[i.ind] = ((i_corner(x, y, z) * ny) + y) * ncz + k_corner_p1;
 
-    h01_x(x, y, z) = (-2. * t_x * t_x * t_x) + (3. * t_x * t_x);
-    h01_z(x, y, z) = (-2. * t_z * t_z * t_z) + (3. * t_z * t_z);
+    weights(h00_x, i.ind) = (2. * t_x * t_x * t_x) - (3. * t_x * t_x) + 1.;
+    weights(h00_z, i.ind) = (2. * t_z * t_z * t_z) - (3. * t_z * t_z) + 1.;
 
-    h10_x(x, y, z) = t_x * (1. - t_x) * (1. - t_x);
-    h10_z(x, y, z) = t_z * (1. - t_z) * (1. - t_z);
+    weights(h01_x, i.ind) = (-2. * t_x * t_x * t_x) + (3. * t_x * t_x);
+    weights(h01_z, i.ind) = (-2. * t_z * t_z * t_z) + (3. * t_z * t_z);
 
-    h11_x(x, y, z) = (t_x * t_x * t_x) - (t_x * t_x);
-    h11_z(x, y, z) = (t_z * t_z * t_z) - (t_z * t_z);
+    weights(h10_x, i.ind) = t_x * (1. - t_x) * (1. - t_x);
+    weights(h10_z, i.ind) = t_z * (1. - t_z) * (1. - t_z);
+
+    weights(h11_x, i.ind) = (t_x * t_x * t_x) - (t_x * t_x);
+    weights(h11_z, i.ind) = (t_z * t_z * t_z) - (t_z * t_z);
   }
 }
 
@@ -144,10 +152,27 @@ XZHermiteSpline::getWeightsForYApproximation(int i, int j, int k, int yoffset) {
   const int k_mod_p1 = (k_mod + 1) % ncz;
   const int k_mod_p2 = (k_mod + 2) % ncz;
 
-  return {{i, j + yoffset, k_mod_m1, -0.5 * h10_z(i, j, k)},
-          {i, j + yoffset, k_mod, h00_z(i, j, k) - 0.5 * h11_z(i, j, k)},
-          {i, j + yoffset, k_mod_p1, h01_z(i, j, k) + 0.5 * h10_z(i, j, k)},
-          {i, j + yoffset, k_mod_p2, 0.5 * h11_z(i, j, k)}};
+  const int ind = ((i * localmesh->LocalNy) + j) * ncz + k;
+
+  return {{i, j + yoffset, k_mod_m1, -0.5 * weights(h10_z, ind)},
+          {i, j + yoffset, k_mod, weights(h00_z, ind) - 0.5 * weights(h11_z, ind)},
+          {i, j + yoffset, k_mod_p1, weights(h01_z, ind) + 0.5 * weights(h10_z, ind)},
+          {i, j + yoffset, k_mod_p2, 0.5 * weights(h11_z, ind)}};
+}
+
+void XZHermiteSpline::calcDerivatives(const Field3D& f, Field3D& fx, Field3D& fz,
+                                      Field3D& fxz) const {
+  // The interpolation only reads points with x in [xstart, xend], but
+  // in the next y-slice, so only y-guard cells need communicating.
+  // fz is calculated everywhere from f, so needs no communication,
+  // and this also gives fxz the x-guard cells it needs
+  fz = bout::derivatives::index::DDZ(f, CELL_DEFAULT, "DEFAULT", "RGN_ALL");
+  fx = bout::derivatives::index::DDX(f, CELL_DEFAULT, "DEFAULT");
+  fxz = bout::derivatives::index::DDX(fz, CELL_DEFAULT, "DEFAULT");
+
+  // Communicate in y together, but do not calculate parallel slices
+  auto h = localmesh->sendY(fx, fxz);
+  localmesh->wait(h);
 }
 
 Field3D XZHermiteSpline::interpolate(const Field3D& f, const std::string& region) const {
@@ -157,75 +182,69 @@ Field3D XZHermiteSpline::interpolate(const Field3D& f, const std::string& region
 
   // Derivatives are used for tension and need to be on dimensionless
   // coordinates
-  Field3D fx = bout::derivatives::index::DDX(f, CELL_DEFAULT, "DEFAULT");
-  localmesh->communicateXZ(fx);
-  // communicate in y, but do not calculate parallel slices
-  {
-    auto h = localmesh->sendY(fx);
-    localmesh->wait(h);
-  }
-  Field3D fz = bout::derivatives::index::DDZ(f, CELL_DEFAULT, "DEFAULT", "RGN_ALL");
-  localmesh->communicateXZ(fz);
-  // communicate in y, but do not calculate parallel slices
-  {
-    auto h = localmesh->sendY(fz);
-    localmesh->wait(h);
-  }
-  Field3D fxz = bout::derivatives::index::DDX(fz, CELL_DEFAULT, "DEFAULT");
-  localmesh->communicateXZ(fxz);
-  // communicate in y, but do not calculate parallel slices
-  {
-    auto h = localmesh->sendY(fxz);
-    localmesh->wait(h);
-  }
+  Field3D fx, fz, fxz;
+  calcDerivatives(f, fx, fz, fxz);
+
+  // Raw pointers, so that the kernel is a set of contiguous streams
+  // over each block of the region, plus the gathers from the source
+  // fields
+  const BoutReal* f_data = &f(0, 0, 0);
+  const BoutReal* fx_data = &fx(0, 0, 0);
+  const BoutReal* fz_data = &fz(0, 0, 0);
+  const BoutReal* fxz_data = &fxz(0, 0, 0);
+  BoutReal* result = &f_interp(0, 0, 0);
+
+  const BoutReal* w00_x = &weights(h00_x, 0);
+  const BoutReal* w01_x = &weights(h01_x, 0);
+  const BoutReal* w10_x = &weights(h10_x, 0);
+  const BoutReal* w11_x = &weights(h11_x, 0);
+  const BoutReal* w00_z = &weights(h00_z, 0);
+  const BoutReal* w01_z = &weights(h01_z, 0);
+  const BoutReal* w10_z = &weights(h10_z, 0);
+  const BoutReal* w11_z = &weights(h11_z, 0);
+
+  // Offset to the next y-slice, and from i_corner to i_corner + 1
+  const int y_shift = y_offset * localmesh->LocalNz;
+  const int x_stride = localmesh->LocalNy * localmesh->LocalNz;
 
   BOUT_FOR(i, f.getRegion(region)) {
-    const int x = i.x();
-    const int y = i.y();
-    const int z = i.z();
+    const int ind = i.ind;
 
-    if (skip_mask(x, y, z)) {
+    if (skip_mask(i.x(), i.y(), i.z())) {
       continue;
     }
 
-    // Due to lack of guard cells in z-direction, we need to ensure z-index
-    // wraps around
-    const int z_mod = k_corner(x, y, z);
-    const int z_mod_p1 = (z_mod + 1) % localmesh->LocalNz;
-
-    const int y_next = y + y_offset;
+    // Source points at (i_corner, k_corner), (i_corner + 1, k_corner)
+    // and the same at k_corner + 1, in the next y-slice
+    const int ic_z = corner_index[ind] + y_shift;
+    const int ic_zp1 = corner_index_zp1[ind] + y_shift;
+    const int icp1_z = ic_z + x_stride;
+    const int icp1_zp1 = ic_zp1 + x_stride;
 
     // Interpolate f in X at Z
-    const BoutReal f_z = f(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z)
-                         + f(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z)
-                         + fx(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z)
-                         + fx(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
+    const BoutReal f_z = f_data[ic_z] * w00_x[ind] + f_data[icp1_z] * w01_x[ind]
+                         + fx_data[ic_z] * w10_x[ind] + fx_data[icp1_z] * w11_x[ind];
 
     // Interpolate f in X at Z+1
-    const BoutReal f_zp1 = f(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z)
-                           + f(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z)
-                           + fx(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z)
-                           + fx(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
+    const BoutReal f_zp1 = f_data[ic_zp1] * w00_x[ind] + f_data[icp1_zp1] * w01_x[ind]
+                           + fx_data[ic_zp1] * w10_x[ind]
+                           + fx_data[icp1_zp1] * w11_x[ind];
 
     // Interpolate fz in X at Z
-    const BoutReal fz_z = fz(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z)
-                          + fz(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z)
-                          + fxz(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z)
-                          + fxz(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
+    const BoutReal fz_z = fz_data[ic_z] * w00_x[ind] + fz_data[icp1_z] * w01_x[ind]
+                          + fxz_data[ic_z] * w10_x[ind] + fxz_data[icp1_z] * w11_x[ind];
 
     // Interpolate fz in X at Z+1
-    const BoutReal fz_zp1 =
-        fz(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z)
-        + fz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z)
-        + fxz(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z)
-        + fxz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
+    const BoutReal fz_zp1 = fz_data[ic_zp1] * w00_x[ind] + fz_data[icp1_zp1] * w01_x[ind]
+                            + fxz_data[ic_zp1] * w10_x[ind]
+                            + fxz_data[icp1_zp1] * w11_x[ind];
 
     // Interpolate in Z
-    f_interp(x, y_next, z) = +f_z * h00_z(x, y, z) + f_zp1 * h01_z(x, y, z)
-                             + fz_z * h10_z(x, y, z) + fz_zp1 * h11_z(x, y, z);
+    result[ind + y_shift] = +f_z * w00_z[ind] + f_zp1 * w01_z[ind] + fz_z * w10_z[ind]
+                            + fz_zp1 * w11_z[ind];
 
-    ASSERT2(std::isfinite(f_interp(x, y_next, z)) || x < localmesh->xstart
-            || x > localmesh->xend);
+    ASSERT2(std::isfinite(result[ind + y_shift]) || i.x() < localmesh->xstart
+            || i.x() > localmesh->xend);
   }
   return f_interp;
 }
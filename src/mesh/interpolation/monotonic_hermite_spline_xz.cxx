@@ -36,73 +36,64 @@ Field3D XZMonotonicHermiteSpline::interpolate(const Field3D& f,
 
   // Derivatives are used for tension and need to be on dimensionless
   // coordinates
-  Field3D fx = bout::derivatives::index::DDX(f, CELL_DEFAULT, "DEFAULT");
-  localmesh->communicateXZ(fx);
-  // communicate in y, but do not calculate parallel slices
-  {
-    auto h = localmesh->sendY(fx);
-    localmesh->wait(h);
-  }
-  Field3D fz = bout::derivatives::index::DDZ(f, CELL_DEFAULT, "DEFAULT", "RGN_ALL");
-  localmesh->communicateXZ(fz);
-  // communicate in y, but do not calculate parallel slices
-  {
-    auto h = localmesh->sendY(fz);
-    localmesh->wait(h);
-  }
-  Field3D fxz = bout::derivatives::index::DDX(fz, CELL_DEFAULT, "DEFAULT");
-  localmesh->communicateXZ(fxz);
-  // communicate in y, but do not calculate parallel slices
-  {
-    auto h = localmesh->sendY(fxz);
-    localmesh->wait(h);
-  }
+  Field3D fx, fz, fxz;
+  calcDerivatives(f, fx, fz, fxz);
+
+  const BoutReal* f_data = &f(0, 0, 0);
+  const BoutReal* fx_data = &fx(0, 0, 0);
+  const BoutReal* fz_data = &fz(0, 0, 0);
+  const BoutReal* fxz_data = &fxz(0, 0, 0);
+  BoutReal* f_interp_data = &f_interp(0, 0, 0);
+
+  const BoutReal* w00_x = &weights(h00_x, 0);
+  const BoutReal* w01_x = &weights(h01_x, 0);
+  const BoutReal* w10_x = &weights(h10_x, 0);
+  const BoutReal* w11_x = &weights(h11_x, 0);
+  const BoutReal* w00_z = &weights(h00_z, 0);
+  const BoutReal* w01_z = &weights(h01_z, 0);
+  const BoutReal* w10_z = &weights(h10_z, 0);
+  const BoutReal* w11_z = &weights(h11_z, 0);
+
+  // Offset to the next y-slice, and from i_corner to i_corner + 1
+  const int y_shift = y_offset * localmesh->LocalNz;
+  const int x_stride = localmesh->LocalNy * localmesh->LocalNz;
 
   BOUT_FOR(i, f.getRegion(region)) {
+    const int ind = i.ind;
     const int x = i.x();
-    const int y = i.y();
-    const int z = i.z();
 
-    if (skip_mask(x, y, z)) {
+    if (skip_mask(x, i.y(), i.z())) {
       continue;
     }
 
-    // Due to lack of guard cells in z-direction, we need to ensure z-index
-    // wraps around
-    const int ncz = localmesh->LocalNz;
-    const int z_mod = ((k_corner(x, y, z) % ncz) + ncz) % ncz;
-    const int z_mod_p1 = (z_mod + 1) % ncz;
-
-    const int y_next = y + y_offset;
+    // Source points at (i_corner, k_corner), (i_corner + 1, k_corner)
+    // and the same at k_corner + 1, in the next y-slice
+    const int ic_z = corner_index[ind] + y_shift;
+    const int ic_zp1 = corner_index_zp1[ind] + y_shift;
+    const int icp1_z = ic_z + x_stride;
+    const int icp1_zp1 = ic_zp1 + x_stride;
 
     // Interpolate f in X at Z
-    const BoutReal f_z = f(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z)
-                         + f(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z)
-                         + fx(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z)
-                         + fx(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
+    const BoutReal f_z = f_data[ic_z] * w00_x[ind] + f_data[icp1_z] * w01_x[ind]
+                         + fx_data[ic_z] * w10_x[ind] + fx_data[icp1_z] * w11_x[ind];
 
     // Interpolate f in X at Z+1
-    const BoutReal f_zp1 = f(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z)
-                           + f(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z)
-                           + fx(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z)
-                           + fx(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
+    const BoutReal f_zp1 = f_data[ic_zp1] * w00_x[ind] + f_data[icp1_zp1] * w01_x[ind]
+                           + fx_data[ic_zp1] * w10_x[ind]
+                           + fx_data[icp1_zp1] * w11_x[ind];
 
     // Interpolate fz in X at Z
-    const BoutReal fz_z = fz(i_corner(x, y, z), y_next, z_mod) * h00_x(x, y, z)
-                          + fz(i_corner(x, y, z) + 1, y_next, z_mod) * h01_x(x, y, z)
-                          + fxz(i_corner(x, y, z), y_next, z_mod) * h10_x(x, y, z)
-                          + fxz(i_corner(x, y, z) + 1, y_next, z_mod) * h11_x(x, y, z);
+    const BoutReal fz_z = fz_data[ic_z] * w00_x[ind] + fz_data[icp1_z] * w01_x[ind]
+                          + fxz_data[ic_z] * w10_x[ind] + fxz_data[icp1_z] * w11_x[ind];
 
     // Interpolate fz in X at Z+1
-    const BoutReal fz_zp1 =
-        fz(i_corner(x, y, z), y_next, z_mod_p1) * h00_x(x, y, z)
-        + fz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h01_x(x, y, z)
-        + fxz(i_corner(x, y, z), y_next, z_mod_p1) * h10_x(x, y, z)
-        + fxz(i_corner(x, y, z) + 1, y_next, z_mod_p1) * h11_x(x, y, z);
+    const BoutReal fz_zp1 = fz_data[ic_zp1] * w00_x[ind] + fz_data[icp1_zp1] * w01_x[ind]
+                            + fxz_data[ic_zp1] * w10_x[ind]
+                            + fxz_data[icp1_zp1] * w11_x[ind];
 
     // Interpolate in Z
-    BoutReal result = +f_z * h00_z(x, y, z) + f_zp1 * h01_z(x, y, z)
-                      + fz_z * h10_z(x, y, z) + fz_zp1 * h11_z(x, y, z);
+    BoutReal result = +f_z * w00_z[ind] + f_zp1 * w01_z[ind] + fz_z * w10_z[ind]
+                      + fz_zp1 * w11_z[ind];
 
     ASSERT2(std::isfinite(result) || x < localmesh->xstart || x > localmesh->xend);
 
@@ -112,15 +103,11 @@ Field3D XZMonotonicHermiteSpline::interpolate(const Field3D& f,
     // but also degrades accuracy near maxima and minima.
     // Perhaps should only impose near boundaries, since that is where
     // problems most obviously occur.
-    const BoutReal localmax = BOUTMAX(f(i_corner(x, y, z), y_next, z_mod),
-                                      f(i_corner(x, y, z) + 1, y_next, z_mod),
-                                      f(i_corner(x, y, z), y_next, z_mod_p1),
-                                      f(i_corner(x, y, z) + 1, y_next, z_mod_p1));
+    const BoutReal localmax =
+        BOUTMAX(f_data[ic_z], f_data[icp1_z], f_data[ic_zp1], f_data[icp1_zp1]);
 
-    const BoutReal localmin = BOUTMIN(f(i_corner(x, y, z), y_next, z_mod),
-                                      f(i_corner(x, y, z) + 1, y_next, z_mod),
-                                      f(i_corner(x, y, z), y_next, z_mod_p1),
-                                      f(i_corner(x, y, z) + 1, y_next, z_mod_p1));
+    const BoutReal localmin =
+        BOUTMIN(f_data[ic_z], f_data[icp1_z], f_data[ic_zp1], f_data[icp1_zp1]);
 
     ASSERT2(std::isfinite(localmax) || x < localmesh->xstart || x > localmesh->xend);
     ASSERT2(std::isfinite(localmin) || x < localmesh->xstart || x > localmesh->xend);
@@ -132,7 +119,7 @@ Field3D XZMonotonicHermiteSpline::interpolate(const Field3D& f,
       result = localmin;
     }
 
-    f_interp(x, y_next, z) = result;
+    f_interp_data[ind + y_shift] = result;
   }
   return f_interp;
 }
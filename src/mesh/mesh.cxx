@@ -344,6 +344,50 @@ void Mesh::communicate(FieldGroup& g) {
   }
 }
 
+void CommPlan::communicate() {
+  TRACE("CommPlan::communicate()");
+
+  start();
+  wait();
+
+  // Calculate yup and ydown fields for 3D fields
+  if (mesh.calcParallelSlices_on_communicate) {
+    for (const auto& fptr : group.field3d()) {
+      fptr->calcParallelSlices();
+    }
+  }
+}
+
+namespace {
+/// Plan which repeats the same calls as Mesh::communicate, for meshes
+/// which don't have persistent communications
+class GenericCommPlan : public CommPlan {
+public:
+  using CommPlan::CommPlan;
+
+  void start() override {
+    // With corner cells, y must be communicated before x
+    handle = mesh.include_corner_cells ? mesh.sendY(group) : mesh.send(group);
+  }
+
+  void wait() override {
+    mesh.wait(handle);
+    if (mesh.include_corner_cells) {
+      handle = mesh.sendX(group);
+      mesh.wait(handle);
+    }
+    handle = nullptr;
+  }
+
+private:
+  comm_handle handle{nullptr};
+};
+} // namespace
+
+std::unique_ptr<CommPlan> Mesh::createCommPlan(FieldGroup& g) {
+  return bout::utils::make_unique<GenericCommPlan>(*this, g);
+}
+
 /// This is a bit of a hack for now to get FieldPerp communications
 /// The FieldData class needs to be changed to accomodate FieldPerp objects
 void Mesh::communicate(FieldPerp& f) {
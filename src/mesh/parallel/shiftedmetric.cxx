@@ -164,8 +164,14 @@ Field3D ShiftedMetric::shiftZ(const Field3D& f, const Tensor<dcomplex>& phs,
 
   Field3D result{emptyFrom(f).setDirectionY(y_direction_out)};
 
-  BOUT_FOR(i, mesh.getRegion2D(toString(region))) {
-    shiftZ(&f(i, 0), &phs(i.x(), i.y(), 0), &result(i, 0));
+  // Each contiguous block of the 2D region is a contiguous set of Z
+  // pencils, so shift each block with a single batched FFT
+  const auto& region2D = mesh.getRegion2D(toString(region));
+  BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+  for (auto block = region2D.getBlocks().cbegin(); block < region2D.getBlocks().cend();
+       ++block) {
+    const auto& i = block->first;
+    shiftZ(&f(i, 0), &phs(i.x(), i.y(), 0), &result(i, 0), block->second.ind - i.ind);
   }
 
   return result;
@@ -194,30 +200,38 @@ FieldPerp ShiftedMetric::shiftZ(const FieldPerp& f, const Tensor<dcomplex>& phs,
   return result;
 }
 
-void ShiftedMetric::shiftZ(const BoutReal* in, const dcomplex* phs, BoutReal* out) const {
+void ShiftedMetric::shiftZ(const BoutReal* in, const dcomplex* phs, BoutReal* out,
+                           int npencils) const {
+  const int nz = mesh.LocalNz;
+
 #if BOUT_HAS_UMPIRE
   // TODO: This static keyword is a hotfix and should be removed in
   //      future iterations. It is here because otherwise many allocations
   //      lead to very poor performance
   static Array<dcomplex> cmplx(nmodes);
 #warning static hotfix used in ShiftedMetric::shiftZ. Not thread-safe.
+  if (cmplx.size() < npencils * nmodes) {
+    cmplx.reallocate(npencils * nmodes);
+  }
 #else
-  Array<dcomplex> cmplx(nmodes);
+  Array<dcomplex> cmplx(npencils * nmodes);
 #endif
 
-  // Take forward FFT
-  rfft(in, mesh.LocalNz, &cmplx[0]);
+  // Take forward FFT of all the pencils
+  bout::fft::rfft_many(in, nz, npencils, nz, &cmplx[0], nmodes);
 
   // Following is an algorithm approach to write a = a*b where a and b are
   // vectors of dcomplex.
   //  std::transform(cmplxOneOff.begin(),cmplxOneOff.end(), ptr.begin(),
   //		 cmplxOneOff.begin(), std::multiplies<dcomplex>());
 
-  for (int jz = 1; jz < nmodes; jz++) {
-    cmplx[jz] *= phs[jz];
+  for (int i = 0; i < npencils; i++) {
+    for (int jz = 1; jz < nmodes; jz++) {
+      cmplx[(i * nmodes) + jz] *= phs[(i * nmodes) + jz];
+    }
   }
 
-  irfft(&cmplx[0], mesh.LocalNz, out); // Reverse FFT
+  bout::fft::irfft_many(&cmplx[0], nz, npencils, nmodes, out, nz); // Reverse FFT
 }
 
 void ShiftedMetric::calcParallelSlices(Field3D& f) {
@@ -232,12 +246,15 @@ void ShiftedMetric::calcParallelSlices(Field3D& f) {
   for (const auto& phase : parallel_slice_phases) {
     auto& f_slice = f.ynext(phase.y_offset);
     f_slice.allocate();
-    BOUT_FOR(i, mesh.getRegion2D("RGN_NOY")) {
-      const int ix = i.x();
-      const int iy = i.y();
+    const auto& region2D = mesh.getRegion2D("RGN_NOY");
+    BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+    for (auto block = region2D.getBlocks().cbegin();
+         block < region2D.getBlocks().cend(); ++block) {
+      const int ix = block->first.x();
+      const int iy = block->first.y();
       const int iy_offset = iy + phase.y_offset;
       shiftZ(&(f(ix, iy_offset, 0)), &(phase.phase_shift(ix, iy, 0)),
-             &(f_slice(ix, iy_offset, 0)));
+             &(f_slice(ix, iy_offset, 0)), block->second.ind - block->first.ind);
     }
   }
 }
@@ -251,19 +268,15 @@ ShiftedMetric::shiftZ(const Field3D& f,
 
   const int nmodes = mesh.LocalNz / 2 + 1;
 
-  // FFT in Z of input field at each (x, y) point
-  Matrix<Array<dcomplex>> f_fft(mesh.LocalNx, mesh.LocalNy);
-  f_fft = Array<dcomplex>(nmodes);
-
-  BOUT_FOR(i, mesh.getRegion2D("RGN_ALL")) {
-    int ix = i.x();
-    int iy = i.y();
-    f_fft(ix, iy).ensureUnique();
-    rfft(&f(i, 0), mesh.LocalNz, f_fft(ix, iy).begin());
-  }
+  // FFT in Z of input field at each (x, y) point, all in one go
+  Tensor<dcomplex> f_fft(mesh.LocalNx, mesh.LocalNy, nmodes);
+  bout::fft::rfft_many(&f(0, 0, 0), mesh.LocalNz, mesh.LocalNx * mesh.LocalNy,
+                       mesh.LocalNz, &f_fft(0, 0, 0), nmodes);
 
   std::vector<Field3D> results{};
 
+  const auto& region2D = mesh.getRegion2D("RGN_NOY");
+
   for (auto& phase : phases) {
     // In C++17 std::vector::emplace_back returns a reference, which
     // would be very useful here!
@@ -272,19 +285,29 @@ ShiftedMetric::shiftZ(const Field3D& f,
     current_result.allocate();
     current_result.setLocation(f.getLocation());
 
-    BOUT_FOR(i, mesh.getRegion2D("RGN_NOY")) {
-      // Deep copy the FFT'd field
-      int ix = i.x();
-      int iy = i.y();
-
-      Array<dcomplex> shifted_temp(f_fft(ix, iy + phase.y_offset));
-      shifted_temp.ensureUnique();
-
-      for (int jz = 1; jz < nmodes; ++jz) {
-        shifted_temp[jz] *= phase.phase_shift(ix, iy, jz);
+    BOUT_OMP(parallel for schedule(BOUT_OPENMP_SCHEDULE))
+    for (auto block = region2D.getBlocks().cbegin();
+         block < region2D.getBlocks().cend(); ++block) {
+      const int npencils = block->second.ind - block->first.ind;
+      const int ix = block->first.x();
+      const int iy = block->first.y();
+
+      // Deep copy the FFT'd field for the pencils in this block
+      Matrix<dcomplex> shifted_temp(npencils, nmodes);
+      const dcomplex* f_fft_block = &f_fft(ix, iy + phase.y_offset, 0);
+      const dcomplex* phase_block = &phase.phase_shift(ix, iy, 0);
+
+      for (int i = 0; i < npencils; ++i) {
+        shifted_temp(i, 0) = f_fft_block[i * nmodes];
+        for (int jz = 1; jz < nmodes; ++jz) {
+          shifted_temp(i, jz) = f_fft_block[(i * nmodes) + jz]
+                                * phase_block[(i * nmodes) + jz];
+        }
       }
 
-      irfft(shifted_temp.begin(), mesh.LocalNz, &current_result(i.yp(phase.y_offset), 0));
+      bout::fft::irfft_many(&shifted_temp(0, 0), mesh.LocalNz, npencils, nmodes,
+                            &current_result(block->first.yp(phase.y_offset), 0),
+                            mesh.LocalNz);
     }
   }
 
@@ -72,18 +72,100 @@ bool DataFileFacade::write() {
 }
 } // namespace bout
 
+namespace {
+/// Number of writes which can wait to be written to a file by a
+/// separate thread, from the file's section \p options. Zero if the
+/// file is written immediately
+int asyncQueueLength(Options& options) {
+  if (not options["async"]
+              .doc("Write the file on a separate thread, while the simulation continues")
+              .withDefault(false)) {
+    return 0;
+  }
+  const int queue_length =
+      options["async_queue"]
+          .doc("Number of outputs which can wait to be written. If full, the "
+               "simulation waits")
+          .withDefault(1);
+  if (queue_length < 1) {
+    throw BoutException("{:s}:async_queue must be at least 1, got {:d}", options.str(),
+                        queue_length);
+  }
+  return queue_length;
+}
+
+/// Attributes which set how variables are written to the output file,
+/// unless they set them themselves, from its section \p options
+std::map<std::string, Options::AttributeType> outputAttributes(Options& options) {
+  std::map<std::string, Options::AttributeType> attributes;
+  if (options["floats"]
+          .doc("Write fields as 32-bit floats rather than doubles")
+          .withDefault(false)) {
+    attributes["precision"] = "float";
+  }
+  attributes["guard_cells"] =
+      options["guards"].doc("Write the guard cells of fields").withDefault(true);
+  attributes["compress"] = options["compress"]
+                               .doc("Compress fields with 'zlib' or 'zstd', or 'none'")
+                               .withDefault<std::string>("none");
+  attributes["compress_level"] =
+      options["compress_level"].doc("Level of compression").withDefault(4);
+  attributes["significant_bits"] =
+      options["significant_bits"]
+          .doc("Bits of the mantissa of fields to keep, rounding the others so "
+               "that they compress better. 0 keeps them all")
+          .withDefault(0);
+  return attributes;
+}
+
+/// The main output file, which is either one file per processor, or
+/// one file shared by all processors
+bout::OptionsNetCDF makeOutputFile(Options& root) {
+  const auto mode = root["append"]
+                            .doc("Add output data to existing (dump) files?")
+                            .withDefault(false)
+                        ? bout::OptionsNetCDF::FileMode::append
+                        : bout::OptionsNetCDF::FileMode::replace;
+
+  auto& options = root["output"];
+  if (not options["shared"]
+              .doc("Write one output file from all processors, using parallel NetCDF")
+              .withDefault(false)) {
+    bout::OptionsNetCDF file(bout::getOutputFilename(root), mode,
+                             asyncQueueLength(options));
+    file.setDefaultAttributes(outputAttributes(options));
+    return file;
+  }
+
+#if BOUT_HAS_NETCDF && !BOUT_HAS_LEGACY_NETCDF
+  if (asyncQueueLength(options) > 0) {
+    throw BoutException("output:async can't be used with output:shared");
+  }
+  // Any values in [output:mpi_hints] are passed to MPI-IO, for
+  // example cb_nodes or cb_buffer_size for collective buffering
+  bout::SharedFile shared{BoutComm::get(), {}};
+  auto& hints = options["mpi_hints"];
+  for (const auto& hint : hints.getChildren()) {
+    shared.hints[hint.first] = hints[hint.first].as<std::string>();
+  }
+  bout::OptionsNetCDF file(bout::getSharedOutputFilename(root), shared, mode);
+  file.setDefaultAttributes(outputAttributes(options));
+  return file;
+#else
+  throw BoutException("output:shared needs BOUT++ to be built with NetCDF");
+#endif
+}
+} // namespace
+
 PhysicsModel::PhysicsModel()
     : mesh(bout::globals::mesh),
-      output_file(bout::getOutputFilename(Options::root()),
-                  Options::root()["append"]
-                          .doc("Add output data to existing (dump) files?")
-                          .withDefault(false)
-                      ? bout::OptionsNetCDF::FileMode::append
-                      : bout::OptionsNetCDF::FileMode::replace),
+      output_file(makeOutputFile(Options::root())),
       output_enabled(Options::root()["output"]["enabled"]
                          .doc("Write output files")
                          .withDefault(true)),
-      restart_file(bout::getRestartFilename(Options::root())),
+      restart_file(bout::getRestartFilename(Options::root()),
+                   bout::OptionsNetCDF::FileMode::replace,
+                   asyncQueueLength(Options::root()["restart_files"])),
       restart_enabled(Options::root()["restart_files"]["enabled"]
                           .doc("Write restart files")
                           .withDefault(true)) {}
@@ -244,6 +326,16 @@ void PhysicsModel::finishOutputTimestep() const {
   }
 }
 
+void PhysicsModel::finishOutput() {
+  Timer timer("io");
+  if (output_enabled) {
+    output_file.flush();
+  }
+  if (restart_enabled) {
+    restart_file.flush();
+  }
+}
+
 int PhysicsModel::PhysicsModelMonitor::call(Solver* solver, BoutReal simtime,
                                             int iteration, int nout) {
   // Restart file variables
@@ -20,7 +20,9 @@ EulerSolver::EulerSolver(Options* options)
                      .withDefault(2.)),
       timestep((*options)["timestep"]
                    .doc("Internal timestep (defaults to output timestep)")
-                   .withDefault(getOutputTimestep())) {}
+                   .withDefault(getOutputTimestep())) {
+  can_alias_state = true;
+}
 
 void EulerSolver::setMaxTimestep(BoutReal dt) {
   if (dt >= cfl_factor * timestep) {
@@ -17,7 +17,9 @@ RK3SSP::RK3SSP(Options* opt)
       timestep((*options)["timestep"].doc("Starting timestep").withDefault(max_timestep)),
       mxstep((*options)["mxstep"]
                  .doc("Maximum number of steps between outputs")
-                 .withDefault(500)) {}
+                 .withDefault(500)) {
+  can_alias_state = true;
+}
 
 void RK3SSP::setMaxTimestep(BoutReal dt) {
   if (dt > timestep) {
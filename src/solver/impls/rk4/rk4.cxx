@@ -25,6 +25,7 @@ RK4Solver::RK4Solver(Options* opts)
                    .doc("Adapt internal timestep using 'atol' and 'rtol'.")
                    .withDefault(false)) {
   canReset = true;
+  can_alias_state = true;
 }
 
 void RK4Solver::setMaxTimestep(BoutReal dt) {
@@ -47,9 +48,11 @@ int RK4Solver::init() {
   // Calculate number of variables
   nlocal = getLocalN();
 
-  // Get total problem size
+  // Get total problem size. With zero_copy the state vector also
+  // holds guard cells, which mustn't count towards the error norm
+  int nevolved = getLocalEvolvedN();
   int ntmp;
-  if (bout::globals::mpi->MPI_Allreduce(&nlocal, &ntmp, 1, MPI_INT, MPI_SUM,
+  if (bout::globals::mpi->MPI_Allreduce(&nevolved, &ntmp, 1, MPI_INT, MPI_SUM,
                                         BoutComm::get())) {
     throw BoutException("MPI_Allreduce failed!");
   }
@@ -26,6 +26,7 @@ RKGenericSolver::RKGenericSolver(Options* opts)
                    .withDefault(true)),
       scheme(RKSchemeFactory::getInstance().create(options)) {
   canReset = true;
+  can_alias_state = true;
 }
 
 void RKGenericSolver::setMaxTimestep(BoutReal dt) {
@@ -49,9 +50,11 @@ int RKGenericSolver::init() {
   // Calculate number of variables
   nlocal = getLocalN();
 
-  // Get total problem size
+  // Get total problem size. With zero_copy the state vector also
+  // holds guard cells, which mustn't count towards the error norm
+  int nevolved = getLocalEvolvedN();
   int ntmp;
-  if (bout::globals::mpi->MPI_Allreduce(&nlocal, &ntmp, 1, MPI_INT, MPI_SUM,
+  if (bout::globals::mpi->MPI_Allreduce(&nevolved, &ntmp, 1, MPI_INT, MPI_SUM,
                                         BoutComm::get())) {
     throw BoutException("MPI_Allreduce failed!");
   }
@@ -32,6 +32,7 @@ SplitRK::SplitRK(Options* opts)
   ASSERT0(max_timestep_change > 1.0);
   ASSERT0(mxstep > 0);
   ASSERT0(nstages > 1);
+  can_alias_state = true;
 }
 
 int SplitRK::init() {
@@ -43,8 +44,10 @@ int SplitRK::init() {
   // Calculate number of variables
   nlocal = getLocalN();
 
-  // Get total problem size
-  if (bout::globals::mpi->MPI_Allreduce(&nlocal, &neq, 1, MPI_INT, MPI_SUM,
+  // Get total problem size. With zero_copy the state vector also
+  // holds guard cells, which mustn't count towards the error norm
+  int nevolved = getLocalEvolvedN();
+  if (bout::globals::mpi->MPI_Allreduce(&nevolved, &neq, 1, MPI_INT, MPI_SUM,
                                         BoutComm::get())) {
     throw BoutException("MPI_Allreduce failed!");
   }
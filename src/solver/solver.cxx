@@ -36,7 +36,9 @@
 #include "bout/sys/timer.hxx"
 #include "bout/sys/uuid.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <ctime>
 #include <numeric>
@@ -574,7 +576,23 @@ int Solver::solve(int nout, BoutReal timestep) {
 
   int status;
   try {
-    status = run();
+    {
+      // With zero_copy the evolving variables point into the state
+      // vector, which is freed along with the solver, so they need
+      // their own memory back however run() exits
+      struct UnaliasOnExit {
+        Solver& solver;
+        ~UnaliasOnExit() {
+          if (solver.zero_copy) {
+            solver.unalias_vars();
+          }
+        }
+      } unalias_on_exit{*this};
+
+      status = run();
+    }
+
+    model->finishOutput();
 
     time_t end_time = time(nullptr);
     output_progress.write(_("\nRun finished at  : {:s}\n"), toString(end_time));
@@ -670,6 +688,32 @@ int Solver::init() {
   /// Mark as initialised. No more variables can be added
   initialised = true;
 
+  const bool zero_copy_requested =
+      (*options)["zero_copy"]
+          .doc("Make evolving variables share memory with the solver state, rather "
+               "than copying them. Only supported by some explicit solvers")
+          .withDefault(false);
+
+  if (zero_copy_requested and not can_alias_state) {
+    output_warn.write(_("WARNING: solver does not support 'zero_copy', ignoring\n"));
+  }
+  zero_copy = zero_copy_requested and can_alias_state;
+
+  if (zero_copy) {
+    // Use global mesh: FIX THIS!
+    Mesh* mesh = bout::globals::mesh;
+
+    frozen_2d = mesh->getRegion2D("RGN_ALL");
+    frozen_2d.mask(mesh->getRegion2D("RGN_NOBNDRY"));
+    frozen_2d_evolve_bndry = frozen_2d;
+    frozen_2d_evolve_bndry.mask(mesh->getRegion2D("RGN_BNDRY"));
+
+    frozen_3d = mesh->getRegion3D("RGN_ALL");
+    frozen_3d.mask(mesh->getRegion3D("RGN_NOBNDRY"));
+    frozen_3d_evolve_bndry = frozen_3d;
+    frozen_3d_evolve_bndry.mask(mesh->getRegion3D("RGN_BNDRY"));
+  }
+
   return 0;
 }
 
@@ -983,21 +1027,34 @@ int Solver::getLocalN() {
 
   // Cache the value, so this is not repeatedly called.
   // This value should not change after initialisation
-  static int cacheLocalN{-1};
-  if (cacheLocalN != -1) {
-    return cacheLocalN;
+  if (cached_local_N != -1) {
+    return cached_local_N;
   }
 
   // Must be initialised
   ASSERT0(initialised);
 
-  const auto local_N_2D = std::accumulate(begin(f2d), end(f2d), 0, local_N_sum<Field2D>);
-  const auto local_N_3D = std::accumulate(begin(f3d), end(f3d), 0, local_N_sum<Field3D>);
-  const auto local_N = local_N_2D + local_N_3D;
+  if (zero_copy) {
+    // State vector holds whole fields, including guard cells
+    const auto whole_field_sum = [](int value, const auto& f) {
+      return value + (f.var->getNx() * f.var->getNy() * f.var->getNz());
+    };
+    cached_local_N = std::accumulate(begin(f2d), end(f2d), 0, whole_field_sum)
+                     + std::accumulate(begin(f3d), end(f3d), 0, whole_field_sum);
+    return cached_local_N;
+  }
 
-  cacheLocalN = local_N;
+  cached_local_N = getLocalEvolvedN();
 
-  return local_N;
+  return cached_local_N;
+}
+
+int Solver::getLocalEvolvedN() {
+  ASSERT0(initialised);
+
+  const auto local_N_2D = std::accumulate(begin(f2d), end(f2d), 0, local_N_sum<Field2D>);
+  const auto local_N_3D = std::accumulate(begin(f3d), end(f3d), 0, local_N_sum<Field3D>);
+  return local_N_2D + local_N_3D;
 }
 
 std::unique_ptr<Solver> Solver::create(Options* opts) {
@@ -1011,184 +1068,378 @@ std::unique_ptr<Solver> Solver::create(const SolverType& type, Options* opts) {
 /**************************************************************************
  * Looping over variables
  *
- * NOTE: This part is very inefficient, and should be replaced ASAP
- * Is the interleaving of variables needed or helpful to the solver?
+ * The state vector is interleaved: at each (x, y) point there are all
+ * the evolving 2D variables, followed by the 3D variables for each z
+ * in turn. Boundary points come first, then the bulk. This layout is
+ * relied on by the preconditioners and Jacobian colouring, so instead
+ * of changing it, the mapping between fields and the state vector is
+ * precomputed as a set of strided runs. Copying is then a simple
+ * strided loop over each run, which vectorises and runs in parallel.
  **************************************************************************/
 
-/// Perform an operation at a given Ind2D (jx,jy) location, moving data between BOUT++ and CVODE
-void Solver::loop_vars_op(Ind2D i2d, BoutReal* udata, int& p, SOLVER_VAR_OP op,
-                          bool bndry) {
+namespace {
+/// Maximum length of a `Solver::StateRun`, so that there is enough
+/// work to spread over OpenMP threads
+constexpr int max_state_run_length = 4096;
+} // namespace
+
+void Solver::calculateStateRuns() {
   // Use global mesh: FIX THIS!
   Mesh* mesh = bout::globals::mesh;
 
-  int nz = mesh->LocalNz;
-
-  switch (op) {
-  case SOLVER_VAR_OP::LOAD_VARS: {
-    /// Load variables from IDA into BOUT++
-
-    // Loop over 2D variables
-    for (const auto& f : f2d) {
-      if (bndry && !f.evolve_bndry) {
-        continue;
+  const int nz = mesh->LocalNz;
+  const int n2d = static_cast<int>(f2d.size());
+
+  state_runs.clear();
+
+  // Index into state_runs of the last run of each variable, which
+  // the next elements might extend
+  std::vector<int> last_run(f2d.size() + f3d.size(), -1);
+
+  auto add_run = [&](int var, int field_start, int state_start, int count,
+                     int state_stride) {
+    if (last_run[var] >= 0) {
+      auto& run = state_runs[last_run[var]];
+      // Distance from the last element of the existing run to the
+      // first element of the new one
+      const int gap = state_start - (run.state_start + ((run.count - 1) * run.state_stride));
+      if ((run.field_start + run.count == field_start)
+          and (run.count == 1 or run.state_stride == gap)
+          and (count == 1 or state_stride == gap)
+          and (run.count + count <= max_state_run_length)) {
+        run.count += count;
+        run.state_stride = gap;
+        return;
       }
-      (*f.var)[i2d] = udata[p];
-      p++;
     }
+    last_run[var] = static_cast<int>(state_runs.size());
+    state_runs.push_back({var, field_start, state_start, count, state_stride});
+  };
 
-    for (int jz = 0; jz < nz; jz++) {
-
-      // Loop over 3D variables
-      for (const auto& f : f3d) {
-        if (bndry && !f.evolve_bndry) {
-          continue;
-        }
-        (*f.var)[f.var->getMesh()->ind2Dto3D(i2d, jz)] = udata[p];
-        p++;
-      }
-    }
-    break;
-  }
-  case SOLVER_VAR_OP::LOAD_DERIVS: {
-    /// Load derivatives from IDA into BOUT++
-    /// Used for preconditioner
+  int p = 0; // Counter for location in the state vector
 
+  auto add_point = [&](const Ind2D& i2d, bool bndry) {
     // Loop over 2D variables
-    for (const auto& f : f2d) {
-      if (bndry && !f.evolve_bndry) {
+    for (int var = 0; var < n2d; ++var) {
+      if (bndry && !f2d[var].evolve_bndry) {
         continue;
       }
-      (*f.F_var)[i2d] = udata[p];
+      add_run(var, i2d.ind, p, 1, 1);
       p++;
     }
 
-    for (int jz = 0; jz < nz; jz++) {
-
-      // Loop over 3D variables
-      for (const auto& f : f3d) {
-        if (bndry && !f.evolve_bndry) {
-          continue;
-        }
-        (*f.F_var)[f.F_var->getMesh()->ind2Dto3D(i2d, jz)] = udata[p];
-        p++;
+    // Loop over 3D variables, which are interleaved in z
+    const auto nactive = static_cast<int>(std::count_if(
+        begin(f3d), end(f3d), [bndry](const auto& f) { return !bndry || f.evolve_bndry; }));
+    int offset = 0;
+    for (int var = 0; var < static_cast<int>(f3d.size()); ++var) {
+      if (bndry && !f3d[var].evolve_bndry) {
+        continue;
       }
+      add_run(n2d + var, mesh->ind2Dto3D(i2d, 0).ind, p + offset, nz, nactive);
+      offset++;
     }
+    p += nactive * nz;
+  };
 
-    break;
+  // All boundaries
+  for (const auto& i2d : mesh->getRegion2D("RGN_BNDRY")) {
+    add_point(i2d, true);
   }
-  case SOLVER_VAR_OP::SET_ID: {
-    /// Set the type of equation (Differential or Algebraic)
 
-    // Loop over 2D variables
-    for (const auto& f : f2d) {
-      if (bndry && !f.evolve_bndry) {
-        continue;
-      }
-      if (f.constraint) {
-        udata[p] = 0;
-      } else {
-        udata[p] = 1;
-      }
-      p++;
-    }
+  // Bulk of points
+  for (const auto& i2d : mesh->getRegion2D("RGN_NOBNDRY")) {
+    add_point(i2d, false);
+  }
 
-    for (int jz = 0; jz < nz; jz++) {
+  state_runs_nvars = f2d.size() + f3d.size();
+}
 
-      // Loop over 3D variables
-      for (const auto& f : f3d) {
-        if (bndry && !f.evolve_bndry) {
-          continue;
-        }
-        if (f.constraint) {
-          udata[p] = 0;
-        } else {
-          udata[p] = 1;
-        }
-        p++;
-      }
-    }
+/// Loop over variables and domain. Used for all data operations for consistency
+void Solver::loop_vars(BoutReal* udata, SOLVER_VAR_OP op) {
+  if (zero_copy) {
+    alias_vars(udata, op);
+    return;
+  }
 
-    break;
+  if (state_runs_nvars != f2d.size() + f3d.size()) {
+    calculateStateRuns();
   }
-  case SOLVER_VAR_OP::SAVE_VARS: {
-    /// Save variables from BOUT++ into IDA (only used at start of simulation)
 
-    // Loop over 2D variables
+  const int nruns = static_cast<int>(state_runs.size());
+
+  if (op == SOLVER_VAR_OP::SET_ID) {
+    /// Set the type of equation (Differential or Algebraic)
+    std::vector<BoutReal> id;
+    id.reserve(f2d.size() + f3d.size());
     for (const auto& f : f2d) {
-      if (bndry && !f.evolve_bndry) {
-        continue;
+      id.push_back(f.constraint ? 0 : 1);
+    }
+    for (const auto& f : f3d) {
+      id.push_back(f.constraint ? 0 : 1);
+    }
+
+    BOUT_OMP(parallel for schedule(static))
+    for (int r = 0; r < nruns; ++r) {
+      const auto& run = state_runs[r];
+      BoutReal* state = udata + run.state_start;
+      for (int i = 0; i < run.count; ++i) {
+        state[i * run.state_stride] = id[run.var];
       }
-      udata[p] = (*f.var)[i2d];
-      p++;
     }
+    return;
+  }
 
-    for (int jz = 0; jz < nz; jz++) {
+  // Pointers to the start of the data for each variable. Depending on
+  // the operation this is either the variable or its time derivative
+  const bool derivs =
+      (op == SOLVER_VAR_OP::LOAD_DERIVS) or (op == SOLVER_VAR_OP::SAVE_DERIVS);
+  std::vector<BoutReal*> data;
+  data.reserve(f2d.size() + f3d.size());
+  for (const auto& f : f2d) {
+    data.push_back(&(*(derivs ? f.F_var : f.var))(0, 0));
+  }
+  for (const auto& f : f3d) {
+    data.push_back(&(*(derivs ? f.F_var : f.var))(0, 0, 0));
+  }
 
-      // Loop over 3D variables
-      for (const auto& f : f3d) {
-        if (bndry && !f.evolve_bndry) {
-          continue;
+  switch (op) {
+  case SOLVER_VAR_OP::LOAD_VARS:
+  case SOLVER_VAR_OP::LOAD_DERIVS: {
+    /// Load variables or derivatives from the solver into BOUT++
+    BOUT_OMP(parallel for schedule(static))
+    for (int r = 0; r < nruns; ++r) {
+      const auto& run = state_runs[r];
+      BoutReal* field = data[run.var] + run.field_start;
+      const BoutReal* state = udata + run.state_start;
+      if (run.state_stride == 1) {
+        std::copy(state, state + run.count, field);
+      } else {
+        for (int i = 0; i < run.count; ++i) {
+          field[i] = state[i * run.state_stride];
         }
-        udata[p] = (*f.var)[f.var->getMesh()->ind2Dto3D(i2d, jz)];
-        p++;
       }
     }
     break;
   }
-    /// Save time-derivatives from BOUT++ into CVODE (returning RHS result)
+  case SOLVER_VAR_OP::SAVE_VARS:
   case SOLVER_VAR_OP::SAVE_DERIVS: {
-
-    // Loop over 2D variables
-    for (const auto& f : f2d) {
-      if (bndry && !f.evolve_bndry) {
-        continue;
-      }
-      udata[p] = (*f.F_var)[i2d];
-      p++;
-    }
-
-    for (int jz = 0; jz < nz; jz++) {
-
-      // Loop over 3D variables
-      for (const auto& f : f3d) {
-        if (bndry && !f.evolve_bndry) {
-          continue;
+    /// Save variables or time-derivatives from BOUT++ into the solver
+    BOUT_OMP(parallel for schedule(static))
+    for (int r = 0; r < nruns; ++r) {
+      const auto& run = state_runs[r];
+      const BoutReal* field = data[run.var] + run.field_start;
+      BoutReal* state = udata + run.state_start;
+      if (run.state_stride == 1) {
+        std::copy(field, field + run.count, state);
+      } else {
+        for (int i = 0; i < run.count; ++i) {
+          state[i * run.state_stride] = field[i];
         }
-        udata[p] = (*f.F_var)[f.F_var->getMesh()->ind2Dto3D(i2d, jz)];
-        p++;
       }
     }
     break;
   }
+  case SOLVER_VAR_OP::SET_ID:
+    break;
   }
 }
 
-/// Loop over variables and domain. Used for all data operations for consistency
-void Solver::loop_vars(BoutReal* udata, SOLVER_VAR_OP op) {
-  // Use global mesh: FIX THIS!
-  Mesh* mesh = bout::globals::mesh;
+/**************************************************************************
+ * Zero-copy state
+ *
+ * With `zero_copy`, the state vector holds each evolving variable as a
+ * whole field, including guard cells: all the 2D variables, then all
+ * the 3D variables. Loading the state then just points the variables
+ * at the right part of the state vector, and saving only has to copy
+ * if the variable no longer shares memory with it, for example
+ * because it was assigned a new field.
+ **************************************************************************/
 
-  int p = 0; // Counter for location in udata array
+namespace {
+const BoutReal* fieldData(const Field2D& f) { return &f(0, 0); }
+const BoutReal* fieldData(const Field3D& f) { return &f(0, 0, 0); }
 
-  // All boundaries
-  for (const auto& i2d : mesh->getRegion2D("RGN_BNDRY")) {
-    loop_vars_op(i2d, udata, p, op, true);
+/// Number of elements in \p f, including guard cells
+template <class T>
+int wholeFieldSize(const T& f) {
+  return f.getNx() * f.getNy() * f.getNz();
+}
+
+/// Make \p f share memory with \p state, unless it already does
+template <class T>
+void aliasField(T& f, BoutReal* state, CELL_LOC location) {
+  if (f.isAllocated() and fieldData(f) == state) {
+    return;
   }
+  T view{Array<BoutReal>::view(state, wholeFieldSize(f)), f.getMesh(), location,
+         f.getDirections()};
+  view.name = f.name;
+  f = view;
+}
 
-  // Bulk of points
-  for (const auto& i2d : mesh->getRegion2D("RGN_NOBNDRY")) {
-    loop_vars_op(i2d, udata, p, op, false);
+/// Copy \p f into \p state, unless they already share memory
+template <class T>
+void saveField(const T& f, BoutReal* state) {
+  const BoutReal* data = fieldData(f);
+  if (data != state) {
+    std::copy(data, data + wholeFieldSize(f), state);
   }
 }
 
-void Solver::load_vars(BoutReal* udata) {
-  // Make sure data is allocated
+/// Set \p state to zero in \p region
+template <class T>
+void zeroRegion(BoutReal* state, const Region<T>& region) {
+  BOUT_FOR(i, region) { state[i.ind] = 0.0; }
+}
+
+#if CHECK > 1
+/// FNV-1a hash of the bits of \p state in \p region
+template <class T>
+std::uint64_t checksum(const BoutReal* state, const Region<T>& region) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  BOUT_FOR_SERIAL(i, region) {
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, state + i.ind, sizeof(bits));
+    hash = (hash ^ bits) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+/// The evolved points of a variable, in the memory it shares with
+/// the state, and their checksum
+template <class T>
+struct AliasedState {
+  std::string name;
+  const BoutReal* data;
+  const Region<T>* region;
+  std::uint64_t checksum;
+};
+
+template <class T, class Vars>
+std::vector<AliasedState<T>> aliasedState(const Vars& vars) {
+  std::vector<AliasedState<T>> result;
+  for (const auto& f : vars) {
+    if (f.var->isAllocated()) {
+      const BoutReal* data = fieldData(*f.var);
+      const auto& region = f.var->getRegion("RGN_NOBNDRY");
+      result.push_back({f.name, data, &region, checksum(data, region)});
+    }
+  }
+  return result;
+}
+
+template <class T>
+void checkUnchanged(const std::vector<AliasedState<T>>& states) {
+  for (const auto& state : states) {
+    if (checksum(state.data, *state.region) != state.checksum) {
+      throw BoutException(_("The RHS changed evolving variable '{:s}' in place, which "
+                            "with 'zero_copy' changes the solver state. Assign a new "
+                            "field to it instead"),
+                          state.name);
+    }
+  }
+}
+#endif
+
+/// Run \p rhs. With `zero_copy`, the variables in \p f2d and \p f3d
+/// are the solver state, so in CHECK > 1 builds this throws if \p rhs
+/// changes their evolved points in place
+template <class Vars2D, class Vars3D, class RHS>
+int runCheckingState(MAYBE_UNUSED(bool zero_copy), MAYBE_UNUSED(const Vars2D& f2d),
+                     MAYBE_UNUSED(const Vars3D& f3d), RHS rhs) {
+#if CHECK > 1
+  if (zero_copy) {
+    const auto state_2d = aliasedState<Ind2D>(f2d);
+    const auto state_3d = aliasedState<Ind3D>(f3d);
+    const int status = rhs();
+    checkUnchanged(state_2d);
+    checkUnchanged(state_3d);
+    return status;
+  }
+#endif
+  return rhs();
+}
+} // namespace
+
+void Solver::alias_vars(BoutReal* udata, SOLVER_VAR_OP op) {
+  BoutReal* state = udata;
+
+  switch (op) {
+  case SOLVER_VAR_OP::LOAD_VARS:
+  case SOLVER_VAR_OP::LOAD_DERIVS: {
+    const bool derivs = op == SOLVER_VAR_OP::LOAD_DERIVS;
+    for (const auto& f : f2d) {
+      auto& field = *(derivs ? f.F_var : f.var);
+      aliasField(field, state, f.location);
+      state += wholeFieldSize(field);
+    }
+    for (const auto& f : f3d) {
+      auto& field = *(derivs ? f.F_var : f.var);
+      aliasField(field, state, f.location);
+      state += wholeFieldSize(field);
+    }
+    break;
+  }
+  case SOLVER_VAR_OP::SAVE_VARS:
+    for (const auto& f : f2d) {
+      saveField(*f.var, state);
+      state += wholeFieldSize(*f.var);
+    }
+    for (const auto& f : f3d) {
+      saveField(*f.var, state);
+      state += wholeFieldSize(*f.var);
+    }
+    break;
+  case SOLVER_VAR_OP::SAVE_DERIVS:
+    // Points which aren't evolved must not change, so set their time
+    // derivatives to zero
+    for (const auto& f : f2d) {
+      saveField(*f.F_var, state);
+      zeroRegion(state, f.evolve_bndry ? frozen_2d_evolve_bndry : frozen_2d);
+      state += wholeFieldSize(*f.F_var);
+    }
+    for (const auto& f : f3d) {
+      saveField(*f.F_var, state);
+      zeroRegion(state, f.evolve_bndry ? frozen_3d_evolve_bndry : frozen_3d);
+      state += wholeFieldSize(*f.F_var);
+    }
+    break;
+  case SOLVER_VAR_OP::SET_ID:
+    throw BoutException(_("Solver option 'zero_copy' does not support constraints"));
+  }
+}
+
+void Solver::unalias_vars() {
   for (const auto& f : f2d) {
-    f.var->allocate();
+    if (f.var->isAllocated()) {
+      *f.var = copy(*f.var);
+    }
+    if (f.F_var->isAllocated()) {
+      *f.F_var = copy(*f.F_var);
+    }
   }
   for (const auto& f : f3d) {
-    f.var->allocate();
-    f.var->setLocation(f.location);
+    if (f.var->isAllocated()) {
+      *f.var = copy(*f.var);
+    }
+    if (f.F_var->isAllocated()) {
+      *f.F_var = copy(*f.F_var);
+    }
+  }
+}
+
+void Solver::load_vars(BoutReal* udata) {
+  // Make sure data is allocated. Not needed with zero_copy, as the
+  // variables will share the state's memory
+  if (not zero_copy) {
+    for (const auto& f : f2d) {
+      f.var->allocate();
+    }
+    for (const auto& f : f3d) {
+      f.var->allocate();
+      f.var->setLocation(f.location);
+    }
   }
 
   loop_vars(udata, SOLVER_VAR_OP::LOAD_VARS);
@@ -1205,12 +1456,14 @@ void Solver::load_vars(BoutReal* udata) {
 
 void Solver::load_derivs(BoutReal* udata) {
   // Make sure data is allocated
-  for (const auto& f : f2d) {
-    f.F_var->allocate();
-  }
-  for (const auto& f : f3d) {
-    f.F_var->allocate();
-    f.F_var->setLocation(f.location);
+  if (not zero_copy) {
+    for (const auto& f : f2d) {
+      f.F_var->allocate();
+    }
+    for (const auto& f : f3d) {
+      f.F_var->allocate();
+      f.F_var->setLocation(f.location);
+    }
   }
 
   loop_vars(udata, SOLVER_VAR_OP::LOAD_DERIVS);
@@ -1361,6 +1614,7 @@ int Solver::run_rhs(BoutReal t, bool linear) {
   int status;
 
   Timer timer("rhs");
+  BOUT_TIME_REGION("rhs");
 
   if (model->splitOperator()) {
     // Run both parts
@@ -1372,13 +1626,15 @@ int Solver::run_rhs(BoutReal t, bool linear) {
 
     save_vars(tmp.begin()); // Copy variables into tmp
     pre_rhs(t);
-    status = model->runConvective(t, linear);
+    status = runCheckingState(zero_copy, f2d, f3d,
+                              [&]() { return model->runConvective(t, linear); });
     post_rhs(t); // Check variables, apply boundary conditions
 
     load_vars(tmp.begin());   // Reset variables
     save_derivs(tmp.begin()); // Save time derivatives
     pre_rhs(t);
-    status = model->runDiffusive(t, linear);
+    status = runCheckingState(zero_copy, f2d, f3d,
+                              [&]() { return model->runDiffusive(t, linear); });
     post_rhs(t);
     save_derivs(tmp2.begin()); // Save time derivatives
     for (BoutReal *t = tmp.begin(), *t2 = tmp2.begin(); t != tmp.end(); ++t, ++t2) {
@@ -1387,7 +1643,8 @@ int Solver::run_rhs(BoutReal t, bool linear) {
     load_derivs(tmp.begin()); // Put back time-derivatives
   } else {
     pre_rhs(t);
-    status = model->runRHS(t, linear);
+    status = runCheckingState(zero_copy, f2d, f3d,
+                              [&]() { return model->runRHS(t, linear); });
     post_rhs(t);
   }
 
@@ -1405,12 +1662,15 @@ int Solver::run_convective(BoutReal t, bool linear) {
   int status;
 
   Timer timer("rhs");
+  BOUT_TIME_REGION("rhs");
   pre_rhs(t);
   if (model->splitOperator()) {
-    status = model->runConvective(t, linear);
+    status = runCheckingState(zero_copy, f2d, f3d,
+                              [&]() { return model->runConvective(t, linear); });
   } else if (!is_nonsplit_model_diffusive) {
     // Return total
-    status = model->runRHS(t, linear);
+    status = runCheckingState(zero_copy, f2d, f3d,
+                              [&]() { return model->runRHS(t, linear); });
   } else {
     // Zero if not split
     for (const auto& f : f3d) {
@@ -1435,14 +1695,17 @@ int Solver::run_diffusive(BoutReal t, bool linear) {
   int status = 0;
 
   Timer timer("rhs");
+  BOUT_TIME_REGION("rhs");
   pre_rhs(t);
   if (model->splitOperator()) {
 
-    status = model->runDiffusive(t, linear);
+    status = runCheckingState(zero_copy, f2d, f3d,
+                              [&]() { return model->runDiffusive(t, linear); });
     post_rhs(t);
   } else if (is_nonsplit_model_diffusive) {
     // Return total
-    status = model->runRHS(t, linear);
+    status = runCheckingState(zero_copy, f2d, f3d,
+                              [&]() { return model->runRHS(t, linear); });
   } else {
     // Zero if not split
     for (const auto& f : f3d) {
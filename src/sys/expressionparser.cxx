@@ -36,6 +36,7 @@ using std::stringstream;
 using namespace std::string_literals;
 
 using bout::generator::Context;
+using bout::generator::Program;
 
 // Note: Here rather than in header to avoid many deprecated warnings
 // Remove in future and make this function pure virtual
@@ -54,6 +55,9 @@ public:
     return std::make_shared<FieldX>();
   }
   double generate(const Context& ctx) override { return ctx.x(); }
+  Program::Register compile(Program& program) const override {
+    return program.variable(Program::Variable::x);
+  }
   std::string str() const override { return "x"s; }
 };
 
@@ -63,6 +67,9 @@ public:
     return std::make_shared<FieldY>();
   }
   double generate(const Context& ctx) override { return ctx.y(); }
+  Program::Register compile(Program& program) const override {
+    return program.variable(Program::Variable::y);
+  }
   std::string str() const override { return "y"s; }
 };
 
@@ -72,6 +79,9 @@ public:
     return std::make_shared<FieldZ>();
   }
   double generate(const Context& ctx) override { return ctx.z(); }
+  Program::Register compile(Program& program) const override {
+    return program.variable(Program::Variable::z);
+  }
   std::string str() const override { return "z"; }
 };
 
@@ -81,6 +91,9 @@ public:
     return std::make_shared<FieldT>();
   }
   double generate(const Context& ctx) override { return ctx.t(); }
+  Program::Register compile(Program& program) const override {
+    return program.variable(Program::Variable::t);
+  }
   std::string str() const override { return "t"s; }
 };
 
@@ -0,0 +1,324 @@
+#include "bout/sys/generator_program.hxx"
+#include "bout/assert.hxx"
+#include "bout/sys/expressionparser.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace bout {
+namespace generator {
+
+Program::Program(const FieldGenerator& root) {
+  output = root.compile(*this);
+  if (output < 0) {
+    // Part of the tree couldn't be compiled
+    instructions.clear();
+    return;
+  }
+
+  removeUnused();
+
+  if (not dependsOnTime()) {
+    // Nothing to be gained by storing parts of the program
+    return;
+  }
+
+  // Find the time-independent inputs to time-dependent instructions.
+  // Leaves are not stored, since they are as cheap to evaluate again
+  std::vector<bool> is_hoisted(instructions.size(), false);
+  for (const auto& instruction : instructions) {
+    if (not instruction.depends_t) {
+      continue;
+    }
+    for (const Register arg : {instruction.lhs, instruction.rhs}) {
+      if ((arg >= 0) and (not instructions[arg].depends_t) and (not isLeaf(arg))
+          and (not is_hoisted[arg])) {
+        is_hoisted[arg] = true;
+        hoisted.push_back(arg);
+      }
+    }
+  }
+}
+
+Program::Register Program::add(Instruction instruction) {
+  switch (instruction.op) {
+  case Op::z:
+    instruction.depends_z = true;
+    break;
+  case Op::pointer:
+  case Op::t:
+    instruction.depends_t = true;
+    break;
+  default:
+    break;
+  }
+  // Depends on everything the arguments depend on
+  for (const Register arg : {instruction.lhs, instruction.rhs}) {
+    if (arg >= 0) {
+      instruction.depends_z = instruction.depends_z or instructions[arg].depends_z;
+      instruction.depends_t = instruction.depends_t or instructions[arg].depends_t;
+    }
+  }
+  instructions.push_back(instruction);
+  return static_cast<Register>(instructions.size()) - 1;
+}
+
+void Program::removeUnused() {
+  // Instructions only read earlier registers, so a single backwards
+  // pass from the output finds everything that is used
+  std::vector<bool> used(instructions.size(), false);
+  used[output] = true;
+  for (auto i = static_cast<Register>(instructions.size()) - 1; i >= 0; --i) {
+    if (not used[i]) {
+      continue;
+    }
+    for (const Register arg : {instructions[i].lhs, instructions[i].rhs}) {
+      if (arg >= 0) {
+        used[arg] = true;
+      }
+    }
+  }
+
+  std::vector<Register> renumber(instructions.size(), -1);
+  std::vector<Instruction> kept;
+  for (std::size_t i = 0; i < instructions.size(); ++i) {
+    if (not used[i]) {
+      continue;
+    }
+    Instruction instruction = instructions[i];
+    for (Register* arg : {&instruction.lhs, &instruction.rhs}) {
+      if (*arg >= 0) {
+        *arg = renumber[*arg];
+      }
+    }
+    renumber[i] = static_cast<Register>(kept.size());
+    kept.push_back(instruction);
+  }
+
+  output = renumber[output];
+  instructions = std::move(kept);
+}
+
+Program::Register Program::constant(BoutReal value) {
+  Instruction instruction{Op::constant};
+  instruction.value = value;
+  return add(instruction);
+}
+
+Program::Register Program::pointer(const BoutReal* ptr) {
+  Instruction instruction{Op::pointer};
+  instruction.ptr = ptr;
+  return add(instruction);
+}
+
+Program::Register Program::variable(Variable var) {
+  switch (var) {
+  case Variable::x:
+    return add({Op::x});
+  case Variable::y:
+    return add({Op::y});
+  case Variable::z:
+    return add({Op::z});
+  case Variable::t:
+    return add({Op::t});
+  }
+  return -1;
+}
+
+Program::Register Program::binary(char op, Register lhs, Register rhs) {
+  if ((lhs < 0) or (rhs < 0)) {
+    return -1;
+  }
+
+  Instruction instruction{Op::add, lhs, rhs};
+  switch (op) {
+  case '+':
+    instruction.op = Op::add;
+    break;
+  case '-':
+    instruction.op = Op::subtract;
+    break;
+  case '*':
+    instruction.op = Op::multiply;
+    break;
+  case '/':
+    instruction.op = Op::divide;
+    break;
+  case '^':
+    instruction.op = Op::power;
+    break;
+  default:
+    return -1;
+  }
+
+  if (isConstant(lhs) and isConstant(rhs)) {
+    // Evaluate now, rather than every time the program is run. The
+    // arguments are left unused, and removed once compiling finishes
+    const BoutReal lval = instructions[lhs].value;
+    const BoutReal rval = instructions[rhs].value;
+    switch (instruction.op) {
+    case Op::add:
+      return constant(lval + rval);
+    case Op::subtract:
+      return constant(lval - rval);
+    case Op::multiply:
+      return constant(lval * rval);
+    case Op::divide:
+      return constant(lval / rval);
+    default:
+      return constant(std::pow(lval, rval));
+    }
+  }
+  return add(instruction);
+}
+
+Program::Register Program::call(single_arg_op function, Register arg) {
+  if (arg < 0) {
+    return -1;
+  }
+  if (isConstant(arg)) {
+    return constant(function(instructions[arg].value));
+  }
+  Instruction instruction{Op::call1, arg};
+  instruction.function1 = function;
+  return add(instruction);
+}
+
+Program::Register Program::call(double_arg_op function, Register arg1, Register arg2) {
+  if ((arg1 < 0) or (arg2 < 0)) {
+    return -1;
+  }
+  if (isConstant(arg1) and isConstant(arg2)) {
+    return constant(function(instructions[arg1].value, instructions[arg2].value));
+  }
+  Instruction instruction{Op::call2, arg1, arg2};
+  instruction.function2 = function;
+  return add(instruction);
+}
+
+void Program::evaluate(BoutReal x, BoutReal y, const BoutReal* z, BoutReal t, int n,
+                       BoutReal* result, std::vector<BoutReal>& workspace,
+                       const BoutReal* hoisted_values) const {
+  ASSERT1(valid());
+
+  if (hoisted_values == nullptr) {
+    run(Part::all, x, y, z, t, n, workspace);
+  } else {
+    workspace.resize(instructions.size() * n);
+    for (std::size_t i = 0; i < hoisted.size(); ++i) {
+      std::copy(hoisted_values + (i * n), hoisted_values + ((i + 1) * n),
+                workspace.data() + (hoisted[i] * n));
+    }
+    run(Part::time_dependent, x, y, z, t, n, workspace);
+  }
+
+  const BoutReal* values = workspace.data() + (output * n);
+  std::copy(values, values + n, result);
+}
+
+void Program::evaluateHoisted(BoutReal x, BoutReal y, const BoutReal* z, int n,
+                              BoutReal* hoisted_values,
+                              std::vector<BoutReal>& workspace) const {
+  ASSERT1(valid());
+
+  run(Part::hoisted, x, y, z, 0.0, n, workspace);
+
+  for (std::size_t i = 0; i < hoisted.size(); ++i) {
+    const BoutReal* values = workspace.data() + (hoisted[i] * n);
+    std::copy(values, values + n, hoisted_values + (i * n));
+  }
+}
+
+void Program::run(Part part, BoutReal x, BoutReal y, const BoutReal* z, BoutReal t,
+                  int n, std::vector<BoutReal>& workspace) const {
+  workspace.resize(instructions.size() * n);
+  BoutReal* registers = workspace.data();
+
+  for (std::size_t i = 0; i < instructions.size(); ++i) {
+    const Instruction& instruction = instructions[i];
+
+    if ((part == Part::hoisted) and instruction.depends_t) {
+      continue;
+    }
+    if ((part == Part::time_dependent) and (not instruction.depends_t)
+        and (not isLeaf(static_cast<Register>(i)))) {
+      // Either loaded from the hoisted values, or not needed
+      continue;
+    }
+
+    BoutReal* out = registers + (i * n);
+    // Argument registers, if used
+    const BoutReal* lhs =
+        (instruction.lhs < 0) ? nullptr : registers + (instruction.lhs * n);
+    const BoutReal* rhs =
+        (instruction.rhs < 0) ? nullptr : registers + (instruction.rhs * n);
+
+    // Instructions which are the same along the line are evaluated
+    // at the first point, then copied
+    const int m = instruction.depends_z ? n : 1;
+
+    switch (instruction.op) {
+    case Op::constant:
+      out[0] = instruction.value;
+      break;
+    case Op::pointer:
+      out[0] = *instruction.ptr;
+      break;
+    case Op::x:
+      out[0] = x;
+      break;
+    case Op::y:
+      out[0] = y;
+      break;
+    case Op::z:
+      std::copy(z, z + n, out);
+      break;
+    case Op::t:
+      out[0] = t;
+      break;
+    case Op::add:
+      for (int j = 0; j < m; ++j) {
+        out[j] = lhs[j] + rhs[j];
+      }
+      break;
+    case Op::subtract:
+      for (int j = 0; j < m; ++j) {
+        out[j] = lhs[j] - rhs[j];
+      }
+      break;
+    case Op::multiply:
+      for (int j = 0; j < m; ++j) {
+        out[j] = lhs[j] * rhs[j];
+      }
+      break;
+    case Op::divide:
+      for (int j = 0; j < m; ++j) {
+        out[j] = lhs[j] / rhs[j];
+      }
+      break;
+    case Op::power:
+      for (int j = 0; j < m; ++j) {
+        out[j] = std::pow(lhs[j], rhs[j]);
+      }
+      break;
+    case Op::call1:
+      for (int j = 0; j < m; ++j) {
+        out[j] = instruction.function1(lhs[j]);
+      }
+      break;
+    case Op::call2:
+      for (int j = 0; j < m; ++j) {
+        out[j] = instruction.function2(lhs[j], rhs[j]);
+      }
+      break;
+    }
+
+    if (m < n) {
+      std::fill(out + 1, out + n, out[0]);
+    }
+  }
+}
+
+} // namespace generator
+} // namespace bout
@@ -29,21 +29,36 @@
 #include <bout/output.hxx>
 #include <cstdarg>
 #include <string>
+#include <thread>
 
 #if BOUT_USE_OPENMP
 #include <omp.h>
 #endif
 
 #if BOUT_USE_MSGSTACK
-int MsgStack::push(std::string message) {
-
+namespace {
+/// Is this an OpenMP region with more than one thread?
+bool inParallelRegion() {
 #if BOUT_USE_OPENMP
+  return omp_get_num_threads() > 1;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+bool MsgStack::otherThread() const {
+  // Threads in an OpenMP region are handled separately, as all of them
+  // need to reach any `single` construct
+  return (not inParallelRegion()) and (std::this_thread::get_id() != owner);
+}
+
+int MsgStack::push(std::string message) {
   // This is temporary fix: no messages from OMP regions if there's
   // more than one thread
-  if (omp_get_num_threads() > 1) {
+  if (inParallelRegion() or otherThread()) {
     return position;
   }
-#endif
 
   if (position >= stack.size()) {
     stack.push_back(std::move(message));
@@ -55,19 +70,16 @@ int MsgStack::push(std::string message) {
 }
 
 void MsgStack::pop() {
-  if (position <= 0) {
+  if ((position <= 0) or inParallelRegion() or otherThread()) {
     return;
   }
-  BOUT_OMP(single)
-  { --position; }
+  --position;
 }
 
 void MsgStack::pop(int id) {
-#if BOUT_USE_OPENMP
-  if (omp_get_num_threads() > 1) {
+  if (inParallelRegion() or otherThread()) {
     return;
   }
-#endif
   if (id < 0) {
     id = 0;
   }
@@ -78,6 +90,9 @@ void MsgStack::pop(int id) {
 }
 
 void MsgStack::clear() {
+  if (otherThread()) {
+    return;
+  }
   BOUT_OMP(single)
   {
     stack.clear();
@@ -92,6 +107,10 @@ void MsgStack::dump() {
 
 std::string MsgStack::getDump() {
   std::string res = "====== Back trace ======\n";
+  if (otherThread()) {
+    // The stack may be changing, and doesn't include this thread's messages
+    return res;
+  }
   for (int i = position - 1; i >= 0; i--) {
     if (stack[i] != "") {
       res += " -> ";
@@ -9,14 +9,39 @@
 #include "bout/mesh.hxx"
 #include "bout/sys/timer.hxx"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <exception>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <netcdf>
+#include <netcdf_meta.h>
+#include <numeric>
+#include <thread>
 #include <vector>
 
+#if NC_HAS_PARALLEL4
+#include <netcdf_par.h>
+#endif
+#if NC_HAS_ZSTD
+#include <netcdf_filter.h>
+#endif
+
 using namespace netCDF;
 
 namespace {
+/// The NetCDF library isn't thread-safe, so every call to it, from any
+/// OptionsNetCDF or writer thread, is made with this lock held. It must
+/// not be held while waiting for a writer thread, which needs it to
+/// finish its writes
+std::mutex& netcdfMutex() {
+  // Never deleted, so that files can still be closed during exit
+  static auto* mutex = new std::mutex;
+  return *mutex;
+}
+
 /// Name of the attribute used to track individual variable's time indices
 constexpr auto current_time_index_name = "current_time_index";
 
@@ -56,7 +81,8 @@ T readAttribute(const NcAtt& attribute) {
   return value;
 }
 
-void readGroup(const std::string& filename, const NcGroup& group, Options& result) {
+void readGroup(const std::string& filename, const NcGroup& group, Options& result,
+               int max_dims) {
 
   // Iterate over all variables
   for (const auto& varpair : group.getVars()) {
@@ -67,7 +93,8 @@ void readGroup(const std::string& filename, const NcGroup& group, Options& resul
     auto ndims = var.getDimCount(); // Number of dimensions
     auto dims = var.getDims();      // Vector of dimensions
 
-    switch (ndims) {
+    // Larger variables only get their attributes
+    switch ((ndims <= max_dims) ? ndims : -1) {
     case 0: {
       // Scalar variables
       if (var_type == ncDouble) {
@@ -144,17 +171,20 @@ void readGroup(const std::string& filename, const NcGroup& group, Options& resul
     const auto& name = grouppair.first;
     const auto& subgroup = grouppair.second;
 
-    readGroup(filename, subgroup, result[name]);
+    readGroup(filename, subgroup, result[name], max_dims);
   }
 }
 } // namespace
 
 namespace bout {
 
-Options OptionsNetCDF::read() {
+Options OptionsNetCDF::read(int max_dims) {
   Timer timer("io");
 
-  // Open file
+  // Finish writing first, in case this is the same file
+  flush();
+
+  std::lock_guard<std::mutex> lock(netcdfMutex());
   const NcFile read_file(filename, NcFile::read);
 
   if (read_file.isNull()) {
@@ -162,11 +192,93 @@ Options OptionsNetCDF::read() {
   }
 
   Options result;
-  readGroup(filename, read_file, result);
+  readGroup(filename, read_file, result, max_dims);
 
   return result;
 }
 
+std::vector<int> OptionsNetCDF::readShape(const std::string& name) {
+  const auto& file = openForReading();
+  std::lock_guard<std::mutex> lock(netcdfMutex());
+  const auto var = file.getVar(name);
+  if (var.isNull()) {
+    return {};
+  }
+
+  std::vector<int> shape;
+  for (const auto& dim : var.getDims()) {
+    shape.push_back(static_cast<int>(dim.getSize()));
+  }
+  return shape;
+}
+
+Options OptionsNetCDF::readHyperslab(const std::string& name,
+                                     const std::vector<int>& start,
+                                     const std::vector<int>& count) {
+  Timer timer("io");
+
+  const auto& file = openForReading();
+  std::lock_guard<std::mutex> lock(netcdfMutex());
+  const auto var = file.getVar(name);
+  if (var.isNull()) {
+    throw BoutException("Could not find '{:s}' in NetCDF file '{:s}'", name, filename);
+  }
+  const auto ndims = static_cast<std::size_t>(var.getDimCount());
+  if ((start.size() != ndims) or (count.size() != ndims)) {
+    throw BoutException("Variable '{:s}' in '{:s}' has {:d} dimensions, but was read "
+                        "with {:d}",
+                        name, filename, ndims, count.size());
+  }
+
+  const std::vector<std::size_t> nc_start(start.begin(), start.end());
+  const std::vector<std::size_t> nc_count(count.begin(), count.end());
+
+  Options result;
+  switch (ndims) {
+  case 1: {
+    Array<BoutReal> value(count[0]);
+    var.getVar(nc_start, nc_count, value.begin());
+    result = value;
+    break;
+  }
+  case 2: {
+    Matrix<BoutReal> value(count[0], count[1]);
+    var.getVar(nc_start, nc_count, value.begin());
+    result = value;
+    break;
+  }
+  case 3: {
+    Tensor<BoutReal> value(count[0], count[1], count[2]);
+    var.getVar(nc_start, nc_count, value.begin());
+    result = value;
+    break;
+  }
+  default:
+    throw BoutException("Can't read part of {:d}D variable '{:s}' from '{:s}'", ndims,
+                        name, filename);
+  }
+  result.attributes["source"] = filename;
+  return result;
+}
+
+const NcFile& OptionsNetCDF::openForReading() {
+  if (read_file) {
+    return *read_file;
+  }
+
+  // Finish writing first, in case this is the same file
+  flush();
+  closeFile();
+
+  std::lock_guard<std::mutex> lock(netcdfMutex());
+  read_file = std::make_unique<NcFile>(filename, NcFile::read);
+  if (read_file->isNull()) {
+    read_file.reset();
+    throw BoutException("Could not open NetCDF file '{:s}' for reading", filename);
+  }
+  return *read_file;
+}
+
 } // namespace bout
 
 namespace {
@@ -221,16 +333,142 @@ NcType NcTypeVisitor::operator()<FieldPerp>(const FieldPerp& UNUSED(t)) {
   return operator()<BoutReal>(0.0);
 }
 
+template <>
+NcType NcTypeVisitor::operator()<Array<BoutReal>>(const Array<BoutReal>& UNUSED(t)) {
+  return operator()<BoutReal>(0.0);
+}
+
+/// The part of a field which this processor writes to a shared
+/// file. As in collect's default, guard cells and Y boundary cells
+/// are not written, but X boundary cells are
+struct Hyperslab {
+  std::vector<std::size_t> global_size; ///< Size of the whole array
+  std::vector<std::size_t> start;       ///< Global index of the first point
+  std::vector<std::size_t> count;       ///< Number of points
+  std::vector<int> local_start;         ///< Local index of the first point
+
+  void addX(const Mesh& mesh) {
+    const int first = mesh.firstX() ? 0 : mesh.xstart;
+    const int last = mesh.lastX() ? mesh.LocalNx - 1 : mesh.xend;
+    add(mesh.GlobalNx, mesh.getGlobalXIndex(first), last - first + 1, first);
+  }
+  void addY(const Mesh& mesh) {
+    add(mesh.GlobalNyNoBoundaries, mesh.getGlobalYIndexNoBoundaries(mesh.ystart),
+        mesh.yend - mesh.ystart + 1, mesh.ystart);
+  }
+  void addZ(const Mesh& mesh) {
+    add(mesh.GlobalNzNoBoundaries, mesh.getGlobalZIndexNoBoundaries(mesh.zstart),
+        mesh.zend - mesh.zstart + 1, mesh.zstart);
+  }
+
+private:
+  void add(int size, int first_global, int number, int first_local) {
+    global_size.push_back(size);
+    start.push_back(first_global);
+    count.push_back(number);
+    local_start.push_back(first_local);
+  }
+};
+
+Hyperslab sharedHyperslab(const Field2D& value) {
+  Hyperslab slab;
+  slab.addX(*value.getMesh());
+  slab.addY(*value.getMesh());
+  return slab;
+}
+
+Hyperslab sharedHyperslab(const Field3D& value) {
+  Hyperslab slab;
+  slab.addX(*value.getMesh());
+  slab.addY(*value.getMesh());
+  slab.addZ(*value.getMesh());
+  return slab;
+}
+
+/// Only the processors containing the field's Y index write it
+Hyperslab sharedHyperslab(const FieldPerp& value) {
+  const auto& mesh = *value.getMesh();
+  Hyperslab slab;
+  slab.addX(mesh);
+  slab.addZ(mesh);
+  if ((value.getIndex() < mesh.ystart) or (value.getIndex() > mesh.yend)) {
+    slab.count = {0, 0};
+  }
+  return slab;
+}
+
+std::vector<std::size_t> localSize(const Field2D& value) {
+  return {static_cast<std::size_t>(value.getNx()),
+          static_cast<std::size_t>(value.getNy())};
+}
+
+std::vector<std::size_t> localSize(const Field3D& value) {
+  return {static_cast<std::size_t>(value.getNx()),
+          static_cast<std::size_t>(value.getNy()),
+          static_cast<std::size_t>(value.getNz())};
+}
+
+std::vector<std::size_t> localSize(const FieldPerp& value) {
+  return {static_cast<std::size_t>(value.getNx()),
+          static_cast<std::size_t>(value.getNz())};
+}
+
+/// The points of \p slab, as the whole of an array
+Hyperslab wholeArray(Hyperslab slab) {
+  slab.global_size = slab.count;
+  slab.start.assign(slab.count.size(), 0);
+  return slab;
+}
+
+/// The part of a field written to a file of one processor, if guard
+/// cells aren't written. These are the points which the processor
+/// writes to a shared file
+Hyperslab interiorHyperslab(const Field2D& value) {
+  return wholeArray(sharedHyperslab(value));
+}
+
+Hyperslab interiorHyperslab(const Field3D& value) {
+  return wholeArray(sharedHyperslab(value));
+}
+
+/// Unlike in a shared file, all processors write a FieldPerp
+Hyperslab interiorHyperslab(const FieldPerp& value) {
+  Hyperslab slab;
+  slab.addX(*value.getMesh());
+  slab.addZ(*value.getMesh());
+  return wholeArray(slab);
+}
+
+/// Size of field \p value in a file: the global size if the file is
+/// \p shared by all processors, otherwise the local size, including
+/// the guard cells if \p guards
+template <typename T>
+std::vector<std::size_t> writtenSize(const T& value, bool shared, bool guards) {
+  if (shared) {
+    return sharedHyperslab(value).global_size;
+  }
+  return guards ? localSize(value) : interiorHyperslab(value).count;
+}
+
 /// Visit a variant type, returning dimensions
 struct NcDimVisitor {
-  NcDimVisitor(NcGroup& group) : group(group) {}
+  NcDimVisitor(NcGroup& group, bool shared, bool guards, std::string array_dimension)
+      : group(group), shared(shared), guards(guards),
+        array_dimension(std::move(array_dimension)) {}
   template <typename T>
   std::vector<NcDim> operator()(const T& UNUSED(value)) {
     return {};
   }
 
 private:
+  /// Dimensions \p names of field \p value
+  template <typename T>
+  std::vector<NcDim> fieldDims(const T& value, const std::vector<std::string>& names);
+
   NcGroup& group;
+  bool shared;                 ///< Global sizes, for a file shared by all processors?
+  bool guards;                 ///< Including guard cells, if not shared?
+  std::string array_dimension; ///< Name of an Array's dimension, if not by size
 };
 
 NcDim findDimension(NcGroup& group, const std::string& name, unsigned int size) {
@@ -259,40 +497,135 @@ NcDim findDimension(NcGroup& group, const std::string& name, unsigned int size)
   }
 }
 
+template <typename T>
+std::vector<NcDim> NcDimVisitor::fieldDims(const T& value,
+                                           const std::vector<std::string>& names) {
+  const auto size = writtenSize(value, shared, guards);
+  // A file of one processor can have fields with and without guard
+  // cells, so they need different dimensions
+  const std::string suffix = (shared or guards) ? "" : "_interior";
+
+  std::vector<NcDim> dims;
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    auto dim = findDimension(group, names[i] + suffix, size[i]);
+    ASSERT0(!dim.isNull());
+    dims.push_back(dim);
+  }
+  return dims;
+}
+
 template <>
 std::vector<NcDim> NcDimVisitor::operator()<Field2D>(const Field2D& value) {
-  auto xdim = findDimension(group, "x", value.getNx());
-  ASSERT0(!xdim.isNull());
-
-  auto ydim = findDimension(group, "y", value.getNy());
-  ASSERT0(!ydim.isNull());
-
-  return {xdim, ydim};
+  return fieldDims(value, {"x", "y"});
 }
 
 template <>
 std::vector<NcDim> NcDimVisitor::operator()<Field3D>(const Field3D& value) {
-  auto xdim = findDimension(group, "x", value.getNx());
-  ASSERT0(!xdim.isNull());
+  return fieldDims(value, {"x", "y", "z"});
+}
 
-  auto ydim = findDimension(group, "y", value.getNy());
-  ASSERT0(!ydim.isNull());
+template <>
+std::vector<NcDim> NcDimVisitor::operator()<FieldPerp>(const FieldPerp& value) {
+  return fieldDims(value, {"x", "z"});
+}
 
-  auto zdim = findDimension(group, "z", value.getNz());
-  ASSERT0(!zdim.isNull());
+/// Strings in shared files are written as characters, since parallel
+/// HDF5 can't write variable length strings
+template <>
+std::vector<NcDim> NcDimVisitor::operator()<std::string>(const std::string& value) {
+  if (not shared) {
+    return {};
+  }
+  auto dim = findDimension(group, fmt::format("string{:d}", value.size()), value.size());
+  ASSERT0(!dim.isNull());
+  return {dim};
+}
 
-  return {xdim, ydim, zdim};
+/// Arrays have one dimension, named by the "array_dimension"
+/// attribute if they have it, for example "rank" for values gathered
+/// from every processor. Otherwise it's named by the size
+template <>
+std::vector<NcDim>
+NcDimVisitor::operator()<Array<BoutReal>>(const Array<BoutReal>& value) {
+  const auto size = static_cast<std::size_t>(value.size());
+  const auto name =
+      array_dimension.empty() ? fmt::format("array{:d}", size) : array_dimension;
+  auto dim = findDimension(group, name, size);
+  if (dim.isNull()) {
+    throw BoutException("Dimension '{:s}' already has a different size to {:d}", name,
+                        size);
+  }
+  return {dim};
 }
 
+/// Visit a variant type, returning the sizes of the dimensions
+/// `NcDimVisitor` would find, without looking them up in a file
+struct NcSizeVisitor {
+  NcSizeVisitor(bool shared, bool guards) : shared(shared), guards(guards) {}
+  template <typename T>
+  std::vector<std::size_t> operator()(const T& UNUSED(value)) {
+    return {};
+  }
+
+private:
+  bool shared; ///< Global sizes, for a file shared by all processors?
+  bool guards; ///< Including guard cells, if not shared?
+};
+
 template <>
-std::vector<NcDim> NcDimVisitor::operator()<FieldPerp>(const FieldPerp& value) {
-  auto xdim = findDimension(group, "x", value.getNx());
-  ASSERT0(!xdim.isNull());
+std::vector<std::size_t> NcSizeVisitor::operator()<Field2D>(const Field2D& value) {
+  return writtenSize(value, shared, guards);
+}
+template <>
+std::vector<std::size_t> NcSizeVisitor::operator()<Field3D>(const Field3D& value) {
+  return writtenSize(value, shared, guards);
+}
+template <>
+std::vector<std::size_t> NcSizeVisitor::operator()<FieldPerp>(const FieldPerp& value) {
+  return writtenSize(value, shared, guards);
+}
+template <>
+std::vector<std::size_t>
+NcSizeVisitor::operator()<std::string>(const std::string& value) {
+  if (not shared) {
+    return {};
+  }
+  return {value.size()};
+}
+template <>
+std::vector<std::size_t>
+NcSizeVisitor::operator()<Array<BoutReal>>(const Array<BoutReal>& value) {
+  return {static_cast<std::size_t>(value.size())};
+}
 
-  auto zdim = findDimension(group, "z", value.getNz());
-  ASSERT0(!zdim.isNull());
+/// Visit a variant type, and return the size of the interior of one
+/// processor, without guard or boundary cells. This is the same on
+/// every processor, unlike the part it writes to a shared file
+struct NcSlabVisitor {
+  template <typename T>
+  std::vector<std::size_t> operator()(const T& UNUSED(value)) {
+    return {};
+  }
+};
+
+std::size_t interiorX(const Mesh& mesh) { return mesh.xend - mesh.xstart + 1; }
+std::size_t interiorY(const Mesh& mesh) { return mesh.yend - mesh.ystart + 1; }
+std::size_t interiorZ(const Mesh& mesh) { return mesh.zend - mesh.zstart + 1; }
 
-  return {xdim, zdim};
+template <>
+std::vector<std::size_t> NcSlabVisitor::operator()<Field2D>(const Field2D& value) {
+  const auto& mesh = *value.getMesh();
+  return {interiorX(mesh), interiorY(mesh)};
+}
+template <>
+std::vector<std::size_t> NcSlabVisitor::operator()<Field3D>(const Field3D& value) {
+  const auto& mesh = *value.getMesh();
+  return {interiorX(mesh), interiorY(mesh), interiorZ(mesh)};
+}
+template <>
+std::vector<std::size_t> NcSlabVisitor::operator()<FieldPerp>(const FieldPerp& value) {
+  const auto& mesh = *value.getMesh();
+  return {interiorX(mesh), interiorZ(mesh)};
 }
 
 /// Visit a variant type, and put the data into a NcVar
@@ -339,6 +672,11 @@ void NcPutVarVisitor::operator()<FieldPerp>(const FieldPerp& value) {
   var.putVar(&value(0, 0));
 }
 
+template <>
+void NcPutVarVisitor::operator()<Array<BoutReal>>(const Array<BoutReal>& value) {
+  var.putVar(value.begin());
+}
+
 /// Visit a variant type, and put the data into a NcVar
 struct NcPutVarCountVisitor {
   NcPutVarCountVisitor(NcVar& var, const std::vector<size_t>& start,
@@ -375,6 +713,112 @@ void NcPutVarCountVisitor::operator()<FieldPerp>(const FieldPerp& value) {
   // Pointer to data. Assumed to be contiguous array
   var.putVar(start, count, &value(0, 0));
 }
+template <>
+void NcPutVarCountVisitor::operator()<Array<BoutReal>>(const Array<BoutReal>& value) {
+  var.putVar(start, count, value.begin());
+}
+
+/// Copy the part of \p value in \p slab into a contiguous array
+template <typename T>
+std::vector<BoutReal> hyperslabData(const T& value, const Hyperslab& slab) {
+  const int nx = static_cast<int>(slab.count[0]);
+  const int ny = static_cast<int>(slab.count[1]);
+  std::vector<BoutReal> data;
+  data.reserve(nx * ny);
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      data.push_back(value(slab.local_start[0] + i, slab.local_start[1] + j));
+    }
+  }
+  return data;
+}
+
+template <>
+std::vector<BoutReal> hyperslabData<Field3D>(const Field3D& value,
+                                             const Hyperslab& slab) {
+  const int nx = static_cast<int>(slab.count[0]);
+  const int ny = static_cast<int>(slab.count[1]);
+  const int nz = static_cast<int>(slab.count[2]);
+  const auto& local = slab.local_start;
+  std::vector<BoutReal> data;
+  data.reserve(nx * ny * nz);
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      for (int k = 0; k < nz; ++k) {
+        data.push_back(value(local[0] + i, local[1] + j, local[2] + k));
+      }
+    }
+  }
+  return data;
+}
+
+/// Visit a variant type, and put this processor's part of it into a
+/// variable in a file shared by all processors
+struct NcPutSharedVisitor {
+  /// Write the record \p time_index, or if it's negative, the
+  /// variable has no time dimension. If not \p shared, a field is
+  /// written without guard cells to a file of one processor
+  NcPutSharedVisitor(NcVar& var, int time_index, bool shared = true)
+      : var(var), time_index(time_index), shared(shared) {}
+  template <typename T>
+  void operator()(const T& value) {
+    put({}, {}, &value);
+  }
+
+private:
+  template <typename T>
+  void put(std::vector<std::size_t> start, std::vector<std::size_t> count,
+           const T* data) {
+    if (time_index >= 0) {
+      start.insert(start.begin(), static_cast<std::size_t>(time_index));
+      count.insert(count.begin(), 1);
+    }
+    if (start.empty()) {
+      var.putVar(data);
+    } else {
+      var.putVar(start, count, data);
+    }
+  }
+
+  template <typename T>
+  void putField(const T& value) {
+    const auto slab = shared ? sharedHyperslab(value) : interiorHyperslab(value);
+    const auto data = hyperslabData(value, slab);
+    put(slab.start, slab.count, data.data());
+  }
+
+  NcVar& var;
+  int time_index;
+  bool shared;
+};
+
+template <>
+void NcPutSharedVisitor::operator()<bool>(const bool& value) {
+  const int int_val = value ? 1 : 0;
+  put({}, {}, &int_val);
+}
+template <>
+void NcPutSharedVisitor::operator()<std::string>(const std::string& value) {
+  put({0}, {value.size()}, value.data());
+}
+template <>
+void NcPutSharedVisitor::operator()<Field2D>(const Field2D& value) {
+  putField(value);
+}
+template <>
+void NcPutSharedVisitor::operator()<Field3D>(const Field3D& value) {
+  putField(value);
+}
+template <>
+void NcPutSharedVisitor::operator()<FieldPerp>(const FieldPerp& value) {
+  putField(value);
+}
+/// Every processor writes the whole array, so it must be the same on
+/// all of them, or have the "per_processor" attribute
+template <>
+void NcPutSharedVisitor::operator()<Array<BoutReal>>(const Array<BoutReal>& value) {
+  put({0}, {static_cast<std::size_t>(value.size())}, value.begin());
+}
 
 /// Visit a variant type, and put the data into an attributute
 struct NcPutAttVisitor {
@@ -412,8 +856,309 @@ void NcPutAttVisitor::operator()(const std::string& value) {
   var.putAtt(name, value);
 }
 
+/// Set collective access for \p var, which all processors must use
+/// to extend the time dimension of a shared file
+#if NC_HAS_PARALLEL4
+void setCollective(const NcVar& var) {
+  const int status =
+      nc_var_par_access(var.getParentGroup().getId(), var.getId(), NC_COLLECTIVE);
+  if (status != NC_NOERR) {
+    throw BoutException("Could not set collective access for '{:s}': {:s}",
+                        var.getName(), nc_strerror(status));
+  }
+}
+#else
+void setCollective(const NcVar& UNUSED(var)) {}
+#endif
+
+using AttributeMap = std::map<std::string, Options::AttributeType>;
+
+/// How a variable is written, from the attributes of its value
+struct NcVarFormat {
+  bool floats{false};          ///< Write fields as 32-bit floats
+  bool guards{true};           ///< Write the guard cells of fields
+  std::string compress;        ///< "zlib" or "zstd", or empty if not compressed
+  int compress_level{4};       ///< Compression level
+  int significant_bits{0};     ///< Mantissa bits kept, or 0 to keep all
+  std::string array_dimension; ///< Dimension of an Array, or empty to name by size
+};
+
+/// Format of a variable with \p attributes, using \p defaults for
+/// any it doesn't have
+NcVarFormat getFormat(const AttributeMap& attributes, const AttributeMap& defaults) {
+  const auto get = [&](const std::string& name, auto default_value) {
+    auto it = attributes.find(name);
+    if (it == attributes.end()) {
+      it = defaults.find(name);
+      if (it == defaults.end()) {
+        return default_value;
+      }
+    }
+    return it->second.as<decltype(default_value)>();
+  };
+
+  NcVarFormat format;
+  const auto precision = get("precision", std::string{"double"});
+  if ((precision != "double") and (precision != "float")) {
+    throw BoutException("precision must be 'double' or 'float', got '{:s}'", precision);
+  }
+  format.floats = (precision == "float");
+  format.guards = get("guard_cells", true);
+  format.compress = get("compress", std::string{});
+  if (format.compress == "none") {
+    format.compress.clear();
+  }
+  if (not format.compress.empty() and (format.compress != "zlib")
+      and (format.compress != "zstd")) {
+    throw BoutException("compress must be 'zlib', 'zstd' or 'none', got '{:s}'",
+                        format.compress);
+  }
+  format.compress_level = get("compress_level", format.compress_level);
+  format.significant_bits = get("significant_bits", format.significant_bits);
+  if (format.significant_bits < 0) {
+    throw BoutException("significant_bits must be positive, or 0 to keep all");
+  }
+  format.array_dimension = get("array_dimension", std::string{});
+  return format;
+}
+
+/// Throw if \p status from NetCDF function \p function isn't success
+void checkStatus(int status, const std::string& function, const NcVar& var) {
+  if (status != NC_NOERR) {
+    throw BoutException("{:s} failed for '{:s}': {:s}", function, var.getName(),
+                        nc_strerror(status));
+  }
+}
+
+/// Largest compressed chunk, in bytes. Chunks are compressed and read
+/// whole, so this bounds the memory used to read any part of a variable
+constexpr std::size_t max_chunk_bytes = 4 * 1024 * 1024;
+
+/// Chunks of a variable with dimensions \p dims, of elements of
+/// \p element_size bytes: one record of \p slab, or of the whole
+/// variable if that's empty, halved along its longest dimension until
+/// it's no more than `max_chunk_bytes`
+std::vector<std::size_t> chunkShape(const std::vector<NcDim>& dims, bool has_time,
+                                    const std::vector<std::size_t>& slab,
+                                    std::size_t element_size) {
+  const std::size_t first = has_time ? 1 : 0;
+  std::vector<std::size_t> chunks;
+  for (std::size_t i = first; i < dims.size(); ++i) {
+    const auto size = dims[i].getSize();
+    chunks.push_back(slab.empty() ? size : std::min(slab[i - first], size));
+  }
+
+  const auto bytes = [&]() {
+    return std::accumulate(chunks.begin(), chunks.end(), element_size,
+                           std::multiplies<>{});
+  };
+  while (bytes() > max_chunk_bytes) {
+    auto longest = std::max_element(chunks.begin(), chunks.end());
+    *longest = (*longest + 1) / 2;
+  }
+
+  if (has_time) {
+    chunks.insert(chunks.begin(), 1);
+  }
+  return chunks;
+}
+
+/// Set the chunking, compression and quantisation of new variable
+/// \p var, with dimensions \p dims, as in \p format. Only floating
+/// point values are compressed, in chunks of one record of \p slab,
+/// the part each processor writes, so that each output compresses
+/// the data it writes, and processors don't share chunks
+void setCompression(const NcVar& var, const std::vector<NcDim>& dims,
+                    bool has_time, const std::vector<std::size_t>& slab,
+                    const NcVarFormat& format) {
+  const auto nctype = var.getType();
+  if ((nctype != ncDouble) and (nctype != ncFloat)) {
+    return;
+  }
+  const auto spatial_dims = dims.size() - (has_time ? 1 : 0);
+  if (spatial_dims == 0) {
+    return;
+  }
+
+  if (format.significant_bits > 0) {
+#if NC_HAS_QUANTIZE
+    checkStatus(nc_def_var_quantize(var.getParentGroup().getId(), var.getId(),
+                                    NC_QUANTIZE_BITROUND, format.significant_bits),
+                "nc_def_var_quantize", var);
+#else
+    throw BoutException("Can't round '{:s}' to significant_bits, as NetCDF is older "
+                        "than 4.9.0",
+                        var.getName());
+#endif
+  }
+
+  if (format.compress.empty()) {
+    return;
+  }
+
+  const std::size_t element_size = (nctype == ncFloat) ? sizeof(float) : sizeof(double);
+  auto chunks = chunkShape(dims, has_time, slab, element_size);
+  var.setChunking(NcVar::nc_CHUNKED, chunks);
+
+  if (format.compress == "zlib") {
+    var.setCompression(true, true, format.compress_level);
+    return;
+  }
+#if NC_HAS_ZSTD
+  // Shuffle the bytes first, as zlib does
+  var.setCompression(true, false, 0);
+  checkStatus(nc_def_var_zstandard(var.getParentGroup().getId(), var.getId(),
+                                   format.compress_level),
+              "nc_def_var_zstandard", var);
+#else
+  throw BoutException("Can't compress '{:s}' with zstd, as NetCDF was built without it",
+                      var.getName());
+#endif
+}
+
+} // namespace
+
+namespace bout {
+namespace details {
+/// A variable in an open file, and what is needed to write to it
+/// again without looking anything up in the file
+struct NcCachedVariable {
+  NcVar var;
+  int type_id{0};                ///< NetCDF type of the values written
+  std::vector<std::size_t> size; ///< Spatial size of the values written
+  std::string time_name;         ///< Time dimension, or empty if none
+  NcDim time_dim;
+  std::vector<std::size_t> count; ///< Size of one record, including time
+  int time_index{0};              ///< Next record to write
+  int saved_time_index{0};        ///< Value of the attribute in the file
+  /// Attributes as last written, so that only changes are written
+  std::map<std::string, Options::AttributeType> attributes;
+};
+
+/// The variables written to an open file. The first write of each
+/// variable defines it, or checks it against the file; later writes
+/// only put the data. Their time indices are kept here, and only
+/// written to the file by `writeTimeIndices`
+struct NcSchema {
+  /// Variables by group ID and name
+  std::map<std::pair<int, std::string>, NcCachedVariable> variables;
+};
+} // namespace details
+} // namespace bout
+
+namespace {
+using bout::details::NcCachedVariable;
+using bout::details::NcSchema;
+
+/// Define variable \p name in \p group for \p value, or check that the
+/// existing variable matches it. The format is only set for new
+/// variables
+NcCachedVariable defineVariable(NcGroup& group, const std::string& name,
+                                const NcType& nctype, const std::string& time_name,
+                                const Options::ValueType& value,
+                                std::vector<std::size_t> size, bool shared,
+                                const NcVarFormat& format) {
+  // Get spatial dimensions
+  auto spatial_dims = bout::utils::visit(
+      NcDimVisitor(group, shared, format.guards, format.array_dimension), value);
+
+  // Vector of all dimensions, including time
+  std::vector<NcDim> dims{spatial_dims};
+
+  NcDim time_dim; ///< Time dimension (Null -> none)
+  if (not time_name.empty()) {
+    time_dim = group.getDim(time_name, NcGroup::ParentsAndCurrent);
+    if (time_dim.isNull()) {
+      time_dim = group.addDim(time_name);
+    }
+
+    // prepend to vector of dimensions
+    dims.insert(dims.begin(), time_dim);
+  }
+
+  // Check if the variable exists
+  auto var = group.getVar(name);
+  if (var.isNull()) {
+    // Variable doesn't exist yet
+    // Create variable
+    // Temporary NcType as a workaround for bug in NetCDF 4.4.0 and
+    // NetCDF-CXX4 4.2.0
+    var = group.addVar(name, NcType{group, nctype.getId()}, dims);
+    // In a shared file, chunk by the interior of each processor
+    const auto slab = shared ? bout::utils::visit(NcSlabVisitor(), value)
+                             : std::vector<std::size_t>{};
+    setCompression(var, dims, !time_dim.isNull(), slab, format);
+    if (!time_dim.isNull()) {
+      // Time evolving variable, so we'll need to keep track of its time index
+      var.putAtt(current_time_index_name, ncInt, 0);
+    }
+  } else {
+    // Variable does exist
+
+    // Check types are the same
+    if (var.getType() != nctype) {
+      throw BoutException(
+          "Changed type of variable '{:s}'. Was '{:s}', now writing '{:s}'", name,
+          var.getType().getName(), nctype.getName());
+    }
+
+    // Check that the dimensions are correct
+    auto var_dims = var.getDims();
+
+    // Same number of dimensions?
+    if (var_dims.size() != dims.size()) {
+      throw BoutException("Changed dimensions for variable '{:s}'\nIn file has {:d} "
+                          "dimensions, now writing {:d}\n",
+                          name, var_dims.size(), dims.size());
+    }
+    // Dimensions compatible?
+    for (std::vector<netCDF::NcDim>::size_type i = 0; i < dims.size(); ++i) {
+      if (var_dims[i] == dims[i]) {
+        continue; // The same dimension -> ok
+      }
+      if (var_dims[i].isUnlimited() != dims[i].isUnlimited()) {
+        throw BoutException("Unlimited dimension changed for variable '{:s}'", name);
+      }
+      if (var_dims[i].getSize() != dims[i].getSize()) {
+        throw BoutException("Dimension size changed for variable '{:s}'", name);
+      }
+    }
+    // All ok. Set dimensions to the variable's NcDims
+    dims = var_dims;
+
+    if (!time_dim.isNull()) {
+      // A time dimension
+      time_dim = dims[0];
+    }
+  }
+
+  if (shared) {
+    setCollective(var);
+  }
+
+  NcCachedVariable cached;
+  cached.var = var;
+  cached.type_id = nctype.getId();
+  cached.size = std::move(size);
+  cached.time_name = time_name;
+  cached.time_dim = time_dim;
+  if (not time_name.empty()) {
+    cached.time_index = getCurrentTimeIndex(var);
+    cached.saved_time_index = cached.time_index;
+    for (const auto& dim : dims) {
+      cached.count.push_back(dim.getSize());
+    }
+    cached.count[0] = 1; // Writing one record
+  }
+  return cached;
+}
+
+/// If \p shared, then \p group is in a file shared by all processors.
+/// Variables already in \p schema are written without looking them up.
+/// \p defaults are used for attributes which variables don't have
 void writeGroup(const Options& options, NcGroup group,
-                const std::string& time_dimension) {
+                const std::string& time_dimension, bool shared, NcSchema& schema,
+                const AttributeMap& defaults) {
 
   for (const auto& childpair : options.getChildren()) {
     const auto& name = childpair.first;
@@ -427,129 +1172,108 @@ void writeGroup(const Options& options, NcGroup group,
           continue; // Skip this value
         }
 
-        // Get spatial dimensions
-        auto spatial_dims = bout::utils::visit(NcDimVisitor(group), child.value);
+        // Values which are different on each processor, which can't
+        // be written to one variable
+        const auto per_processor = child.attributes.find("per_processor");
+        if (shared and (per_processor != child.attributes.end())
+            and per_processor->second.as<bool>()) {
+          continue;
+        }
+
+        if (shared and (nctype == ncString)) {
+          if (bout::utils::get<std::string>(child.value).empty()) {
+            continue; // Can't have a dimension of size 0
+          }
+          nctype = ncChar;
+        }
+        if (bout::utils::holds_alternative<Array<BoutReal>>(child.value)
+            and bout::utils::get<Array<BoutReal>>(child.value).empty()) {
+          continue; // A dimension of size 0 would be unlimited
+        }
 
-        // Vector of all dimensions, including time
-        std::vector<NcDim> dims{spatial_dims};
+        const auto format = getFormat(child.attributes, defaults);
+        const bool is_field = bout::utils::holds_alternative<Field2D>(child.value)
+                              or bout::utils::holds_alternative<Field3D>(child.value)
+                              or bout::utils::holds_alternative<FieldPerp>(child.value);
+        // Only fields are written as floats: times and scalars keep
+        // their precision. NetCDF converts the values when they're written
+        if (format.floats and is_field and (nctype == ncDouble)) {
+          nctype = ncFloat;
+        }
+        // Fields without guard cells are written as the part of a
+        // shared file which this processor would write
+        const bool interior = (not shared) and (not format.guards) and is_field;
 
         // Get the time dimension
-        NcDim time_dim; ///< Time dimension (Null -> none)
+        std::string time_name; ///< Time dimension (empty -> none)
         auto time_it = child.attributes.find("time_dimension");
         if (time_it != child.attributes.end()) {
           // Has a time dimension
 
-          const auto& time_name = bout::utils::get<std::string>(time_it->second);
+          time_name = bout::utils::get<std::string>(time_it->second);
 
           // Only write time-varying values that match current time
           // dimension being written
           if (time_name != time_dimension) {
             continue;
           }
-
-          time_dim = group.getDim(time_name, NcGroup::ParentsAndCurrent);
-          if (time_dim.isNull()) {
-            time_dim = group.addDim(time_name);
-          }
-
-          // prepend to vector of dimensions
-          dims.insert(dims.begin(), time_dim);
         }
 
-        // Check if the variable exists
-        auto var = group.getVar(name);
-        if (var.isNull()) {
-          // Variable doesn't exist yet
-          // Create variable
-          // Temporary NcType as a workaround for bug in NetCDF 4.4.0 and
-          // NetCDF-CXX4 4.2.0
-          var = group.addVar(name, NcType{group, nctype.getId()}, dims);
-          if (!time_dim.isNull()) {
-            // Time evolving variable, so we'll need to keep track of its time index
-            var.putAtt(current_time_index_name, ncInt, 0);
-          }
-        } else {
-          // Variable does exist
-
-          // Check types are the same
-          if (var.getType() != nctype) {
-            throw BoutException(
-                "Changed type of variable '{:s}'. Was '{:s}', now writing '{:s}'", name,
-                var.getType().getName(), nctype.getName());
-          }
-
-          // Check that the dimensions are correct
-          auto var_dims = var.getDims();
-
-          // Same number of dimensions?
-          if (var_dims.size() != dims.size()) {
-            throw BoutException(
-                "Changed dimensions for variable '{:s}'\nIn file has {:d} "
-                "dimensions, now writing {:d}\n",
-                name, var_dims.size(), dims.size());
-          }
-          // Dimensions compatible?
-          for (std::vector<netCDF::NcDim>::size_type i = 0; i < dims.size(); ++i) {
-            if (var_dims[i] == dims[i]) {
-              continue; // The same dimension -> ok
-            }
-            if (var_dims[i].isUnlimited() != dims[i].isUnlimited()) {
-              throw BoutException("Unlimited dimension changed for variable '{:s}'",
-                                  name);
-            }
-            if (var_dims[i].getSize() != dims[i].getSize()) {
-              throw BoutException("Dimension size changed for variable '{:s}'", name);
-            }
-          }
-          // All ok. Set dimensions to the variable's NcDims
-          dims = var_dims;
+        auto size = bout::utils::visit(NcSizeVisitor(shared, format.guards), child.value);
 
-          if (!time_dim.isNull()) {
-            // A time dimension
-            time_dim = dims[0];
-          }
+        // Look up the variable in the file the first time it's
+        // written, or if it has changed. If it's been changed
+        // incompatibly, this throws
+        auto& cached = schema.variables[{group.getId(), name}];
+        if (cached.var.isNull() or (cached.type_id != nctype.getId())
+            or (cached.size != size) or (cached.time_name != time_name)) {
+          cached = defineVariable(group, name, nctype, time_name, child.value,
+                                  std::move(size), shared, format);
         }
+        auto& var = cached.var;
 
         // Write the variable
 
-        if (time_dim.isNull()) {
+        if (time_name.empty()) {
           // No time index
 
           // Put the data into the variable
-          bout::utils::visit(NcPutVarVisitor(var), child.value);
+          if (shared or interior) {
+            bout::utils::visit(NcPutSharedVisitor(var, -1, shared), child.value);
+          } else {
+            bout::utils::visit(NcPutVarVisitor(var), child.value);
+          }
 
+        } else if (shared or interior) {
+          bout::utils::visit(NcPutSharedVisitor(var, cached.time_index, shared),
+                             child.value);
+          ++cached.time_index;
         } else {
           // Has a time index, so need the record index
 
-          const int current_time_index = getCurrentTimeIndex(var);
-
-          std::vector<size_t> start_index; ///< Starting index where data will be inserted
-          std::vector<size_t> count_index; ///< Size of each dimension
-
-          // Dimensions, including time
-          for (const auto& dim : dims) {
-            start_index.push_back(0);
-            count_index.push_back(dim.getSize());
-          }
-          // Time dimension
-          start_index[0] = current_time_index;
-          count_index[0] = 1; // Writing one record
+          ///< Starting index where data will be inserted
+          std::vector<size_t> start_index(cached.count.size(), 0);
+          start_index[0] = cached.time_index;
 
           // Put the data into the variable
-          bout::utils::visit(NcPutVarCountVisitor(var, start_index, count_index),
+          bout::utils::visit(NcPutVarCountVisitor(var, start_index, cached.count),
                              child.value);
 
-          // We've just written a new time slice, so we need to update
-          // the attribute to track it
-          var.putAtt(current_time_index_name, ncInt, current_time_index + 1);
+          // We've just written a new time slice
+          ++cached.time_index;
         }
 
-        // Write attributes
+        // Write attributes, if they've changed
         for (const auto& attribute : child.attributes) {
           const std::string& att_name = attribute.first;
           const auto& att = attribute.second;
 
+          const auto written = cached.attributes.find(att_name);
+          if ((written != cached.attributes.end()) and (written->second == att)) {
+            continue;
+          }
           bout::utils::visit(NcPutAttVisitor(var, att_name), att);
+          cached.attributes[att_name] = att;
         }
 
       } catch (const std::exception& e) {
@@ -558,17 +1282,30 @@ void writeGroup(const Options& options, NcGroup group,
     }
 
     if (child.isSection()) {
-      // Check if the group exists
-      TRACE("Writing group '{:s}'", name);
-
+      // Check if the group exists. Note: no TRACE here, as this may
+      // be run by an asynchronous writer's thread
       auto subgroup = group.getGroup(name);
       if (subgroup.isNull()) {
         // Doesn't exist yet, so create it
         subgroup = group.addGroup(name);
       }
 
-      writeGroup(child, subgroup, time_dimension);
+      writeGroup(child, subgroup, time_dimension, shared, schema, defaults);
+    }
+  }
+}
+
+/// Save the time indices of the variables in \p schema in the file,
+/// for those that have been written since they were last saved
+void writeTimeIndices(NcSchema& schema) {
+  for (auto& variable : schema.variables) {
+    auto& cached = variable.second;
+    if (cached.var.isNull() or cached.time_name.empty()
+        or (cached.time_index == cached.saved_time_index)) {
+      continue;
     }
+    cached.var.putAtt(current_time_index_name, ncInt, cached.time_index);
+    cached.saved_time_index = cached.time_index;
   }
 }
 
@@ -639,22 +1376,37 @@ std::vector<TimeDimensionError> verifyTimesteps(const NcGroup& group) {
   return errors;
 }
 
-} // namespace
-
-namespace bout {
-
-OptionsNetCDF::OptionsNetCDF() : data_file(nullptr) {}
-
-OptionsNetCDF::OptionsNetCDF(std::string filename, FileMode mode)
-    : filename(std::move(filename)), file_mode(mode), data_file(nullptr) {}
-
-OptionsNetCDF::~OptionsNetCDF() = default;
-OptionsNetCDF::OptionsNetCDF(OptionsNetCDF&&) noexcept = default;
-OptionsNetCDF& OptionsNetCDF::operator=(OptionsNetCDF&&) noexcept = default;
+/// Check the time indices of the variables written to an open file,
+/// which are kept in \p schema rather than read from the file
+std::vector<TimeDimensionError> verifyTimesteps(const NcSchema& schema) {
+  std::vector<TimeDimensionError> errors;
+  for (const auto& variable : schema.variables) {
+    const auto& cached = variable.second;
+    if (cached.var.isNull() or cached.time_name.empty()) {
+      continue;
+    }
+    const auto time_size = cached.time_dim.getSize();
+    const auto current_time = static_cast<std::size_t>(cached.time_index);
+    if (current_time != time_size) {
+      errors.push_back(
+          {variable.first.second, cached.time_name, time_size, current_time});
+    }
+  }
+  return errors;
+}
 
-void OptionsNetCDF::verifyTimesteps() const {
-  NcFile dataFile(filename, NcFile::read);
-  auto errors = ::verifyTimesteps(dataFile);
+/// Throw if the variables in \p filename with the same time dimension
+/// have different sizes in it. If the file is open for writing,
+/// \p schema has the variables written to it, and the file isn't read
+void checkTimesteps(const std::string& filename, const NcSchema* schema) {
+  std::vector<TimeDimensionError> errors;
+  if (schema != nullptr) {
+    // The time indices in the file may be out of date
+    errors = verifyTimesteps(*schema);
+  } else {
+    const NcFile dataFile(filename, NcFile::read);
+    errors = verifyTimesteps(dataFile);
+  }
 
   if (errors.empty()) {
     // No errors
@@ -672,13 +1424,334 @@ void OptionsNetCDF::verifyTimesteps() const {
                       filename, errors.size(), error_string);
 }
 
-/// Write options to file
-void OptionsNetCDF::write(const Options& options, const std::string& time_dim) {
-  Timer timer("io");
+/// Copy the data of a value, where it could otherwise be shared
+struct CopyDataVisitor {
+  template <typename T>
+  Options::ValueType operator()(const T& value) {
+    return value;
+  }
+};
+
+// Fields and Arrays share data when copied, and can be changed in
+// place: for example boundary conditions, or the solver when fields
+// share its memory. Matrix and Tensor copy on write, so are not copied
+template <>
+Options::ValueType CopyDataVisitor::operator()<Field2D>(const Field2D& value) {
+  return value.isAllocated() ? copy(value) : value;
+}
+template <>
+Options::ValueType CopyDataVisitor::operator()<Field3D>(const Field3D& value) {
+  return value.isAllocated() ? copy(value) : value;
+}
+template <>
+Options::ValueType CopyDataVisitor::operator()<FieldPerp>(const FieldPerp& value) {
+  return value.isAllocated() ? copy(value) : value;
+}
+template <>
+Options::ValueType CopyDataVisitor::operator()<Array<BoutReal>>(
+    const Array<BoutReal>& value) {
+  return copy(value);
+}
+
+/// Copy the data of the values in \p options which will be written
+/// with \p time_dimension, so that they can be written while the
+/// originals change
+void copyDataForWriting(Options& options, const std::string& time_dimension) {
+  for (const auto& childpair : options.getChildren()) {
+    auto& child = options[childpair.first];
+
+    if (child.isSection()) {
+      copyDataForWriting(child, time_dimension);
+      continue;
+    }
+    auto time_it = child.attributes.find("time_dimension");
+    if ((time_it != child.attributes.end())
+        and (bout::utils::get<std::string>(time_it->second) != time_dimension)) {
+      continue; // Not written
+    }
+    child.value = bout::utils::visit(CopyDataVisitor(), child.value);
+  }
+}
+
+} // namespace
+
+namespace bout {
+
+namespace {
+#if NC_HAS_PARALLEL4
+/// A NcFile opened by all the processors in a communicator, for
+/// parallel I/O. netCDF-cxx4 doesn't have this, but the NcFile only
+/// needs the file's ID, and closes it with nc_close as usual
+class NcParallelFile : public NcFile {
+public:
+  NcParallelFile(const std::string& path, NcFile::FileMode mode,
+                 const SharedFile& shared) {
+    auto* mpi = bout::globals::mpi;
+    MPI_Info info;
+    if (mpi->MPI_Info_create(&info) != MPI_SUCCESS) {
+      throw BoutException("Could not create MPI_Info for '{:s}'", path);
+    }
+    for (const auto& hint : shared.hints) {
+      if (mpi->MPI_Info_set(info, hint.first.c_str(), hint.second.c_str())
+          != MPI_SUCCESS) {
+        mpi->MPI_Info_free(&info);
+        throw BoutException("Could not set MPI-IO hint '{:s}' = '{:s}' for '{:s}'",
+                            hint.first, hint.second, path);
+      }
+    }
+
+    int status = NC_NOERR;
+    switch (mode) {
+    case NcFile::write:
+      status = nc_open_par(path.c_str(), NC_WRITE | NC_MPIIO, shared.comm, info, &myId);
+      break;
+    case NcFile::newFile:
+      status = nc_create_par(path.c_str(), NC_NETCDF4 | NC_MPIIO | NC_NOCLOBBER,
+                             shared.comm, info, &myId);
+      break;
+    default:
+      status = nc_create_par(path.c_str(), NC_NETCDF4 | NC_MPIIO | NC_CLOBBER,
+                             shared.comm, info, &myId);
+    }
+    mpi->MPI_Info_free(&info);
+
+    if (status != NC_NOERR) {
+      throw BoutException("Could not open NetCDF file '{:s}' for parallel writing: {:s}",
+                          path, nc_strerror(status));
+    }
+    nullObject = false;
+  }
+};
+
+std::unique_ptr<NcFile> openShared(const std::string& path, NcFile::FileMode mode,
+                                   const SharedFile& shared) {
+  return std::make_unique<NcParallelFile>(path, mode, shared);
+}
+#else
+std::unique_ptr<NcFile> openShared(const std::string& path,
+                                   NcFile::FileMode UNUSED(mode),
+                                   const SharedFile& UNUSED(shared)) {
+  throw BoutException("Can't write shared file '{:s}': NetCDF built without parallel I/O",
+                      path);
+}
+#endif
+} // namespace
+
+/// A thread which runs the writes to a file, in the order they are
+/// queued, with a limit on the number waiting. Each write holds the
+/// NetCDF lock, so the threads of different files take turns
+class OptionsNetCDF::Writer {
+public:
+  explicit Writer(int max_queued)
+      : max_queued(static_cast<std::size_t>(max_queued)), thread(&Writer::run, this) {}
+
+  /// Finishes the queued writes first. Errors from them are lost, so
+  /// should be collected with `flush` beforehand
+  ~Writer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    changed.notify_all();
+    thread.join();
+  }
+
+  Writer(const Writer&) = delete;
+  Writer& operator=(const Writer&) = delete;
+
+  /// Queue \p job, waiting while the queue is full. Throws the first
+  /// error from an earlier job, if there was one
+  void push(std::function<void()> job) {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return jobs.size() < max_queued; });
+    throwError(lock);
+    jobs.push_back(std::move(job));
+    lock.unlock();
+    changed.notify_all();
+  }
+
+  /// Wait until all the jobs have finished, then throw the first
+  /// error from them, if there was one
+  void flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return jobs.empty() and not busy; });
+    throwError(lock);
+  }
+
+private:
+  /// Throw the stored error, if any, once. Unlocks \p lock first
+  void throwError(std::unique_lock<std::mutex>& lock) {
+    if (not error) {
+      return;
+    }
+    std::exception_ptr to_throw;
+    std::swap(to_throw, error);
+    lock.unlock();
+    std::rethrow_exception(to_throw);
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      changed.wait(lock, [this]() { return stopping or not jobs.empty(); });
+      if (jobs.empty()) {
+        return; // Stopping, and nothing left to write
+      }
+      auto job = std::move(jobs.front());
+      jobs.pop_front();
+      busy = true;
+      lock.unlock();
+      // There is now space in the queue
+      changed.notify_all();
+
+      std::exception_ptr job_error;
+      try {
+        std::lock_guard<std::mutex> nc_lock(netcdfMutex());
+        job();
+      } catch (...) {
+        job_error = std::current_exception();
+      }
+      // Release the job's copy of the data outside the lock
+      job = nullptr;
+
+      lock.lock();
+      if (job_error and not error) {
+        error = job_error;
+      }
+      busy = false;
+      changed.notify_all();
+    }
+  }
+
+  std::size_t max_queued;
+  std::deque<std::function<void()>> jobs;
+  bool busy{false};     ///< Is a job running?
+  bool stopping{false}; ///< Finish once the queue is empty
+  std::exception_ptr error;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::thread thread; ///< Last, so the other members exist when it starts
+};
+
+OptionsNetCDF::OptionsNetCDF() : data_file(nullptr) {}
+
+OptionsNetCDF::OptionsNetCDF(std::string filename, FileMode mode, int async_queue)
+    : filename(std::move(filename)), file_mode(mode), data_file(nullptr) {
+  if (async_queue < 0) {
+    throw BoutException("OptionsNetCDF: async_queue must be >= 0, got {:d}",
+                        async_queue);
+  }
+  if (async_queue > 0) {
+    writer = std::make_unique<Writer>(async_queue);
+  }
+}
+
+OptionsNetCDF::OptionsNetCDF(std::string filename, SharedFile shared, FileMode mode)
+    : filename(std::move(filename)), file_mode(mode), shared(std::move(shared)),
+      data_file(nullptr) {
+  if (this->shared.comm == MPI_COMM_NULL) {
+    throw BoutException("OptionsNetCDF: no processors to share '{:s}'", this->filename);
+  }
+#if not NC_HAS_PARALLEL4
+  throw BoutException("OptionsNetCDF: can't write shared file '{:s}', as NetCDF was "
+                      "built without parallel I/O",
+                      this->filename);
+#endif
+}
+
+OptionsNetCDF::~OptionsNetCDF() {
+  // Finishes the queued writes, reporting any errors
+  try {
+    closeFile();
+  } catch (const std::exception& e) {
+    output_error.write("Error closing NetCDF file '{:s}': {:s}\n", filename, e.what());
+  }
+}
+
+OptionsNetCDF::OptionsNetCDF(OptionsNetCDF&&) noexcept = default;
+
+OptionsNetCDF& OptionsNetCDF::operator=(OptionsNetCDF&& other) noexcept {
+  try {
+    closeFile();
+  } catch (const std::exception& e) {
+    output_error.write("Error closing NetCDF file '{:s}': {:s}\n", filename, e.what());
+  }
+  // Nothing is queued now, so the thread can be stopped
+  writer.reset();
+  filename = std::move(other.filename);
+  file_mode = other.file_mode;
+  opened = other.opened;
+  shared = std::move(other.shared);
+  data_file = std::move(other.data_file);
+  read_file = std::move(other.read_file);
+  schema = std::move(other.schema);
+  default_attributes = std::move(other.default_attributes);
+  writer = std::move(other.writer);
+  return *this;
+}
+
+void OptionsNetCDF::flush() {
+  if (writer) {
+    writer->flush();
+  }
+  std::lock_guard<std::mutex> lock(netcdfMutex());
+  if (schema) {
+    writeTimeIndices(*schema);
+    data_file->sync();
+  }
+}
+
+void OptionsNetCDF::closeFile() {
+  // Close the file even if a queued write failed, then report the error
+  std::exception_ptr write_error;
+  if (writer) {
+    try {
+      writer->flush();
+    } catch (...) {
+      write_error = std::current_exception();
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(netcdfMutex());
+    if (schema) {
+      writeTimeIndices(*schema);
+    }
+    schema.reset();
+    data_file.reset();
+    read_file.reset();
+  }
+  if (write_error) {
+    std::rethrow_exception(write_error);
+  }
+}
+
+void OptionsNetCDF::verifyTimesteps() const {
+  if (writer) {
+    // Check once the queued writes are in the file
+    writer->push([filename = filename, schema = schema.get()]() {
+      checkTimesteps(filename, schema);
+    });
+    return;
+  }
+  std::lock_guard<std::mutex> lock(netcdfMutex());
+  checkTimesteps(filename, schema.get());
+}
+
+void OptionsNetCDF::openForWriting() {
+  if (data_file) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(netcdfMutex());
+  read_file.reset();
+  schema = std::make_unique<details::NcSchema>();
 
   // Check the file mode to use
   auto ncmode = NcFile::replace;
-  if (file_mode == FileMode::append) {
+  if (opened) {
+    // Reopened after reading or closing it, so carry on writing to
+    // the file rather than replacing what this object wrote
+    ncmode = NcFile::FileMode::write;
+  } else if (file_mode == FileMode::append) {
     // NetCDF doesn't have a "read-write, create if exists" mode, so
     // we need to check ourselves if the file already exists; if it
     // doesn't, tell NetCDF to create it
@@ -686,16 +1759,44 @@ void OptionsNetCDF::write(const Options& options, const std::string& time_dim) {
     ncmode = file.good() ? NcFile::FileMode::write : NcFile::FileMode::newFile;
   }
 
-  if (not data_file) {
+  if (shared.comm != MPI_COMM_NULL) {
+    data_file = openShared(filename, ncmode, shared);
+  } else {
     data_file = std::make_unique<netCDF::NcFile>(filename, ncmode);
   }
 
   if (data_file->isNull()) {
     throw BoutException("Could not open NetCDF file '{:s}' for writing", filename);
   }
+  opened = true;
+}
+
+/// Write options to file
+void OptionsNetCDF::write(const Options& options, const std::string& time_dim) {
+  Timer timer("io");
+
+  openForWriting();
+
+  if (writer) {
+    // Write a copy, so that the caller can carry on changing the
+    // originals. std::function must be copyable, hence shared_ptr
+    auto staged = std::make_shared<Options>(options);
+    copyDataForWriting(*staged, time_dim);
+    writer->push([file = data_file.get(), schema = schema.get(), staged, time_dim,
+                  defaults = default_attributes]() {
+      writeGroup(*staged, *file, time_dim, false, *schema, defaults);
+      writeTimeIndices(*schema);
+      file->sync();
+    });
+    return;
+  }
 
-  writeGroup(options, *data_file, time_dim);
+  std::lock_guard<std::mutex> lock(netcdfMutex());
+  writeGroup(options, *data_file, time_dim, shared.comm != MPI_COMM_NULL, *schema,
+             default_attributes);
 
+  // Keep the file consistent after every write, in case the run stops
+  writeTimeIndices(*schema);
   data_file->sync();
 }
 
@@ -726,6 +1827,11 @@ std::string getOutputFilename(Options& options, int rank) {
                      options["datadir"].withDefault<std::string>("data"), rank);
 }
 
+std::string getSharedOutputFilename(Options& options) {
+  return fmt::format("{}/BOUT.dmp.nc",
+                     options["datadir"].withDefault<std::string>("data"));
+}
+
 void writeDefaultOutputFile() { writeDefaultOutputFile(Options::root()); }
 
 void writeDefaultOutputFile(Options& options) {
@@ -0,0 +1,172 @@
+#include "bout/thread_pool.hxx"
+#include "bout/build_config.hxx"
+
+#if BOUT_USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace bout {
+
+namespace {
+/// The pool which this thread belongs to, if any, and its index
+thread_local const ThreadPool* worker_pool = nullptr;
+thread_local int worker_index = -1;
+
+/// Run \p task with a single OpenMP thread
+void runTask(ThreadPool::Task& task) {
+#if BOUT_USE_OPENMP
+  const int omp_threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  task();
+  omp_set_num_threads(omp_threads);
+#else
+  task();
+#endif
+}
+} // namespace
+
+ThreadPool& ThreadPool::getInstance() {
+  static ThreadPool instance;
+  return instance;
+}
+
+void ThreadPool::resize(int nthreads) {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  workers.clear();
+  queues.clear();
+  stopping = false;
+
+  for (int i = 0; i < nthreads; ++i) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+  for (int i = 0; i < nthreads; ++i) {
+    workers.emplace_back(&ThreadPool::workerLoop, this, i);
+  }
+}
+
+void ThreadPool::submit(Task task) {
+  if (workers.empty()) {
+    task();
+    return;
+  }
+  // Tasks from pool threads go on their own queue, which they take
+  // from last, so nested tasks are run soon and by the same thread.
+  // Others are shared out between the queues
+  const int own = ownQueue();
+  const std::size_t index = (own >= 0) ? static_cast<std::size_t>(own)
+                                       : next_queue.fetch_add(1) % queues.size();
+  {
+    // Counted with the queue locked, so that it can't be taken, and
+    // the count decremented, before it has been incremented
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back(std::move(task));
+    ++queued;
+  }
+  {
+    // Ensure a thread which has just found nothing to do, and is
+    // about to sleep, either sees the new count or is woken
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+  }
+  wake.notify_one();
+}
+
+bool ThreadPool::take(int own, Task& task) {
+  if (queued.load() == 0) {
+    return false;
+  }
+  const int nqueues = static_cast<int>(queues.size());
+  if (own >= 0) {
+    auto& queue = *queues[own];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (not queue.tasks.empty()) {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      --queued;
+      return true;
+    }
+  }
+  // Steal the oldest task from another queue
+  const int start = (own >= 0) ? own + 1 : 0;
+  for (int i = 0; i < nqueues; ++i) {
+    auto& queue = *queues[(start + i) % nqueues];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (not queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      --queued;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ThreadPool::runPending() {
+  Task task;
+  if (not take(ownQueue(), task)) {
+    return false;
+  }
+  runTask(task);
+  return true;
+}
+
+void ThreadPool::workerLoop(int index) {
+  worker_pool = this;
+  worker_index = index;
+#if BOUT_USE_OPENMP
+  omp_set_num_threads(1);
+#endif
+
+  Task task;
+  while (true) {
+    if (take(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    if (stopping and (queued.load() == 0)) {
+      break;
+    }
+    wake.wait(lock, [this]() { return stopping or (queued.load() > 0); });
+  }
+  worker_pool = nullptr;
+  worker_index = -1;
+}
+
+int ThreadPool::ownQueue() const { return (worker_pool == this) ? worker_index : -1; }
+
+TaskGroup::~TaskGroup() {
+  try {
+    wait();
+  } catch (...) {
+  }
+}
+
+void TaskGroup::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (pending > 0) {
+    // Help with any queued tasks, which may be this group's
+    lock.unlock();
+    const bool ran_task = pool.runPending();
+    lock.lock();
+    if (not ran_task) {
+      // The rest of the group's tasks are running in other threads
+      finished.wait(lock, [this]() { return pending == 0; });
+    }
+  }
+  std::exception_ptr to_throw;
+  std::swap(to_throw, error);
+  lock.unlock();
+  if (to_throw) {
+    std::rethrow_exception(to_throw);
+  }
+}
+
+} // namespace bout
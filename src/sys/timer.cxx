@@ -3,17 +3,15 @@
 #include <fmt/core.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
 
-Timer::Timer() : timing(getInfo("")) {
-  if (timing.counter == 0) {
-    timing.started = clock_type::now();
-    timing.running = true;
-    ++timing.hits;
-  }
-  timing.counter += 1;
-}
+Timer::Timer() : Timer("") {}
 
 Timer::Timer(const std::string& label) : timing(getInfo(label)) {
+  std::lock_guard<std::mutex> lock(info_mutex);
   if (timing.counter == 0) {
     timing.started = clock_type::now();
     timing.running = true;
@@ -23,6 +21,7 @@ Timer::Timer(const std::string& label) : timing(getInfo(label)) {
 }
 
 Timer::~Timer() {
+  std::lock_guard<std::mutex> lock(info_mutex);
   timing.counter -= 1;
   if (timing.counter == 0) {
     const auto elapsed = clock_type::now() - timing.started;
@@ -32,11 +31,16 @@ Timer::~Timer() {
   }
 }
 
-void Timer::cleanup() { info.clear(); }
+void Timer::cleanup() {
+  std::lock_guard<std::mutex> lock(info_mutex);
+  info.clear();
+}
 
 std::map<std::string, Timer::timer_info> Timer::info;
+std::mutex Timer::info_mutex;
 
 Timer::timer_info& Timer::getInfo(const std::string& label) {
+  std::lock_guard<std::mutex> lock(info_mutex);
   auto it = info.find(label);
   if (it == info.end()) {
     auto timer = info.emplace(
@@ -47,6 +51,7 @@ Timer::timer_info& Timer::getInfo(const std::string& label) {
 }
 
 double Timer::getTime(const Timer::timer_info& info) {
+  std::lock_guard<std::mutex> lock(info_mutex);
   if (info.running) {
     return seconds{info.time + (clock_type::now() - info.started)}.count();
   }
@@ -54,6 +59,7 @@ double Timer::getTime(const Timer::timer_info& info) {
 }
 
 double Timer::getTotalTime(const Timer::timer_info& info) {
+  std::lock_guard<std::mutex> lock(info_mutex);
   if (info.running) {
     return seconds{info.total_time + (clock_type::now() - info.started)}.count();
   }
@@ -61,6 +67,7 @@ double Timer::getTotalTime(const Timer::timer_info& info) {
 }
 
 double Timer::resetTime(Timer::timer_info& info) {
+  std::lock_guard<std::mutex> lock(info_mutex);
   auto current_duration = info.time;
   info.time = clock_type::duration{0};
   if (info.running) {
@@ -81,6 +88,8 @@ void Timer::printTimeReport() {
   const auto header_hits = "Hits"s;
   const auto header_mean = "Mean time/hit (s)"s;
 
+  std::lock_guard<std::mutex> lock(info_mutex);
+
   // Helper lambda to get the longest item in info, after applying
   // another lambda (op), and also taking into account the header. op
   // transforms from a map key-value pair to the length of either the
@@ -138,3 +147,244 @@ void Timer::printTimeReport() {
                  frac_width);
   }
 }
+
+namespace bout {
+namespace timing {
+
+/// A path through the regions, in one thread
+struct Node {
+  RegionId region;
+  int parent;
+  std::vector<int> children{};
+  Timer::clock_type::duration time{0};
+  unsigned long hits{0};
+};
+
+/// One time a region was entered, for the trace
+struct Event {
+  RegionId region;
+  Timer::clock_type::time_point started;
+  Timer::clock_type::duration duration;
+};
+
+struct ThreadTimes {
+  int thread; ///< Order in which threads first entered a region
+  /// Tree of paths through the regions. The first node is the root,
+  /// which isn't a region
+  std::vector<Node> nodes{Node{-1, -1}};
+  int current{0}; ///< Innermost running region
+  std::vector<Event> events{};
+
+  /// Get the node for \p region inside \p parent, adding it if needed
+  int child(int parent, RegionId region) {
+    for (const int node : nodes[parent].children) {
+      if (nodes[node].region == region) {
+        return node;
+      }
+    }
+    nodes.push_back(Node{region, parent});
+    const int node = static_cast<int>(nodes.size()) - 1;
+    nodes[parent].children.push_back(node);
+    return node;
+  }
+};
+
+namespace {
+struct Registry {
+  std::mutex mutex;
+  std::map<std::string, RegionId> ids;
+  std::vector<std::string> names;
+  /// Owned here rather than by the threads, so that the times are
+  /// kept after a thread finishes
+  std::vector<std::unique_ptr<ThreadTimes>> threads;
+  std::atomic<bool> tracing{false};
+  /// Trace times are relative to this
+  Timer::clock_type::time_point origin{Timer::clock_type::now()};
+};
+
+Registry& registry() {
+  static Registry instance;
+  return instance;
+}
+
+ThreadTimes& threadTimes() {
+  thread_local ThreadTimes* times = nullptr;
+  if (times == nullptr) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    const auto thread = static_cast<int>(reg.threads.size());
+    reg.threads.push_back(std::make_unique<ThreadTimes>(ThreadTimes{thread}));
+    times = reg.threads.back().get();
+  }
+  return *times;
+}
+
+/// Escape \p name for use as a JSON string
+std::string escapeJSON(const std::string& name) {
+  std::string result;
+  result.reserve(name.size());
+  for (const char c : name) {
+    if ((c == '"') or (c == '\\')) {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      result += fmt::format("\\u{:04x}", static_cast<int>(c));
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+} // namespace
+
+RegionId getRegionId(const std::string& name) {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  const auto it = reg.ids.find(name);
+  if (it != reg.ids.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<RegionId>(reg.names.size());
+  reg.names.push_back(name);
+  reg.ids.emplace(name, id);
+  return id;
+}
+
+std::string getRegionName(RegionId id) {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return reg.names.at(id);
+}
+
+ScopedRegion::ScopedRegion(RegionId id)
+    : times(&threadTimes()), node(times->child(times->current, id)),
+      record_event(registry().tracing.load(std::memory_order_relaxed)),
+      started(Timer::clock_type::now()) {
+  times->current = node;
+}
+
+ScopedRegion::~ScopedRegion() {
+  const auto elapsed = Timer::clock_type::now() - started;
+  auto& region = times->nodes[node];
+  region.time += elapsed;
+  ++region.hits;
+  times->current = region.parent;
+  if (record_event) {
+    times->events.push_back(Event{region.region, started, elapsed});
+  }
+}
+
+std::vector<RegionTime> getRegionTimes() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  // Merge the threads by the names along each path. Sorting the paths
+  // puts each one before the paths it encloses
+  struct Merged {
+    Timer::clock_type::duration time{0};
+    unsigned long hits{0};
+    int threads{0};
+  };
+  std::map<std::vector<std::string>, Merged> merged;
+
+  for (const auto& times : reg.threads) {
+    // Depth-first through the tree, keeping the current path
+    std::vector<std::string> path;
+    const auto visit = [&](const auto& self, int node) -> void {
+      for (const int child : times->nodes[node].children) {
+        const auto& region = times->nodes[child];
+        path.push_back(reg.names[region.region]);
+        auto& entry = merged[path];
+        entry.time += region.time;
+        entry.hits += region.hits;
+        entry.threads += 1;
+        self(self, child);
+        path.pop_back();
+      }
+    };
+    visit(visit, 0);
+  }
+
+  std::vector<RegionTime> result;
+  result.reserve(merged.size());
+  for (const auto& kv : merged) {
+    std::string path = kv.first.front();
+    for (auto name = std::next(kv.first.begin()); name != kv.first.end(); ++name) {
+      path += "/" + *name;
+    }
+    result.push_back({path, static_cast<int>(kv.first.size()) - 1,
+                      Timer::seconds{kv.second.time}.count(), kv.second.hits,
+                      kv.second.threads});
+  }
+  return result;
+}
+
+void printRegionReport() {
+  using namespace std::string_literals;
+  const auto regions = getRegionTimes();
+  if (regions.empty()) {
+    return;
+  }
+
+  // Only print the last part of each path, indented by depth
+  const auto name = [](const RegionTime& region) {
+    const auto start = region.path.rfind('/');
+    return std::string(2 * region.depth, ' ')
+           + ((start == std::string::npos) ? region.path : region.path.substr(start + 1));
+  };
+
+  std::size_t name_width = "Region"s.length();
+  for (const auto& region : regions) {
+    name_width = std::max(name_width, name(region).length());
+  }
+
+  output.write("{0:<{1}} | {2:<14} | {3:<10} | {4:<17} | {5}\n", "Region"s, name_width,
+               "Total time (s)"s, "Hits"s, "Mean time/hit (s)"s, "Threads"s);
+  output.write("{0:-<{1}}-|-{0:-<14}-|-{0:-<10}-|-{0:-<17}-|-{0:-<7}\n", ""s,
+               name_width);
+  for (const auto& region : regions) {
+    output.write("{0:<{1}} | {2:<14.9g} | {3:<10} | {4:<17.9g} | {5}\n", name(region),
+                 name_width, region.time, region.hits,
+                 region.time / static_cast<double>(region.hits), region.threads);
+  }
+}
+
+void setTracing(bool enabled) { registry().tracing = enabled; }
+
+bool isTracing() { return registry().tracing; }
+
+void writeTrace(std::ostream& out, int process) {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  using microseconds = std::chrono::duration<double, std::micro>;
+
+  // "X" events have a start time and a duration, in microseconds
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& times : reg.threads) {
+    for (const auto& event : times->events) {
+      out << (first ? "\n" : ",\n")
+          << fmt::format(R"({{"name":"{}","ph":"X","ts":{:.3f},"dur":{:.3f},)"
+                         R"("pid":{},"tid":{}}})",
+                         escapeJSON(reg.names[event.region]),
+                         microseconds{event.started - reg.origin}.count(),
+                         microseconds{event.duration}.count(), process, times->thread);
+      first = false;
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void resetRegions() {
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (auto& times : reg.threads) {
+    times->nodes.assign(1, Node{-1, -1});
+    times->current = 0;
+    times->events.clear();
+  }
+}
+
+} // namespace timing
+} // namespace bout
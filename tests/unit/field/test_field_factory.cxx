@@ -246,6 +246,71 @@ TYPED_TEST(FieldFactoryCreationTest, CreateT) {
   EXPECT_TRUE(IsFieldEqual(output, time));
 }
 
+TYPED_TEST(FieldFactoryCreationTest, CreateTimeDependent) {
+  // Create from the same generator several times, so that the
+  // time-independent parts can be reused
+  auto generator = this->factory.parse("exp(-x^2) * sin(t) + cos(z) * t");
+
+  for (auto time : {0.3, 1.7, 0.3}) {
+    auto output = this->create(generator, nullptr, CELL_CENTRE, time);
+
+    auto expected = makeField<TypeParam>(
+        [time](typename TypeParam::ind_type& index) -> BoutReal {
+          const BoutReal x = index.x();
+          const BoutReal z = TWOPI * index.z() / FieldFactoryCreationTest<TypeParam>::nz;
+          return (std::exp(-x * x) * std::sin(time)) + (std::cos(z) * time);
+        },
+        mesh);
+
+    EXPECT_TRUE(IsFieldEqual(output, expected));
+  }
+
+  // Different location, so the time-independent parts are recalculated
+  auto output = this->create(generator, this->mesh_staggered, CELL_XLOW, 0.3);
+
+  auto expected = makeField<TypeParam>(
+      [](typename TypeParam::ind_type& index) -> BoutReal {
+        const BoutReal x = index.x() - 0.5;
+        const BoutReal z = TWOPI * index.z() / FieldFactoryCreationTest<TypeParam>::nz;
+        return (std::exp(-x * x) * std::sin(0.3)) + (std::cos(z) * 0.3);
+      },
+      mesh);
+
+  EXPECT_TRUE(IsFieldEqual(output, expected));
+}
+
+TYPED_TEST(FieldFactoryCreationTest, CreateTimeDependentLimitedCache) {
+  auto generator = this->factory.parse("exp(-x^2) * sin(t) + cos(z) * t");
+
+  // 2 hoisted lines per (x, y): enough room for the time-independent parts at one location but
+  // not two, or none at all, so that values are evicted or not stored
+  for (const std::string cache_size : {"0", "300"}) {
+    Options options;
+    options["input"]["transform_from_field_aligned"] = false;
+    options["input"]["max_hoisted_cache_size"] = cache_size;
+    this->factory = FieldFactory{mesh, &options};
+
+    for (auto location : {CELL_CENTRE, CELL_XLOW, CELL_CENTRE, CELL_XLOW}) {
+      Mesh* localmesh = (location == CELL_CENTRE) ? mesh : this->mesh_staggered;
+      const BoutReal x_shift = (location == CELL_CENTRE) ? 0.0 : 0.5;
+
+      auto output = this->create(generator, localmesh, location, 1.7);
+
+      auto expected = makeField<TypeParam>(
+          [x_shift](typename TypeParam::ind_type& index) -> BoutReal {
+            const BoutReal x = index.x() - x_shift;
+            const BoutReal z =
+                TWOPI * index.z() / FieldFactoryCreationTest<TypeParam>::nz;
+            return (std::exp(-x * x) * std::sin(1.7)) + (std::cos(z) * 1.7);
+          },
+          mesh);
+
+      EXPECT_TRUE(IsFieldEqual(output, expected))
+          << "with cache size " << cache_size << " at " << toString(location);
+    }
+  }
+}
+
 TYPED_TEST(FieldFactoryCreationTest, CreateSinX) {
   auto output = this->create("sin(x)");
 
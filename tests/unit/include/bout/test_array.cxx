@@ -3,8 +3,13 @@
 #include "bout/array.hxx"
 #include "bout/boutexception.hxx"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <limits>
 #include <numeric>
+#include <thread>
+#include <vector>
 
 // In order to keep these tests independent, they need to use
 // different sized arrays in order to not just reuse the data from
@@ -243,6 +248,165 @@ TEST_F(ArrayTest, Assignment) {
   EXPECT_FALSE(b.unique());
 }
 
+TEST_F(ArrayTest, View) {
+  std::vector<double> buffer(40);
+  std::iota(buffer.begin(), buffer.end(), 0);
+
+  auto a = Array<double>::view(buffer.data(), 40);
+
+  EXPECT_FALSE(a.empty());
+  EXPECT_EQ(a.size(), 40);
+  EXPECT_TRUE(a.unique());
+  EXPECT_EQ(a.begin(), buffer.data());
+  EXPECT_DOUBLE_EQ(a[4], 4);
+
+  // Writes go to the buffer
+  a[5] = -1.0;
+  EXPECT_DOUBLE_EQ(buffer[5], -1.0);
+
+  // Unique view isn't copied
+  a.ensureUnique();
+  EXPECT_EQ(a.begin(), buffer.data());
+}
+
+TEST_F(ArrayTest, ViewMakeUnique) {
+  std::vector<double> buffer(45);
+  std::iota(buffer.begin(), buffer.end(), 0);
+
+  auto a = Array<double>::view(buffer.data(), 45);
+  Array<double> b(a);
+
+  // Shared view gets copied to new memory
+  b.ensureUnique();
+  EXPECT_NE(b.begin(), buffer.data());
+  EXPECT_EQ(a.begin(), buffer.data());
+  EXPECT_DOUBLE_EQ(b[4], 4);
+
+  b[4] = -1.0;
+  EXPECT_DOUBLE_EQ(buffer[4], 4);
+}
+
+TEST_F(ArrayTest, ViewNotInStore) {
+  std::vector<double> buffer(50);
+
+  auto a = Array<double>::view(buffer.data(), 50);
+  a.clear();
+
+  // Released views must not be reused
+  Array<double> b(50);
+  EXPECT_NE(b.begin(), buffer.data());
+}
+
+#if !BOUT_HAS_UMPIRE
+TEST_F(ArrayTest, Aligned) {
+  Array<double> a(55);
+
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.begin()) % arrayAllocation().alignment,
+            0);
+}
+
+TEST_F(ArrayTest, AllocationSettings) {
+  const auto original = arrayAllocation();
+  arrayAllocation().alignment = 4096;
+  arrayAllocation().first_touch = true;
+
+  Array<double> a(54321);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.begin()) % 4096, 0);
+  // First touch initialises the values
+  EXPECT_TRUE(std::all_of(a.begin(), a.end(), [](double x) { return x == 0.0; }));
+
+  arrayAllocation().huge_pages = true;
+  arrayAllocation().huge_page_size = 1 << 16;
+  Array<double> b(76543);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.begin()) % (1 << 16), 0);
+
+  arrayAllocation() = original;
+}
+#endif
+
+TEST_F(ArrayTest, ReuseSizeClass) {
+  Array<double> a(100);
+  const double* data = a.begin();
+  a.clear();
+
+  // Smaller array in the same size class
+  Array<double> b(98);
+  EXPECT_EQ(b.size(), 98);
+  EXPECT_EQ(std::distance(b.begin(), b.end()), 98);
+  if (b.useStore()) {
+    EXPECT_EQ(b.begin(), data);
+  }
+}
+
+TEST_F(ArrayTest, ReuseLargerInSizeClass) {
+  // Allocated with the capacity of its class, 97 to 112
+  Array<double> a(98);
+  const double* data = a.begin();
+  a.clear();
+
+  Array<double> b(110);
+  EXPECT_EQ(b.size(), 110);
+  if (b.useStore()) {
+    EXPECT_EQ(b.begin(), data);
+  }
+}
+
+TEST_F(ArrayTest, PoolStats) {
+  const auto before = Array<double>::poolStats();
+
+  Array<double> a(1234);
+  a.clear();
+  const auto released = Array<double>::poolStats();
+  Array<double> b(1234);
+  const auto after = Array<double>::poolStats();
+
+  if (a.useStore()) {
+    EXPECT_EQ(after.hits + after.misses, before.hits + before.misses + 2);
+    EXPECT_GE(after.hits, before.hits + 1);
+    EXPECT_GE(released.bytes_held, before.bytes_held + (1234 * sizeof(double)));
+    EXPECT_GE(released.peak_bytes_held, released.bytes_held);
+    EXPECT_EQ(after.bytes_held, before.bytes_held);
+  }
+}
+
+TEST_F(ArrayTest, ReleaseOnOtherThread) {
+  Array<double> a(2345);
+  const double* data = a.begin();
+
+  std::thread other([&a]() { a.clear(); });
+  other.join();
+
+  // Returned to this thread's cache
+  Array<double> b(2345);
+  if (b.useStore()) {
+    EXPECT_EQ(b.begin(), data);
+  }
+}
+
+TEST_F(ArrayTest, PoolLimit) {
+  Array<double> a(3456);
+  Array<double>::setPoolLimit(0);
+
+  const auto before = Array<double>::poolStats();
+  a.clear();
+  const auto after = Array<double>::poolStats();
+
+  Array<double>::setPoolLimit(std::numeric_limits<std::size_t>::max());
+
+  if (a.useStore()) {
+    EXPECT_EQ(after.discarded, before.discarded + 1);
+    EXPECT_EQ(after.bytes_held, before.bytes_held);
+  }
+}
+
+TEST_F(ArrayTest, VectorBacking) {
+  Array<int, std::vector<int>> a(20);
+  a.clear();
+
+  Array<int, std::vector<int>> b(17);
+  EXPECT_EQ(b.size(), 17);
+}
+
 #if CHECK > 2 && !BOUT_HAS_CUDA
 TEST_F(ArrayTest, OutOfBoundsThrow) {
   Array<double> a(34);
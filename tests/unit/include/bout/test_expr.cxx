@@ -0,0 +1,103 @@
+#include "gtest/gtest.h"
+
+#include "test_extras.hxx"
+#include "bout/expr.hxx"
+#include "bout/field2d.hxx"
+#include "bout/field3d.hxx"
+#include "bout/mesh.hxx"
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+using bout::expr::lazy;
+
+// Reuse the "standard" fixture for FakeMesh
+using ExprTest = FakeMeshFixture;
+
+TEST_F(ExprTest, Field3D) {
+  const auto a = makeField<Field3D>(
+      [](Ind3D& i) { return i.x() + (2. * i.y()) + (0.5 * i.z()) + 1.; });
+  Field3D b, c, d, e, f;
+  b = a + 1.0;
+  c = a * a;
+  d = 2.0;
+  e = a - 0.5;
+  f = c + 3.0;
+
+  const Field3D expected = a * b + c * d - e / f;
+  const Field3D result = lazy(a) * b + lazy(c) * d - lazy(e) / f;
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+  EXPECT_EQ(result.getLocation(), a.getLocation());
+}
+
+TEST_F(ExprTest, Scalars) {
+  Field3D a = 3.0;
+  Field3D result = 2.0 * lazy(a) - 1;
+  EXPECT_TRUE(IsFieldEqual(result, 5.0));
+
+  result = 1.0 / lazy(a) + a / 2.0;
+  EXPECT_TRUE(IsFieldEqual(result, 1.0 / 3.0 + 1.5));
+
+  result = -lazy(a) * -(lazy(a) + 1);
+  EXPECT_TRUE(IsFieldEqual(result, 12.0));
+}
+
+TEST_F(ExprTest, Broadcast2D) {
+  const auto a = makeField<Field3D>(
+      [](Ind3D& i) { return i.x() + (2. * i.y()) + (0.5 * i.z()) + 1.; });
+  const auto b = makeField<Field2D>([](Ind2D& i) { return (3. * i.x()) - i.y(); });
+
+  // 2D first, so the metadata is taken from the Field3D
+  const Field3D result = lazy(b) * a + b;
+  const Field3D expected = b * a + b;
+
+  EXPECT_TRUE(IsFieldEqual(result, expected));
+}
+
+TEST_F(ExprTest, Field2D) {
+  Field2D a = 2.0;
+  Field2D b = 3.0;
+
+  const Field2D result = lazy(a) * b + 1.0;
+
+  EXPECT_TRUE(IsFieldEqual(result, 7.0));
+}
+
+TEST_F(ExprTest, Assignment) {
+  Field3D a = 2.0;
+  Field3D b = 3.0;
+  Field3D result = 1.0;
+
+  result = lazy(a) * b;
+
+  EXPECT_TRUE(IsFieldEqual(result, 6.0));
+  // Operands aren't changed
+  EXPECT_TRUE(IsFieldEqual(a, 2.0));
+  EXPECT_TRUE(IsFieldEqual(b, 3.0));
+}
+
+#if CHECK > 0
+TEST_F(ExprTest, EmptyField) {
+  Field3D a = 2.0;
+  Field3D empty;
+
+  EXPECT_THROW(Field3D result = lazy(a) * empty, BoutException);
+}
+
+TEST_F(ExprTest, DifferentLocations) {
+  Field3D a{mesh_staggered};
+  Field3D b{mesh_staggered};
+  a = 2.0;
+  b = 1.0;
+  b.setLocation(CELL_XLOW);
+
+  EXPECT_THROW(Field3D result = lazy(a) + b, BoutException);
+}
+#endif
@@ -1,7 +1,12 @@
 #include "gtest/gtest.h"
 
+#include "test_extras.hxx"
 #include "bout/boutexception.hxx"
 #include "bout/monitor.hxx"
+#include "bout/options.hxx"
+#include "bout/sys/timer.hxx"
+
+#include <vector>
 
 TEST(MonitorTest, IsMultiple) {
   EXPECT_TRUE(isMultiple(1., 4.));
@@ -31,3 +36,78 @@ TEST(MonitorTest, IsMultipleConditions) {
   EXPECT_THROW(isMultiple(4., -1.), BoutException);
 }
 #endif
+
+// For the MPI wrapper
+using RunMetricsTest = FakeMeshFixture;
+
+TEST_F(RunMetricsTest, MaxOverProcessors) {
+  RunMetrics metrics;
+  metrics.wtime = 2.0;
+  metrics.ncalls = 4;
+  metrics.ncalls_e = 1;
+  metrics.ncalls_i = 3;
+  metrics.wtime_rhs = 1.5;
+
+  // Only one processor in unit tests, so the values are unchanged
+  const auto max = metrics.maxOverProcessors();
+  EXPECT_DOUBLE_EQ(max.wtime, 2.0);
+  EXPECT_EQ(max.ncalls, 4);
+  EXPECT_EQ(max.ncalls_e, 1);
+  EXPECT_EQ(max.ncalls_i, 3);
+  EXPECT_DOUBLE_EQ(max.wtime_rhs, 1.5);
+  // Derived from the maxima
+  EXPECT_DOUBLE_EQ(max.wtime_per_rhs, 0.5);
+  EXPECT_DOUBLE_EQ(max.wtime_per_rhs_i, 2.0 / 3);
+}
+
+class TimerImbalanceTest : public FakeMeshFixture {
+public:
+  // Only see the timers made by each test
+  TimerImbalanceTest() { Timer::cleanup(); }
+  ~TimerImbalanceTest() override { Timer::cleanup(); }
+};
+
+TEST_F(TimerImbalanceTest, Gather) {
+  { Timer timer("imbalance:test"); }
+
+  TimerImbalance imbalance;
+  imbalance.gather(*bout::globals::mesh);
+
+  ASSERT_EQ(imbalance.timers.count("imbalance:test"), 1);
+  const auto stats = imbalance.timers.at("imbalance:test");
+  EXPECT_GE(stats.max, 0.0);
+  // Only one processor in unit tests
+  EXPECT_DOUBLE_EQ(stats.min, stats.max);
+  EXPECT_DOUBLE_EQ(stats.mean, stats.max);
+  EXPECT_EQ(stats.max_rank, 0);
+
+  EXPECT_EQ(imbalance.local_nx, std::vector<int>{nx - 2});
+  EXPECT_EQ(imbalance.local_ny, std::vector<int>{ny - 2});
+  EXPECT_EQ(imbalance.local_nz, std::vector<int>{nz});
+  EXPECT_EQ(imbalance.pe_xind, std::vector<int>{1});
+  EXPECT_EQ(imbalance.pe_yind, std::vector<int>{1});
+
+  // Only the time since the last call is counted
+  imbalance.gather(*bout::globals::mesh);
+  EXPECT_DOUBLE_EQ(imbalance.timers.at("imbalance:test").max, 0.0);
+
+  Options output;
+  imbalance.outputVars(output);
+  auto& section = output["timing_imbalance"];
+  ASSERT_TRUE(section.isSection("imbalance_test"));
+  EXPECT_DOUBLE_EQ(section["imbalance_test"]["max"].as<BoutReal>(), 0.0);
+  EXPECT_EQ(section["imbalance_test"]["max_rank"].as<int>(), 0);
+  EXPECT_DOUBLE_EQ(section["local_nx"].as<Array<BoutReal>>()[0], nx - 2);
+}
+
+TEST_F(TimerImbalanceTest, OutputNameCollision) {
+  // Both are written as "imbalance_collision"
+  { Timer timer("imbalance:collision"); }
+  { Timer timer("imbalance_collision"); }
+
+  TimerImbalance imbalance;
+  imbalance.gather(*bout::globals::mesh);
+
+  Options output;
+  EXPECT_THROW(imbalance.outputVars(output), BoutException);
+}
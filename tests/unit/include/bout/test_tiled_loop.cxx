@@ -0,0 +1,57 @@
+#include "gtest/gtest.h"
+
+#include "test_extras.hxx"
+#include "bout/field3d.hxx"
+#include "bout/mesh.hxx"
+#include "bout/tiled_loop.hxx"
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+using bout::TiledLoop;
+
+class TiledLoopTest : public FakeMeshFixture {
+public:
+  TiledLoopTest()
+      : a(makeField<Field3D>(
+          [](Ind3D& i) { return i.x() + (2. * i.y()) + (0.5 * i.z()) + 1.; })),
+        b(a * a), c(a + 2.0), tmp(emptyFrom(a)), result(emptyFrom(a)),
+        expected(emptyFrom(a)) {
+    BOUT_FOR(i, a.getRegion("RGN_NOX")) {
+      expected[i] = (a[i] * b[i] + c[i]) * (c[i.xp()] - c[i.xm()]);
+    }
+    loop.then([&](const Ind3D& i) { tmp[i] = a[i] * b[i] + c[i]; })
+        .then([&](const Ind3D& i) { result[i] = tmp[i] * (c[i.xp()] - c[i.xm()]); });
+  }
+
+  Field3D a, b, c, tmp, result, expected;
+  TiledLoop<Ind3D> loop{a.getRegion("RGN_NOX")};
+};
+
+TEST_F(TiledLoopTest, Size) { EXPECT_EQ(loop.size(), 2); }
+
+TEST_F(TiledLoopTest, Run) {
+  loop.run();
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOX"));
+}
+
+TEST_F(TiledLoopTest, RunByStage) {
+  loop.runByStage();
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOX"));
+}
+
+TEST_F(TiledLoopTest, RunTwice) {
+  loop.run();
+  c += 1.0;
+  BOUT_FOR(i, a.getRegion("RGN_NOX")) {
+    expected[i] = (a[i] * b[i] + c[i]) * (c[i.xp()] - c[i.xm()]);
+  }
+  loop.run();
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOX"));
+}
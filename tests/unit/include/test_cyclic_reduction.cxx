@@ -81,6 +81,39 @@ TEST(CyclicReduction, SerialSolveSingleMatrix) {
   EXPECT_NEAR(x(0, 4), -2.75, CyclicReduceTolerance);
 }
 
+TEST(CyclicReduction, SerialSolveRepeated) {
+  using namespace bout::testing;
+  CyclicReduce<BoutReal> reduce{BoutComm::get(), reduction_size};
+
+  auto a = makeArrayFromVector({0., 1., 1., 1., 1.});
+  auto b = makeArrayFromVector({5., 4., 3., 2., 1.});
+  auto c = makeArrayFromVector({2., 2., 2., 2., 0.});
+
+  // Set the coefficients once, then solve with different RHS
+  reduce.setCoefs(a, b, c);
+
+  auto rhs = makeArrayFromVector({0., 1., 2., 2., 3.});
+  Array<BoutReal> x{reduction_size};
+
+  reduce.solve(rhs, x);
+
+  EXPECT_NEAR(x[0], -1., CyclicReduceTolerance);
+  EXPECT_NEAR(x[1], 2.5, CyclicReduceTolerance);
+  EXPECT_NEAR(x[2], -4., CyclicReduceTolerance);
+  EXPECT_NEAR(x[3], 5.75, CyclicReduceTolerance);
+  EXPECT_NEAR(x[4], -2.75, CyclicReduceTolerance);
+
+  rhs = makeArrayFromVector({1., 0., 0., 0., -1.});
+
+  reduce.solve(rhs, x);
+
+  EXPECT_NEAR(x[0], 2. / 3., CyclicReduceTolerance);
+  EXPECT_NEAR(x[1], -7. / 6., CyclicReduceTolerance);
+  EXPECT_NEAR(x[2], 2., CyclicReduceTolerance);
+  EXPECT_NEAR(x[3], -29. / 12., CyclicReduceTolerance);
+  EXPECT_NEAR(x[4], 17. / 12., CyclicReduceTolerance);
+}
+
 TEST(CyclicReduction, SerialSolveDoubleMatrix) {
   using namespace bout::testing;
   CyclicReduce<BoutReal> reduce{BoutComm::get(), reduction_size};
@@ -142,4 +142,45 @@ TEST_P(CyclicTest, DummyTest) {
   // No test yet
 }
 
+#if BOUT_HAS_FFTW
+// Solving needs FFTs
+TEST_P(CyclicTest, RepeatedSolve) {
+  const Field3D first = solver.solve(f3);
+  // Second solve reuses the matrices from the first
+  const Field3D second = solver.solve(f3);
+
+  EXPECT_TRUE(IsFieldEqual(second, first, "RGN_NOY", tol));
+}
+
+TEST_P(CyclicTest, SolveAfterSetCoef) {
+  solver.solve(f3);
+  solver.setCoefA(coef2);
+  const Field3D result = solver.solve(f3);
+
+  // A new solver only ever sees the new coefficient
+  LaplaceCyclic fresh{&Options::root()["laplace"]};
+  fresh.setCoefA(coef2);
+  const Field3D expected = fresh.solve(f3);
+
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOY", tol));
+}
+
+TEST_P(CyclicTest, SolveAfterSetFlags) {
+  solver.solve(f3);
+  // Dirichlet conditions with the boundary RHS set to zero
+  solver.setInnerBoundaryFlags(0);
+  solver.setOuterBoundaryFlags(0);
+  solver.solve(f3);
+  // The boundary RHS must still be zeroed when the matrices are reused
+  const Field3D result = solver.solve(f3);
+
+  LaplaceCyclic fresh{&Options::root()["laplace"]};
+  fresh.setInnerBoundaryFlags(0);
+  fresh.setOuterBoundaryFlags(0);
+  const Field3D expected = fresh.solve(f3);
+
+  EXPECT_TRUE(IsFieldEqual(result, expected, "RGN_NOY", tol));
+}
+#endif // BOUT_HAS_FFTW
+
 #endif // BOUT_USE_METRIC_3D
@@ -111,4 +111,95 @@ TEST_P(FFTTest, RoundTrip) {
     EXPECT_NEAR(output[i], real_signal[i], FFTTolerance);
   }
 }
+
+TEST_P(FFTTest, rfftAlternatingLengths) {
+  // Plans for different lengths should be able to coexist
+  const int other_size = 2 * size;
+  Array<BoutReal> other_signal{other_size};
+  std::fill(other_signal.begin(), other_signal.end(), 1.0);
+  Array<dcomplex> other_output{(other_size / 2) + 1};
+
+  Array<dcomplex> output{nmodes};
+
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    rfft(real_signal.begin(), size, output.begin());
+    rfft(other_signal.begin(), other_size, other_output.begin());
+
+    for (int i = 0; i < nmodes; ++i) {
+      EXPECT_NEAR(real(output[i]), real(fft_signal[i]), FFTTolerance);
+      EXPECT_NEAR(imag(output[i]), imag(fft_signal[i]), FFTTolerance);
+    }
+    EXPECT_NEAR(real(other_output[0]), 1.0, FFTTolerance);
+    EXPECT_NEAR(real(other_output[1]), 0.0, FFTTolerance);
+  }
+}
+
+TEST_P(FFTTest, rfftMisaligned) {
+  // Start the signal one element into the array, so that it has a
+  // different alignment to the start of the array
+  Array<BoutReal> input{size + 1};
+  std::copy(real_signal.begin(), real_signal.end(), input.begin() + 1);
+
+  Array<dcomplex> output{nmodes + 1};
+
+  rfft(input.begin() + 1, size, output.begin() + 1);
+
+  for (int i = 0; i < nmodes; ++i) {
+    EXPECT_NEAR(real(output[i + 1]), real(fft_signal[i]), FFTTolerance);
+    EXPECT_NEAR(imag(output[i + 1]), imag(fft_signal[i]), FFTTolerance);
+  }
+}
+
+TEST_P(FFTTest, rfftMany) {
+  // Three copies of the signal, padded so that the distance between
+  // them is larger than the signal length
+  constexpr int howmany = 3;
+  const int in_dist = size + 2;
+  const int out_dist = nmodes + 1;
+
+  Array<BoutReal> input{howmany * in_dist};
+  for (int n = 0; n < howmany; ++n) {
+    std::copy(real_signal.begin(), real_signal.end(), input.begin() + (n * in_dist));
+  }
+
+  Array<dcomplex> output{howmany * out_dist};
+
+  bout::fft::rfft_many(input.begin(), size, howmany, in_dist, output.begin(), out_dist);
+
+  for (int n = 0; n < howmany; ++n) {
+    for (int i = 0; i < nmodes; ++i) {
+      EXPECT_NEAR(real(output[(n * out_dist) + i]), real(fft_signal[i]), FFTTolerance);
+      EXPECT_NEAR(imag(output[(n * out_dist) + i]), imag(fft_signal[i]), FFTTolerance);
+    }
+  }
+}
+
+TEST_P(FFTTest, irfftMany) {
+  constexpr int howmany = 3;
+  const int in_dist = nmodes + 1;
+  const int out_dist = size + 2;
+
+  Array<dcomplex> input{howmany * in_dist};
+  for (int n = 0; n < howmany; ++n) {
+    std::copy(fft_signal.begin(), fft_signal.end(), input.begin() + (n * in_dist));
+  }
+
+  Array<BoutReal> output{howmany * out_dist};
+
+  bout::fft::irfft_many(input.begin(), size, howmany, in_dist, output.begin(), out_dist);
+
+  for (int n = 0; n < howmany; ++n) {
+    for (int i = 0; i < size; ++i) {
+      EXPECT_NEAR(output[(n * out_dist) + i], real_signal[i], FFTTolerance);
+    }
+  }
+
+  // Input should not have been modified
+  for (int n = 0; n < howmany; ++n) {
+    for (int i = 0; i < nmodes; ++i) {
+      EXPECT_NEAR(real(input[(n * in_dist) + i]), real(fft_signal[i]), FFTTolerance);
+      EXPECT_NEAR(imag(input[(n * in_dist) + i]), imag(fft_signal[i]), FFTTolerance);
+    }
+  }
+}
 #endif
@@ -0,0 +1,149 @@
+// Test reading parts of fields from a grid file
+
+#include "bout/build_config.hxx"
+
+#if BOUT_HAS_NETCDF && !BOUT_HAS_LEGACY_NETCDF
+
+#include "gtest/gtest.h"
+
+#include "test_extras.hxx"
+#include "bout/griddata.hxx"
+#include "bout/mesh.hxx"
+#include "bout/options.hxx"
+#include "bout/options_netcdf.hxx"
+
+#include <cstdio>
+#include <string>
+
+using bout::OptionsNetCDF;
+
+/// The global mesh is one processor's part of a larger grid, offset
+/// in X and Y so that it reads the middle of the variables in the file
+class GridFileTest : public FakeMeshFixture {
+public:
+  GridFileTest() : FakeMeshFixture() {
+    bout::globals::mesh->GlobalNx = global_nx;
+    bout::globals::mesh->GlobalNy = global_ny;
+    bout::globals::mesh->OffsetX = offset_x;
+    bout::globals::mesh->OffsetY = offset_y;
+
+    global_mesh.createDefaultRegions();
+    global_mesh.setCoordinates(nullptr);
+  }
+  ~GridFileTest() override { std::remove(filename.c_str()); }
+
+  static constexpr int global_nx = nx + 2;
+  static constexpr int global_ny = ny + 4;
+  static constexpr int offset_x = 1;
+  static constexpr int offset_y = 2;
+
+  /// Mesh covering the whole grid, used to make the variables in the file
+  FakeMesh global_mesh{global_nx, global_ny, nz};
+
+  std::string filename{std::tmpnam(nullptr)};
+  WithQuietOutput quiet_info{output_info};
+  WithQuietOutput quiet_warn{output_warn};
+};
+
+constexpr int GridFileTest::global_nx;
+constexpr int GridFileTest::global_ny;
+constexpr int GridFileTest::offset_x;
+constexpr int GridFileTest::offset_y;
+
+TEST_F(GridFileTest, HasVar) {
+  {
+    Options options;
+    options["nz"] = nz;
+    options["f"] = Field3D(1.0, &global_mesh);
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  GridFile grid{filename};
+
+  // Fields aren't read until they're needed
+  EXPECT_TRUE(grid.hasVar("f"));
+  EXPECT_TRUE(grid.hasVar("nz"));
+  EXPECT_FALSE(grid.hasVar("missing"));
+}
+
+TEST_F(GridFileTest, GetField2D) {
+  const Field2D field = makeField<Field2D>(
+      [](Ind2D& i) { return i.x() + 0.1 * i.y(); }, &global_mesh);
+  {
+    Options options;
+    options["y_boundary_guards"] = 1;
+    options["f"] = field;
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  GridFile grid{filename};
+  Field2D result;
+  EXPECT_TRUE(grid.get(bout::globals::mesh, result, "f"));
+
+  for (int x = 0; x < nx; ++x) {
+    for (int y = 0; y < ny; ++y) {
+      EXPECT_DOUBLE_EQ(result(x, y), field(x + offset_x, y + offset_y));
+    }
+  }
+}
+
+TEST_F(GridFileTest, GetField3D) {
+  const Field3D field = makeField<Field3D>(
+      [](Ind3D& i) { return i.x() + 0.1 * i.y() + 0.01 * i.z(); }, &global_mesh);
+  {
+    Options options;
+    options["y_boundary_guards"] = 1;
+    options["nz"] = nz;
+    options["f"] = field;
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  GridFile grid{filename};
+  Field3D result;
+  EXPECT_TRUE(grid.get(bout::globals::mesh, result, "f"));
+
+  for (int x = 0; x < nx; ++x) {
+    for (int y = 0; y < ny; ++y) {
+      for (int z = 0; z < nz; ++z) {
+        EXPECT_DOUBLE_EQ(result(x, y, z), field(x + offset_x, y + offset_y, z));
+      }
+    }
+  }
+}
+
+#if BOUT_HAS_FFTW
+TEST_F(GridFileTest, GetField3DFFT) {
+  // Without "nz" in the file, the Z direction holds Fourier modes.
+  // With only the DC component, every Z point has the same value
+  FakeMesh fft_mesh{global_nx, global_ny, 1};
+  fft_mesh.createDefaultRegions();
+  fft_mesh.setCoordinates(nullptr);
+
+  const Field3D field =
+      makeField<Field3D>([](Ind3D& i) { return i.x() + 0.1 * i.y(); }, &fft_mesh);
+  {
+    Options options;
+    options["y_boundary_guards"] = 1;
+    options["f"] = field;
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  GridFile grid{filename};
+  Field3D result;
+  EXPECT_TRUE(grid.get(bout::globals::mesh, result, "f"));
+
+  for (int x = 0; x < nx; ++x) {
+    for (int y = 0; y < ny; ++y) {
+      for (int z = 0; z < nz; ++z) {
+        EXPECT_DOUBLE_EQ(result(x, y, z), field(x + offset_x, y + offset_y, 0));
+      }
+    }
+  }
+}
+#endif // BOUT_HAS_FFTW
+
+#endif // BOUT_HAS_NETCDF
@@ -5,6 +5,7 @@
 #include "bout/griddata.hxx"
 #include "bout/options.hxx"
 #include "bout/output.hxx"
+#include "bout/paralleltransform.hxx"
 
 #include "test_extras.hxx"
 
@@ -27,6 +28,10 @@ public:
       : BoutMesh((nxpe * (nx - 2)) + 2, nype * ny, nz, 1, 1, nxpe, nype, pe_xind, pe_yind,
                  create_topology, symmetric_X, symmetric_Y) {}
   BoutMeshExposer(const BoutMeshParameters& inputs, bool periodicX_ = false);
+  BoutMeshExposer(GridDataSource* source, Options* options) : BoutMesh(source, options) {}
+  void setCoordinates(std::shared_ptr<Coordinates> coords) {
+    coords_map[CELL_CENTRE] = std::move(coords);
+  }
   // Make protected methods public for testing
   using BoutMesh::add_target;
   using BoutMesh::addBoundaryRegions;
@@ -37,12 +42,14 @@ public:
   using BoutMesh::default_connections;
   using BoutMesh::findProcessorSplit;
   using BoutMesh::getConnectionInfo;
+  using BoutMesh::pack_data;
   using BoutMesh::PROC_NUM;
   using BoutMesh::set_connection;
   using BoutMesh::setShiftAngle;
   using BoutMesh::setXDecompositionIndices;
   using BoutMesh::setYDecompositionIndices;
   using BoutMesh::topology;
+  using BoutMesh::unpack_data;
   using BoutMesh::XDecompositionIndices;
   using BoutMesh::XPROC;
   using BoutMesh::YDecompositionIndices;
@@ -2157,3 +2164,302 @@ TEST(BoutMeshTest, GetPossibleBoundariesDND) {
   EXPECT_EQ(mesh_DND_1x6.getPossibleBoundaries(), boundaries);
   EXPECT_EQ(mesh_DND_32x64.getPossibleBoundaries(), boundaries);
 }
+
+namespace {
+/// Pack a group of fields point by point, in the same order as
+/// `BoutMesh::pack_data`
+std::vector<BoutReal> packPointwise(const Mesh& mesh, const std::vector<Field3D>& f3d,
+                                    const std::vector<Field2D>& f2d, int xge, int xlt,
+                                    int yge, int ylt) {
+  std::vector<BoutReal> buffer;
+  for (std::size_t var = 0; var < f3d.size(); ++var) {
+    for (int jx = xge; jx < xlt; ++jx) {
+      for (int jy = yge; jy < ylt; ++jy) {
+        for (int jz = 0; jz < mesh.LocalNz; ++jz) {
+          buffer.push_back(f3d[var](jx, jy, jz));
+        }
+      }
+    }
+    for (int jx = xge; jx < xlt; ++jx) {
+      for (int jy = yge; jy < ylt; ++jy) {
+        buffer.push_back(f2d[var](jx, jy));
+      }
+    }
+  }
+  return buffer;
+}
+
+/// Pack and unpack alternating Field3Ds and Field2Ds, for blocks
+/// covering guard cells in x and y, whole x-slices, and nothing
+void checkPackUnpack(BoutMeshExposer& mesh) {
+  constexpr int nvars = 2;
+  std::vector<Field3D> f3d(nvars, Field3D{&mesh});
+  std::vector<Field2D> f2d(nvars, Field2D{&mesh});
+  std::vector<FieldData*> var_list;
+  for (int var = 0; var < nvars; ++var) {
+    f3d[var].allocate();
+    f2d[var].allocate();
+    for (int jx = 0; jx < mesh.LocalNx; ++jx) {
+      for (int jy = 0; jy < mesh.LocalNy; ++jy) {
+        f2d[var](jx, jy) = 1000. * var + 100. * jx + jy;
+        for (int jz = 0; jz < mesh.LocalNz; ++jz) {
+          f3d[var](jx, jy, jz) = -f2d[var](jx, jy) - 0.01 * jz;
+        }
+      }
+    }
+    var_list.push_back(&f3d[var]);
+    var_list.push_back(&f2d[var]);
+  }
+
+  struct Block {
+    int xge, xlt, yge, ylt;
+  };
+  const std::vector<Block> blocks = {
+      {0, mesh.xstart, mesh.ystart, mesh.yend + 1},
+      {mesh.xstart, mesh.xend + 1, 0, mesh.ystart},
+      {mesh.xend + 1 - mesh.xstart, mesh.LocalNx, 0, mesh.LocalNy},
+      {0, mesh.LocalNx, 0, mesh.LocalNy},
+      {mesh.xstart, mesh.xstart, 0, mesh.LocalNy},
+  };
+
+  for (const auto& block : blocks) {
+    const auto expected =
+        packPointwise(mesh, f3d, f2d, block.xge, block.xlt, block.yge, block.ylt);
+
+    std::vector<BoutReal> buffer(expected.size() + 1, -1.0);
+    EXPECT_EQ(mesh.pack_data(var_list, block.xge, block.xlt, block.yge, block.ylt,
+                             buffer.data()),
+              static_cast<int>(expected.size()));
+    EXPECT_EQ(std::vector<BoutReal>(buffer.begin(), buffer.end() - 1), expected);
+    // Nothing written past the end
+    EXPECT_EQ(buffer.back(), -1.0);
+
+    // Unpacking into copies gives back the original values in the
+    // block, and leaves the rest of the fields alone
+    std::vector<Field3D> g3d;
+    std::vector<Field2D> g2d;
+    std::vector<FieldData*> copy_list;
+    for (int var = 0; var < nvars; ++var) {
+      g3d.emplace_back(0.0, &mesh);
+      g2d.emplace_back(0.0, &mesh);
+    }
+    for (int var = 0; var < nvars; ++var) {
+      copy_list.push_back(&g3d[var]);
+      copy_list.push_back(&g2d[var]);
+    }
+    EXPECT_EQ(mesh.unpack_data(copy_list, block.xge, block.xlt, block.yge, block.ylt,
+                               buffer.data()),
+              static_cast<int>(expected.size()));
+
+    for (int var = 0; var < nvars; ++var) {
+      for (int jx = 0; jx < mesh.LocalNx; ++jx) {
+        for (int jy = 0; jy < mesh.LocalNy; ++jy) {
+          const bool in_block = (jx >= block.xge) and (jx < block.xlt)
+                                and (jy >= block.yge) and (jy < block.ylt);
+          EXPECT_EQ(g2d[var](jx, jy), in_block ? f2d[var](jx, jy) : 0.0);
+          for (int jz = 0; jz < mesh.LocalNz; ++jz) {
+            EXPECT_EQ(g3d[var](jx, jy, jz), in_block ? f3d[var](jx, jy, jz) : 0.0);
+          }
+        }
+      }
+    }
+  }
+}
+} // namespace
+
+TEST(BoutMeshTest, PackUnpackData) {
+  WithQuietOutput info{output_info};
+  WithQuietOutput warn{output_warn};
+
+  BoutMeshExposer mesh(6, 4, 3, 1, 1, 0, 0);
+  mesh.setCoordinates(nullptr);
+  checkPackUnpack(mesh);
+}
+
+TEST(BoutMeshTest, PackUnpackDataLarge) {
+  WithQuietOutput info{output_info};
+  WithQuietOutput warn{output_warn};
+
+  // Large enough that the fields are packed in parallel
+  BoutMeshExposer mesh(18, 16, 64, 1, 1, 0, 0);
+  mesh.setCoordinates(nullptr);
+  checkPackUnpack(mesh);
+}
+
+/// Passes calls through to MPI, counting the persistent requests
+/// created and started, and optionally failing MPI_Startall
+class CountingMpiWrapper : public MpiWrapper {
+public:
+  int MPI_Recv_init(void* buf, int count, MPI_Datatype datatype, int source, int tag,
+                    MPI_Comm comm, MPI_Request* request) override {
+    ++recv_init;
+    return MpiWrapper::MPI_Recv_init(buf, count, datatype, source, tag, comm, request);
+  }
+  int MPI_Send_init(const void* buf, int count, MPI_Datatype datatype, int dest, int tag,
+                    MPI_Comm comm, MPI_Request* request) override {
+    ++send_init;
+    return MpiWrapper::MPI_Send_init(buf, count, datatype, dest, tag, comm, request);
+  }
+  int MPI_Startall(int count, MPI_Request array_of_requests[]) override {
+    ++startall;
+    if (fail_startall) {
+      return MPI_ERR_OTHER;
+    }
+    return MpiWrapper::MPI_Startall(count, array_of_requests);
+  }
+  int recv_init{0};
+  int send_init{0};
+  int startall{0};
+  bool fail_startall{false};
+};
+
+/// A single processor mesh, periodic in both x and y, so that every
+/// neighbour is this processor and every message is sent to itself
+class BoutMeshCommPlanTest : public ::testing::Test {
+public:
+  BoutMeshCommPlanTest() { bout::globals::mpi = &mpi; }
+  ~BoutMeshCommPlanTest() override {
+    bout::globals::mpi = nullptr;
+    Options::cleanup();
+  }
+
+  std::unique_ptr<BoutMeshExposer> makeMesh(int myg, int ny = 4) {
+    options["nx"] = 8;
+    options["ny"] = ny;
+    options["nz"] = 4;
+    options["MXG"] = 2;
+    options["MYG"] = myg;
+    options["include_corner_cells"] = false;
+    // There are no coordinates to calculate parallel slices with
+    options["calcParallelSlices_on_communicate"] = false;
+    // BoutMesh::load reads this from the root options
+    Options::root()["periodicX"] = true;
+
+    auto mesh = bout::utils::make_unique<BoutMeshExposer>(
+        new GridFromOptions{&options}, &options);
+    mesh->load();
+    mesh->setCoordinates(nullptr);
+    return mesh;
+  }
+
+  /// Give every point a different value, and set the guard cells to
+  /// something which can't be communicated
+  template <class T>
+  static void fill(T& field) {
+    field.allocate();
+    BOUT_FOR(i, field.getRegion("RGN_ALL")) { field[i] = -1.0; }
+    BOUT_FOR(i, field.getRegion("RGN_NOBNDRY")) {
+      field[i] = static_cast<BoutReal>(i.ind);
+    }
+  }
+
+  WithQuietOutput debug{output_debug};
+  WithQuietOutput info{output_info};
+  WithQuietOutput warn{output_warn};
+  WithQuietOutput progress{output_progress};
+
+  CountingMpiWrapper mpi;
+  Options options;
+};
+
+TEST_F(BoutMeshCommPlanTest, MatchesCommunicate) {
+  auto mesh = makeMesh(2);
+
+  Field3D plan_3d{mesh.get()}, expected_3d{mesh.get()};
+  Field2D plan_2d{mesh.get()}, expected_2d{mesh.get()};
+
+  auto plan = mesh->createCommPlan(plan_3d, plan_2d);
+  // The whole domain is inside the separatrix, so there is one
+  // neighbour in each y direction, and one in each x direction
+  EXPECT_EQ(mpi.recv_init, 4);
+  EXPECT_EQ(mpi.send_init, 4);
+
+  // The plan can be reused, including after the field data is reallocated
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    plan_3d = Field3D{mesh.get()};
+    fill(plan_3d);
+    fill(plan_2d);
+    fill(expected_3d);
+    fill(expected_2d);
+
+    plan->start();
+    plan->wait();
+    mesh->communicate(expected_3d, expected_2d);
+
+    EXPECT_TRUE(IsFieldEqual(plan_3d, expected_3d, "RGN_ALL", 0.0));
+    EXPECT_TRUE(IsFieldEqual(plan_2d, expected_2d, "RGN_ALL", 0.0));
+    // Check the guard cells were actually filled in
+    EXPECT_EQ(plan_3d(mesh->xstart, 0, 0), expected_3d(mesh->xstart, mesh->yend - 1, 0));
+    EXPECT_EQ(plan_3d(0, mesh->ystart, 0), expected_3d(mesh->xend - 1, mesh->ystart, 0));
+  }
+  // Receives and sends are started separately
+  EXPECT_EQ(mpi.startall, 4);
+}
+
+TEST_F(BoutMeshCommPlanTest, MatchesCommunicateNoYGuards) {
+  // Without y guard cells, the points sent in x are contiguous, and
+  // are copied as a single run per field. As in a 2D simulation, there
+  // is only one point in y, so the metric can be calculated
+  auto mesh = makeMesh(0, 1);
+
+  Field3D plan_3d{mesh.get()}, expected_3d{mesh.get()};
+  Field2D plan_2d{mesh.get()}, expected_2d{mesh.get()};
+  fill(plan_3d);
+  fill(plan_2d);
+  fill(expected_3d);
+  fill(expected_2d);
+
+  auto plan = mesh->createCommPlan(plan_2d, plan_3d);
+  plan->start();
+  plan->wait();
+  mesh->communicate(expected_2d, expected_3d);
+
+  EXPECT_TRUE(IsFieldEqual(plan_3d, expected_3d, "RGN_ALL", 0.0));
+  EXPECT_TRUE(IsFieldEqual(plan_2d, expected_2d, "RGN_ALL", 0.0));
+  EXPECT_EQ(plan_3d(0, 0, 0), expected_3d(mesh->xend - 1, 0, 0));
+}
+
+TEST_F(BoutMeshCommPlanTest, MPIFailure) {
+  auto mesh = makeMesh(2);
+
+  Field3D field{mesh.get()};
+  fill(field);
+
+  auto plan = mesh->createCommPlan(field);
+  mpi.fail_startall = true;
+  EXPECT_THROW(plan->start(), BoutException);
+
+  // A failed start leaves the plan usable
+  mpi.fail_startall = false;
+  EXPECT_NO_THROW(plan->start());
+  EXPECT_NO_THROW(plan->wait());
+}
+
+#if BOUT_HAS_FFTW
+TEST_F(BoutMeshCommPlanTest, TwistShift) {
+  auto mesh = makeMesh(2);
+  mesh->setShiftAngle(std::vector<BoutReal>(mesh->LocalNx, 0.5));
+
+  const auto one = Field2D{1.0, mesh.get()};
+  const auto zero = Field2D{0.0, mesh.get()};
+  auto coords = std::make_shared<Coordinates>(mesh.get(), one, one, one, one, one, one,
+                                              one, one, zero, zero, zero, one, one, one,
+                                              zero, zero, zero, zero, zero);
+  coords->setParallelTransform(
+      bout::utils::make_unique<ParallelTransformIdentity>(*mesh));
+  mesh->setCoordinates(coords);
+
+  Field3D plan_3d{mesh.get()}, expected_3d{mesh.get()};
+  fill(plan_3d);
+  fill(expected_3d);
+
+  auto plan = mesh->createCommPlan(plan_3d);
+  plan->start();
+  plan->wait();
+  mesh->communicate(expected_3d);
+
+  EXPECT_TRUE(IsFieldEqual(plan_3d, expected_3d, "RGN_ALL", 1e-12));
+  // Communicated values in the y guard cells are shifted in z
+  EXPECT_NE(plan_3d(mesh->xstart, 0, 0), plan_3d(mesh->xstart, mesh->yend - 1, 0));
+}
+#endif
@@ -0,0 +1,105 @@
+#include "gtest/gtest.h"
+
+#include "test_extras.hxx"
+
+#include "bout/derivs.hxx"
+#include "bout/difops.hxx"
+#include "bout/fused_derivs.hxx"
+
+#include <random>
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+
+using bout::derivatives::PerpDerivatives;
+
+namespace {
+Field3D randomField(std::default_random_engine& re) {
+  std::uniform_real_distribution<double> unif(-1.0, 1.0);
+  Field3D result;
+  result.allocate();
+  BOUT_FOR(i, result.getRegion("RGN_ALL")) { result[i] = unif(re); }
+  return result;
+}
+
+// Operations are done in a different order, so may differ by rounding
+constexpr BoutReal tolerance = 1e-12;
+} // namespace
+
+// Reuse the "standard" fixture for FakeMesh. The default derivative
+// methods are C2, which the fused kernels use
+using FusedDerivsTest = FakeMeshFixture;
+
+TEST_F(FusedDerivsTest, SingleInput) {
+  std::default_random_engine re;
+  const auto input = randomField(re);
+
+  Field3D ddx, ddz, d2dx2, d2dz2, d2dxdz, delp2;
+  PerpDerivatives()
+      .DDX(input, ddx)
+      .DDZ(input, ddz)
+      .D2DX2(input, d2dx2)
+      .D2DZ2(input, d2dz2)
+      .D2DXDZ(input, d2dxdz)
+      .Delp2(input, delp2)
+      .run();
+
+  EXPECT_TRUE(IsFieldEqual(ddx, DDX(input), "RGN_NOBNDRY", tolerance));
+  EXPECT_TRUE(IsFieldEqual(ddz, DDZ(input), "RGN_NOBNDRY", tolerance));
+  EXPECT_TRUE(IsFieldEqual(d2dx2, D2DX2(input), "RGN_NOBNDRY", tolerance));
+  EXPECT_TRUE(IsFieldEqual(d2dz2, D2DZ2(input), "RGN_NOBNDRY", tolerance));
+  EXPECT_TRUE(IsFieldEqual(d2dxdz, D2DXDZ(input), "RGN_NOBNDRY", tolerance));
+  EXPECT_TRUE(IsFieldEqual(delp2, Delp2(input, CELL_DEFAULT, false), "RGN_NOBNDRY",
+                           tolerance));
+}
+
+#if not(BOUT_USE_METRIC_3D)
+TEST_F(FusedDerivsTest, SeveralInputs) {
+  std::default_random_engine re;
+  const auto phi = randomField(re);
+  const auto n = randomField(re);
+  const auto vort = randomField(re);
+
+  Field3D n_adv, vort_adv, dphidz;
+  PerpDerivatives sweep;
+  sweep.bracket(phi, n, n_adv).bracket(phi, vort, vort_adv).DDZ(phi, dphidz);
+  sweep.run();
+
+  EXPECT_TRUE(
+      IsFieldEqual(n_adv, bracket(phi, n, BRACKET_ARAKAWA), "RGN_NOBNDRY", tolerance));
+  EXPECT_TRUE(IsFieldEqual(vort_adv, bracket(phi, vort, BRACKET_ARAKAWA), "RGN_NOBNDRY",
+                           tolerance));
+  EXPECT_TRUE(IsFieldEqual(dphidz, DDZ(phi), "RGN_NOBNDRY", tolerance));
+}
+#endif
+
+#if CHECK > 0
+TEST_F(FusedDerivsTest, OutputIsInput) {
+  std::default_random_engine re;
+  auto input = randomField(re);
+
+  EXPECT_THROW(PerpDerivatives().DDX(input, input).run(), BoutException);
+}
+#endif
+
+TEST_F(FusedDerivsTest, DefaultMethodsAreC2) {
+  EXPECT_TRUE(PerpDerivatives::defaultMethodsAreC2());
+
+  auto& store = DerivativeStore<Field3D>::getInstance();
+  store.forceDefaultMethod("C4", DERIV::StandardSecond, DIRECTION::X);
+  EXPECT_FALSE(PerpDerivatives::defaultMethodsAreC2());
+  store.forceDefaultMethod("C2", DERIV::StandardSecond, DIRECTION::X);
+
+  store.forceDefaultMethod("FFT", DERIV::Standard, DIRECTION::Z);
+  EXPECT_FALSE(PerpDerivatives::defaultMethodsAreC2());
+  store.forceDefaultMethod("C2", DERIV::Standard, DIRECTION::Z);
+
+  EXPECT_TRUE(PerpDerivatives::defaultMethodsAreC2());
+}
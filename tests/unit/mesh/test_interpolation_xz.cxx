@@ -0,0 +1,216 @@
+#include "gtest/gtest.h"
+
+#include "test_extras.hxx"
+#include "bout/constants.hxx"
+#include "bout/field3d.hxx"
+#include "bout/interpolation_xz.hxx"
+#include "bout/mesh.hxx"
+#include "bout/output.hxx"
+#include "bout/utils.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <list>
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+
+/// Test fixture with enough points in x that the spline stencil stays
+/// inside the domain
+class XZHermiteSplineTest : public ::testing::Test {
+protected:
+  static void SetUpTestCase() {
+    WithQuietOutput quiet_info{output_info};
+    WithQuietOutput quiet_warn{output_warn};
+    delete mesh;
+    mesh = new FakeMesh(nx, ny, nz);
+    mesh->createDefaultRegions();
+
+    for (const auto& location :
+         std::list<CELL_LOC>{CELL_CENTRE, CELL_XLOW, CELL_YLOW, CELL_ZLOW}) {
+
+      static_cast<FakeMesh*>(mesh)->setCoordinates(nullptr, location);
+      static_cast<FakeMesh*>(mesh)->setCoordinates(
+          std::make_shared<Coordinates>(
+              mesh, Field2D{1.0, mesh}, Field2D{1.0, mesh}, BoutReal{1.0},
+              Field2D{1.0, mesh}, Field2D{0.0, mesh}, Field2D{1.0, mesh},
+              Field2D{1.0, mesh}, Field2D{1.0, mesh}, Field2D{0.0, mesh},
+              Field2D{0.0, mesh}, Field2D{0.0, mesh}, Field2D{1.0, mesh},
+              Field2D{1.0, mesh}, Field2D{1.0, mesh}, Field2D{0.0, mesh},
+              Field2D{0.0, mesh}, Field2D{0.0, mesh}, Field2D{0.0, mesh},
+              Field2D{0.0, mesh}),
+          location);
+      mesh->getCoordinates(location)->setParallelTransform(
+          bout::utils::make_unique<ParallelTransformIdentity>(*mesh));
+    }
+  }
+
+  static void TearDownTestCase() {
+    delete mesh;
+    mesh = nullptr;
+  }
+
+  /// Analytic test function, periodic in z
+  static BoutReal func(int x, int y, int z) {
+    return (x * x) + ((1. + y) * std::cos(TWOPI * z / nz));
+  }
+
+  /// Second-order central differences of func, as used by the spline
+  static BoutReal func_x(int x, int y, int z) {
+    return 0.5 * (func(x + 1, y, z) - func(x - 1, y, z));
+  }
+  static BoutReal func_z(int x, int y, int z) {
+    return 0.5 * (func(x, y, (z + 1) % nz) - func(x, y, (z - 1 + nz) % nz));
+  }
+  static BoutReal func_xz(int x, int y, int z) {
+    return 0.5 * (func_z(x + 1, y, z) - func_z(x - 1, y, z));
+  }
+
+  /// The spline through func, evaluated at delta_x = x + 0.3 and
+  /// delta_z = z + 0.25 in the y-slice \p y
+  static BoutReal expected(int x, int y, int z, int xend) {
+    // Points beyond the last interior cell are clamped to its far side
+    const int ic = std::min(x, xend - 1);
+    const BoutReal t_x = (x == ic) ? 0.3 : 1.0;
+    const BoutReal t_z = 0.25;
+
+    const BoutReal h00_x = (2. * t_x * t_x * t_x) - (3. * t_x * t_x) + 1.;
+    const BoutReal h01_x = (-2. * t_x * t_x * t_x) + (3. * t_x * t_x);
+    const BoutReal h10_x = t_x * (1. - t_x) * (1. - t_x);
+    const BoutReal h11_x = (t_x * t_x * t_x) - (t_x * t_x);
+    const BoutReal h00_z = (2. * t_z * t_z * t_z) - (3. * t_z * t_z) + 1.;
+    const BoutReal h01_z = (-2. * t_z * t_z * t_z) + (3. * t_z * t_z);
+    const BoutReal h10_z = t_z * (1. - t_z) * (1. - t_z);
+    const BoutReal h11_z = (t_z * t_z * t_z) - (t_z * t_z);
+
+    const int kc = z;
+    const int kcp1 = (z + 1) % nz;
+
+    const BoutReal f_z = (func(ic, y, kc) * h00_x) + (func(ic + 1, y, kc) * h01_x)
+                         + (func_x(ic, y, kc) * h10_x) + (func_x(ic + 1, y, kc) * h11_x);
+    const BoutReal f_zp1 = (func(ic, y, kcp1) * h00_x) + (func(ic + 1, y, kcp1) * h01_x)
+                           + (func_x(ic, y, kcp1) * h10_x)
+                           + (func_x(ic + 1, y, kcp1) * h11_x);
+    const BoutReal fz_z = (func_z(ic, y, kc) * h00_x) + (func_z(ic + 1, y, kc) * h01_x)
+                          + (func_xz(ic, y, kc) * h10_x)
+                          + (func_xz(ic + 1, y, kc) * h11_x);
+    const BoutReal fz_zp1 = (func_z(ic, y, kcp1) * h00_x)
+                            + (func_z(ic + 1, y, kcp1) * h01_x)
+                            + (func_xz(ic, y, kcp1) * h10_x)
+                            + (func_xz(ic + 1, y, kcp1) * h11_x);
+
+    return (f_z * h00_z) + (f_zp1 * h01_z) + (fz_z * h10_z) + (fz_zp1 * h11_z);
+  }
+
+  /// Fill \p f with func, and set the offsets used by `expected`
+  static void fill(Field3D& f, Field3D& delta_x, Field3D& delta_z) {
+    for (int x = 0; x < nx; ++x) {
+      for (int y = 0; y < ny; ++y) {
+        for (int z = 0; z < nz; ++z) {
+          f(x, y, z) = func(x, y, z);
+          delta_x(x, y, z) = x + 0.3;
+          delta_z(x, y, z) = z + 0.25;
+        }
+      }
+    }
+  }
+
+public:
+  static constexpr int nx = 7;
+  static constexpr int ny = 5;
+  static constexpr int nz = 8;
+};
+
+TEST_F(XZHermiteSplineTest, Interpolate) {
+  Field3D f{0.0, mesh};
+  Field3D delta_x{0.0, mesh};
+  Field3D delta_z{0.0, mesh};
+  fill(f, delta_x, delta_z);
+
+  XZHermiteSpline interp{mesh};
+  const Field3D result = interp.interpolate(f, delta_x, delta_z);
+
+  for (int x = mesh->xstart; x <= mesh->xend; ++x) {
+    for (int y = mesh->ystart; y <= mesh->yend; ++y) {
+      for (int z = 0; z < nz; ++z) {
+        EXPECT_NEAR(result(x, y, z), expected(x, y, z, mesh->xend), 1e-12)
+            << "at (" << x << ", " << y << ", " << z << ")";
+      }
+    }
+  }
+}
+
+TEST_F(XZHermiteSplineTest, InterpolateYOffset) {
+  Field3D f{0.0, mesh};
+  Field3D delta_x{0.0, mesh};
+  Field3D delta_z{0.0, mesh};
+  fill(f, delta_x, delta_z);
+
+  // Interpolates from, and stores the result in, the next y-slice
+  XZHermiteSpline interp{1, mesh};
+  const Field3D result = interp.interpolate(f, delta_x, delta_z);
+
+  // The derivatives in the y-guard cells come from communication,
+  // which the FakeMesh doesn't do, so only check the interior
+  for (int x = mesh->xstart; x <= mesh->xend; ++x) {
+    for (int y = mesh->ystart; y < mesh->yend; ++y) {
+      for (int z = 0; z < nz; ++z) {
+        EXPECT_NEAR(result(x, y + 1, z), expected(x, y + 1, z, mesh->xend), 1e-12)
+            << "at (" << x << ", " << y << ", " << z << ")";
+      }
+    }
+  }
+}
+
+TEST_F(XZHermiteSplineTest, InterpolateMonotonic) {
+  Field3D f{0.0, mesh};
+  Field3D delta_x{0.0, mesh};
+  Field3D delta_z{0.0, mesh};
+  fill(f, delta_x, delta_z);
+
+  // A step in z, which the plain spline overshoots either side of
+  for (int x = 0; x < nx; ++x) {
+    for (int y = 0; y < ny; ++y) {
+      for (int z = 0; z < nz; ++z) {
+        f(x, y, z) = (z < nz / 2) ? 1.0 : 0.0;
+      }
+    }
+  }
+
+  XZHermiteSpline interp{mesh};
+  const Field3D spline = interp.interpolate(f, delta_x, delta_z);
+
+  XZMonotonicHermiteSpline monotonic_interp{mesh};
+  const Field3D result = monotonic_interp.interpolate(f, delta_x, delta_z);
+
+  int clamped = 0;
+  for (int x = mesh->xstart; x <= mesh->xend; ++x) {
+    const int ic = std::min(x, mesh->xend - 1);
+    for (int y = mesh->ystart; y <= mesh->yend; ++y) {
+      for (int z = 0; z < nz; ++z) {
+        const int kcp1 = (z + 1) % nz;
+        const BoutReal localmax =
+            BOUTMAX(f(ic, y, z), f(ic + 1, y, z), f(ic, y, kcp1), f(ic + 1, y, kcp1));
+        const BoutReal localmin =
+            BOUTMIN(f(ic, y, z), f(ic + 1, y, z), f(ic, y, kcp1), f(ic + 1, y, kcp1));
+
+        const BoutReal expected_value =
+            std::min(std::max(spline(x, y, z), localmin), localmax);
+        if (expected_value != spline(x, y, z)) {
+          ++clamped;
+        }
+
+        EXPECT_NEAR(result(x, y, z), expected_value, 1e-12)
+            << "at (" << x << ", " << y << ", " << z << ")";
+      }
+    }
+  }
+  EXPECT_GT(clamped, 0);
+}
@@ -293,3 +293,21 @@ TEST_F(MeshTest, MsgLen) {
 
   EXPECT_EQ(len, 2 * (nx * ny * nz) + 2 * (nx * ny));
 }
+
+TEST_F(MeshTest, CommPlan) {
+  localmesh.createDefaultRegions();
+  localmesh.setCoordinates(nullptr);
+
+  Field3D f3D(1., &localmesh);
+  Field2D f2D(2., &localmesh);
+
+  auto plan = localmesh.createCommPlan(f3D, f2D);
+  ASSERT_NE(plan, nullptr);
+
+  // The plan can be reused, including after the field data is reallocated
+  EXPECT_NO_THROW(plan->start());
+  EXPECT_NO_THROW(plan->wait());
+  f3D = Field3D(3., &localmesh);
+  EXPECT_NO_THROW(plan->start());
+  EXPECT_NO_THROW(plan->wait());
+}
@@ -63,15 +63,19 @@ public:
   // Shims for protected functions
   auto getMaxTimestepShim() const -> BoutReal { return max_dt; }
   using Solver::call_monitors;
+  using Solver::can_alias_state;
   using Solver::call_timestep_monitors;
   using Solver::getLocalN;
   using Solver::getMonitors;
   using Solver::globalIndex;
   using Solver::hasJacobian;
   using Solver::hasPreconditioner;
+  using Solver::load_vars;
   using Solver::MonitorInfo;
   using Solver::runJacobian;
   using Solver::runPreconditioner;
+  using Solver::save_derivs;
+  using Solver::save_vars;
 };
 
 // Equality operator for tests
@@ -67,6 +67,28 @@ public:
   using PhysicsModel::setSplitOperator;
 };
 
+/// Evolves dn/dt = -n^2. If \p in_place, the RHS also changes `n` in
+/// place, which it shouldn't
+class DecayModel : public PhysicsModel {
+public:
+  explicit DecayModel(bool in_place = false)
+      : PhysicsModel(bout::globals::mesh, false, false), in_place(in_place) {}
+  int init(bool) override {
+    SOLVE_FOR(n);
+    return 0;
+  }
+  int rhs(BoutReal) override {
+    if (in_place) {
+      n *= 2.0;
+    }
+    ddt(n) = -n * n;
+    return 0;
+  }
+
+  Field3D n;
+  bool in_place;
+};
+
 } // namespace
 
 class SolverTest : public FakeMeshFixture {
@@ -635,6 +657,228 @@ TEST_F(SolverTest, GetLocalN) {
   EXPECT_EQ(solver.getLocalN(), expected_total);
 }
 
+TEST_F(SolverTest, SaveLoadVars) {
+  Options options;
+  FakeSolver solver{&options};
+
+  Options::root()["field1"]["evolve_bndry"] = true;
+  Options::root()["field3"]["evolve_bndry"] = true;
+  Options::root()["input"]["transform_from_field_aligned"] = false;
+
+  Field2D field1{bout::globals::mesh};
+  Field2D field2{bout::globals::mesh};
+  Field3D field3{bout::globals::mesh};
+  Field3D field4{bout::globals::mesh};
+
+  solver.add(field1, "field1");
+  solver.add(field2, "field2");
+  solver.add(field3, "field3");
+  solver.add(field4, "field4");
+
+  solver.init();
+
+  field1.allocate();
+  field2.allocate();
+  field3.allocate();
+  field4.allocate();
+
+  BOUT_FOR_SERIAL(i, field1.getRegion("RGN_ALL")) { field1[i] = i.ind; }
+  BOUT_FOR_SERIAL(i, field2.getRegion("RGN_ALL")) { field2[i] = -i.ind; }
+  BOUT_FOR_SERIAL(i, field3.getRegion("RGN_ALL")) { field3[i] = 0.5 * i.ind; }
+  BOUT_FOR_SERIAL(i, field4.getRegion("RGN_ALL")) { field4[i] = -0.5 * i.ind; }
+
+  // The state vector is interleaved: boundary points first, then the
+  // bulk, with all 2D variables then the 3D variables for each z
+  std::vector<BoutReal> expected;
+  const auto add_point = [&](const Ind2D& i2d, bool bndry) {
+    expected.push_back(field1[i2d]);
+    if (not bndry) {
+      expected.push_back(field2[i2d]);
+    }
+    for (int jz = 0; jz < nz; ++jz) {
+      const auto i3d = bout::globals::mesh->ind2Dto3D(i2d, jz);
+      expected.push_back(field3[i3d]);
+      if (not bndry) {
+        expected.push_back(field4[i3d]);
+      }
+    }
+  };
+  for (const auto& i2d : bout::globals::mesh->getRegion2D("RGN_BNDRY")) {
+    add_point(i2d, true);
+  }
+  for (const auto& i2d : bout::globals::mesh->getRegion2D("RGN_NOBNDRY")) {
+    add_point(i2d, false);
+  }
+
+  std::vector<BoutReal> state(expected.size(), -1.0);
+  solver.save_vars(state.data());
+
+  EXPECT_EQ(state, expected);
+
+  const Field2D expected1 = field1;
+  const Field2D expected2 = field2;
+  const Field3D expected3 = field3;
+  const Field3D expected4 = field4;
+
+  field1 = 0.0;
+  field2 = 0.0;
+  field3 = 0.0;
+  field4 = 0.0;
+
+  solver.load_vars(state.data());
+
+  EXPECT_TRUE(IsFieldEqual(field1, expected1, "RGN_ALL"));
+  EXPECT_TRUE(IsFieldEqual(field2, expected2, "RGN_NOBNDRY"));
+  EXPECT_TRUE(IsFieldEqual(field3, expected3, "RGN_ALL"));
+  EXPECT_TRUE(IsFieldEqual(field4, expected4, "RGN_NOBNDRY"));
+}
+
+TEST_F(SolverTest, ZeroCopyVars) {
+  Options options;
+  options["zero_copy"] = true;
+  FakeSolver solver{&options};
+  solver.can_alias_state = true;
+
+  Options::root()["input"]["transform_from_field_aligned"] = false;
+
+  Field2D field1{bout::globals::mesh};
+  Field3D field2{bout::globals::mesh};
+
+  solver.add(field1, "field1");
+  solver.add(field2, "field2");
+
+  solver.init();
+
+  field1.allocate();
+  field2.allocate();
+  BOUT_FOR_SERIAL(i, field1.getRegion("RGN_ALL")) { field1[i] = i.ind; }
+  BOUT_FOR_SERIAL(i, field2.getRegion("RGN_ALL")) { field2[i] = 0.5 * i.ind; }
+
+  // State holds whole fields, including guard cells
+  constexpr auto size_2d = nx * ny;
+  constexpr auto size_3d = nx * ny * nz;
+  std::vector<BoutReal> state(size_2d + size_3d, -1.0);
+
+  solver.save_vars(state.data());
+
+  EXPECT_DOUBLE_EQ(state[1], 1.0);
+  EXPECT_DOUBLE_EQ(state[size_2d + 1], 0.5);
+
+  // Loading shares memory rather than copying
+  solver.load_vars(state.data());
+
+  EXPECT_EQ(&field1(0, 0), &state[0]);
+  EXPECT_EQ(&field2(0, 0, 0), &state[size_2d]);
+
+  state[1] = -1.0;
+  state[size_2d + 1] = -2.0;
+  EXPECT_DOUBLE_EQ(field1(0, 1), -1.0);
+  EXPECT_DOUBLE_EQ(field2(0, 0, 1), -2.0);
+
+  // Time derivatives are zero outside the evolving region
+  ddt(field1) = 1.0;
+  ddt(field2) = 2.0;
+
+  std::vector<BoutReal> derivs(size_2d + size_3d, -1.0);
+  solver.save_derivs(derivs.data());
+
+  const Field2D dfield1{Array<BoutReal>::view(&derivs[0], size_2d),
+                        bout::globals::mesh};
+  const Field3D dfield2{Array<BoutReal>::view(&derivs[size_2d], size_3d),
+                        bout::globals::mesh};
+
+  EXPECT_TRUE(IsFieldEqual(dfield1, 1.0, "RGN_NOBNDRY"));
+  EXPECT_TRUE(IsFieldEqual(dfield2, 2.0, "RGN_NOBNDRY"));
+  EXPECT_DOUBLE_EQ(dfield1(0, 0), 0.0);
+  EXPECT_DOUBLE_EQ(dfield2(0, 0, 0), 0.0);
+}
+
+TEST_F(SolverTest, ZeroCopyUnaliasOnThrow) {
+  WithQuietOutput quiet_error{output_error};
+
+  /// Points the variables into its own state vector before throwing
+  class AliasingSolver : public FakeSolver {
+  public:
+    using FakeSolver::FakeSolver;
+    int run() override {
+      state.resize(getLocalN());
+      save_vars(state.data());
+      load_vars(state.data());
+      return FakeSolver::run();
+    }
+    std::vector<BoutReal> state;
+  };
+
+  Options options;
+  options["zero_copy"] = true;
+  options["throw_run"] = true;
+  AliasingSolver solver{&options};
+  solver.can_alias_state = true;
+
+  Options::root()["input"]["transform_from_field_aligned"] = false;
+
+  Field3D field{1.0, bout::globals::mesh};
+  solver.add(field, "field");
+
+  MockPhysicsModel model{};
+  EXPECT_CALL(model, init(false)).Times(1);
+  EXPECT_CALL(model, postInit(false)).Times(1);
+  solver.setModel(&model);
+
+  EXPECT_CALL(model, rhs(0)).Times(1);
+
+  EXPECT_THROW(solver.solve(), BoutException);
+
+  ASSERT_TRUE(solver.run_called);
+  ASSERT_FALSE(solver.state.empty());
+  EXPECT_NE(&field(0, 0, 0), &solver.state[0]);
+  EXPECT_TRUE(IsFieldEqual(field, 1.0, "RGN_NOBNDRY"));
+}
+
+TEST_F(SolverTest, ZeroCopyRK4) {
+  Options::root()["input"]["transform_from_field_aligned"] = false;
+  Options::root()["n"]["function"] = "1.0";
+
+  const auto solve = [](bool zero_copy) {
+    Options options;
+    options["zero_copy"] = zero_copy;
+    options["timestep"] = 0.01;
+    auto solver = Solver::create("rk4", &options);
+    DecayModel model;
+    solver->setModel(&model);
+    solver->solve(2, 0.1);
+    return model.n;
+  };
+
+  const Field3D copied = solve(false);
+  const Field3D aliased = solve(true);
+
+  // The same steps, so the same result
+  EXPECT_TRUE(IsFieldEqual(aliased, copied, "RGN_NOBNDRY"));
+  EXPECT_NEAR(aliased(1, 1, 1), 1. / 1.2, 1e-8);
+}
+
+#if CHECK > 1
+TEST_F(SolverTest, ZeroCopyChangedInPlace) {
+  Options::root()["input"]["transform_from_field_aligned"] = false;
+  Options::root()["n"]["function"] = "1.0";
+
+  Options options;
+  options["zero_copy"] = true;
+  auto solver = Solver::create("rk4", &options);
+  DecayModel model{true};
+  solver->setModel(&model);
+
+  try {
+    solver->solve(1, 0.1);
+    FAIL() << "Changing 'n' in place didn't throw";
+  } catch (BoutException& e) {
+    const std::string message{e.what()};
+    EXPECT_NE(message.find("evolving variable 'n'"), std::string::npos);
+  }
+}
+#endif
+
 TEST_F(SolverTest, HavePreconditioner) {
   Options options;
   FakeSolver solver{&options};
@@ -52,6 +52,13 @@ public:
   BoutReal generate(const Context& ctx) override {
     return a->generate(ctx) + b->generate(ctx);
   }
+  // Compiles the arguments in reverse order, so that they aren't the
+  // last instructions in order
+  int compile(bout::generator::Program& program) const override {
+    const auto b_reg = b->compile(program);
+    const auto a_reg = a->compile(program);
+    return program.binary('+', a_reg, b_reg);
+  }
   std::string str() const override {
     return std::string{"add(" + a->str() + ", " + b->str() + ")"};
   }
@@ -679,3 +686,128 @@ TEST_F(ExpressionParserTest, FuzzyFind) {
   EXPECT_EQ(first_CAPS_match->name, "multiply");
   EXPECT_EQ(first_CAPS_match->distance, 1);
 }
+
+TEST_F(ExpressionParserTest, CompileProgram) {
+  auto fieldgen = parser.parseString("x * y - z / 2 + t^2");
+
+  const bout::generator::Program program{*fieldgen};
+  ASSERT_TRUE(program.valid());
+
+  std::vector<BoutReal> result(z_array.size());
+  std::vector<BoutReal> workspace;
+  for (auto x : x_array) {
+    for (auto y : y_array) {
+      for (auto t : t_array) {
+        program.evaluate(x, y, z_array.data(), t, static_cast<int>(z_array.size()),
+                         result.data(), workspace);
+        for (std::size_t i = 0; i < z_array.size(); ++i) {
+          EXPECT_DOUBLE_EQ(result[i],
+                           fieldgen->generate(LegacyContext(x, y, z_array[i], t)));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(ExpressionParserTest, CompileFoldsConstants) {
+  auto fieldgen = parser.parseString("(1 + 2) * (3 - 4) / 2");
+
+  const bout::generator::Program program{*fieldgen};
+  ASSERT_TRUE(program.valid());
+  EXPECT_EQ(program.size(), 1);
+
+  BoutReal result{0.0};
+  std::vector<BoutReal> workspace;
+  const BoutReal z{0.0};
+  program.evaluate(0., 0., &z, 0., 1, &result, workspace);
+  EXPECT_DOUBLE_EQ(result, -1.5);
+}
+
+TEST_F(ExpressionParserTest, CompileFoldsConstantsInAnyOrder) {
+  parser.addGenerator("add", std::make_shared<BinaryGenerator>());
+
+  auto fieldgen = parser.parseString("add(1 + 2, 3) * add(4, 5 * 6)");
+
+  const bout::generator::Program program{*fieldgen};
+  ASSERT_TRUE(program.valid());
+  EXPECT_EQ(program.size(), 1);
+
+  BoutReal result{0.0};
+  std::vector<BoutReal> workspace;
+  const BoutReal z{0.0};
+  program.evaluate(0., 0., &z, 0., 1, &result, workspace);
+  EXPECT_DOUBLE_EQ(result, 204.0);
+}
+
+TEST_F(ExpressionParserTest, CompileRemovesFoldedArguments) {
+  parser.addGenerator("add", std::make_shared<BinaryGenerator>());
+
+  // The folded constant is separated from its arguments by x
+  auto fieldgen = parser.parseString("add(x, 2 * 3) - y");
+
+  const bout::generator::Program program{*fieldgen};
+  ASSERT_TRUE(program.valid());
+  // 6, x, +, y, -
+  EXPECT_EQ(program.size(), 5);
+
+  std::vector<BoutReal> result(z_array.size());
+  std::vector<BoutReal> workspace;
+  for (auto x : x_array) {
+    for (auto y : y_array) {
+      program.evaluate(x, y, z_array.data(), 0., static_cast<int>(z_array.size()),
+                       result.data(), workspace);
+      for (std::size_t i = 0; i < z_array.size(); ++i) {
+        EXPECT_DOUBLE_EQ(result[i],
+                         fieldgen->generate(LegacyContext(x, y, z_array[i], 0.)));
+      }
+    }
+  }
+}
+
+TEST_F(ExpressionParserTest, CompileHoisted) {
+  auto fieldgen = parser.parseString("(x * z + 1) * t + (y - z) * t / 2");
+
+  const bout::generator::Program program{*fieldgen};
+  ASSERT_TRUE(program.valid());
+  EXPECT_TRUE(program.dependsOnTime());
+  // (x * z + 1) and (y - z)
+  ASSERT_EQ(program.numHoisted(), 2);
+
+  const int n = static_cast<int>(z_array.size());
+  std::vector<BoutReal> hoisted(program.numHoisted() * n);
+  std::vector<BoutReal> result(n);
+  std::vector<BoutReal> workspace;
+
+  for (auto x : {-1., 0., 0.5}) {
+    for (auto y : y_array) {
+      program.evaluateHoisted(x, y, z_array.data(), n, hoisted.data(), workspace);
+      for (auto t : t_array) {
+        program.evaluate(x, y, z_array.data(), t, n, result.data(), workspace,
+                         hoisted.data());
+        for (std::size_t i = 0; i < z_array.size(); ++i) {
+          EXPECT_DOUBLE_EQ(result[i],
+                           fieldgen->generate(LegacyContext(x, y, z_array[i], t)));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(ExpressionParserTest, CompileNotHoistedWithoutTime) {
+  auto fieldgen = parser.parseString("x * z + y");
+
+  const bout::generator::Program program{*fieldgen};
+  ASSERT_TRUE(program.valid());
+  EXPECT_FALSE(program.dependsOnTime());
+  EXPECT_EQ(program.numHoisted(), 0);
+}
+
+TEST_F(ExpressionParserTest, CompileUnsupportedGenerator) {
+  parser.addGenerator("increment", std::make_shared<IncrementGenerator>());
+
+  auto fieldgen = parser.parseString("x + increment(y)");
+
+  const bout::generator::Program program{*fieldgen};
+  EXPECT_FALSE(program.valid());
+  EXPECT_EQ(program.size(), 0);
+}
@@ -7,13 +7,23 @@
 #include "gtest/gtest.h"
 
 #include "test_extras.hxx"
+#include "bout/boutcomm.hxx"
 #include "bout/field3d.hxx"
 #include "bout/mesh.hxx"
+#include "bout/monitor.hxx"
+#include "bout/mpi_wrapper.hxx"
 #include "bout/options_netcdf.hxx"
+#include "bout/sys/timer.hxx"
 
 using bout::OptionsNetCDF;
 
+#include <algorithm>
 #include <cstdio>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <netcdf>
+#include <netcdf_meta.h>
 
 /// Global mesh
 namespace bout {
@@ -100,6 +110,66 @@ TEST_F(OptionsNetCDFTest, ReadWriteField3D) {
   EXPECT_DOUBLE_EQ(value(1, 1, 1), 2.4);
 }
 
+TEST_F(OptionsNetCDFTest, ReadWriteArray) {
+  Array<BoutReal> values(3);
+  values[0] = 1.5;
+  values[1] = -2.0;
+  values[2] = 4.25;
+  {
+    Options options;
+    options["sized"] = values;
+    options["named"] = values;
+    options["named"].attributes["array_dimension"] = "rank";
+    options["evolving"].assignRepeat(values);
+
+    OptionsNetCDF file(filename);
+    file.write(options);
+    file.write(options);
+  }
+
+  OptionsNetCDF file(filename);
+  Options data = file.read();
+
+  EXPECT_EQ(data["sized"].as<Array<BoutReal>>(), values);
+  EXPECT_EQ(data["named"].as<Array<BoutReal>>(), values);
+  EXPECT_EQ(file.readShape("evolving"), (std::vector<int>{2, 3}));
+
+  const netCDF::NcFile nc_file(filename, netCDF::NcFile::read);
+  EXPECT_EQ(nc_file.getVar("sized").getDim(0).getName(), "array3");
+  EXPECT_EQ(nc_file.getVar("named").getDim(0).getName(), "rank");
+}
+
+TEST_F(OptionsNetCDFTest, WriteTimerImbalance) {
+  Timer::cleanup();
+  { Timer timer("imbalance:test"); }
+
+  TimerImbalance imbalance;
+  imbalance.gather(*bout::globals::mesh);
+  {
+    Options options;
+    imbalance.outputVars(options);
+    OptionsNetCDF(filename).write(options);
+  }
+  Timer::cleanup();
+
+  Options data = OptionsNetCDF(filename).read();
+  auto& section = data["timing_imbalance"];
+
+  EXPECT_EQ(section["imbalance_test"]["max"].as<Array<BoutReal>>().size(), 1);
+  // The grid on each processor, indexed by rank
+  const std::map<std::string, BoutReal> expected{{"local_nx", nx - 2},
+                                                 {"local_ny", ny - 2},
+                                                 {"local_nz", nz},
+                                                 {"pe_xind", 1},
+                                                 {"pe_yind", 1}};
+  for (const auto& it : expected) {
+    ASSERT_TRUE(section.isSet(it.first)) << it.first;
+    const auto values = section[it.first].as<Array<BoutReal>>();
+    ASSERT_EQ(values.size(), 1) << it.first;
+    EXPECT_DOUBLE_EQ(values[0], it.second) << it.first;
+  }
+}
+
 TEST_F(OptionsNetCDFTest, Groups) {
   {
     Options options;
@@ -305,4 +375,458 @@ TEST_F(OptionsNetCDFTest, WriteMultipleTimeDimensions) {
   EXPECT_NO_THROW(OptionsNetCDF(filename).verifyTimesteps());
 }
 
+TEST_F(OptionsNetCDFTest, AsyncWriteCopiesData) {
+  Field3D field{2.4};
+  {
+    Options options;
+    options["test"] = field;
+
+    OptionsNetCDF file(filename, OptionsNetCDF::FileMode::replace, 1);
+    file.write(options);
+
+    // Changing the field in place doesn't change what is written
+    field(1, 1, 1) = 3.0;
+  }
+
+  Options data = OptionsNetCDF(filename).read();
+
+  Field3D value = data["test"].as<Field3D>(bout::globals::mesh);
+  EXPECT_DOUBLE_EQ(value(1, 1, 1), 2.4);
+}
+
+TEST_F(OptionsNetCDFTest, AsyncWriteTimesteps) {
+  {
+    OptionsNetCDF file(filename, OptionsNetCDF::FileMode::replace, 1);
+    Options options;
+    for (int i = 0; i < 5; ++i) {
+      options["field"].assignRepeat(Field2D(i));
+      options["t"].assignRepeat(static_cast<BoutReal>(i));
+      file.write(options);
+      file.verifyTimesteps();
+    }
+    EXPECT_NO_THROW(file.flush());
+  }
+
+  Options data = OptionsNetCDF(filename).read();
+
+  Tensor<BoutReal> field = data["field"].as<Tensor<BoutReal>>();
+  EXPECT_EQ(std::get<0>(field.shape()), 5);
+  EXPECT_DOUBLE_EQ(field(3, 1, 1), 3.0);
+  EXPECT_DOUBLE_EQ(data["t"].as<Array<BoutReal>>()[4], 4.0);
+}
+
+TEST_F(OptionsNetCDFTest, AsyncVerifyTimesteps) {
+  {
+    Options options;
+    options["thing1"].assignRepeat(1.0);
+    OptionsNetCDF(filename).write(options);
+  }
+
+  Options options;
+  options["thing1"].assignRepeat(2.0);
+  options["thing2"].assignRepeat(3.0);
+
+  OptionsNetCDF file(filename, OptionsNetCDF::FileMode::append, 1);
+  file.write(options);
+  // The check is queued, so the error is thrown later
+  file.verifyTimesteps();
+  EXPECT_THROW(file.flush(), BoutException);
+  // Only thrown once
+  EXPECT_NO_THROW(file.flush());
+}
+
+TEST_F(OptionsNetCDFTest, AsyncErrorOnClose) {
+  {
+    Options options;
+    options["thing1"].assignRepeat(1.0);
+    OptionsNetCDF(filename).write(options);
+  }
+
+  std::stringstream buffer;
+  auto* const cout_buf = std::cout.rdbuf(buffer.rdbuf());
+  {
+    Options options;
+    options["thing1"].assignRepeat(2.0);
+    options["thing2"].assignRepeat(3.0);
+
+    OptionsNetCDF file(filename, OptionsNetCDF::FileMode::append, 1);
+    file.write(options);
+    file.verifyTimesteps();
+    // Not flushed, so the error is reported when the file is closed
+  }
+  std::cout.rdbuf(cout_buf);
+
+  EXPECT_TRUE(IsSubString(buffer.str(), "Error closing NetCDF file"));
+}
+
+TEST_F(OptionsNetCDFTest, AsyncWriteSeveralFiles) {
+  // NetCDF calls from the writer threads and this thread take turns
+  const std::string other_filename{std::tmpnam(nullptr)};
+  const std::string sync_filename{std::tmpnam(nullptr)};
+  {
+    OptionsNetCDF file(filename, OptionsNetCDF::FileMode::replace, 2);
+    OptionsNetCDF other_file(other_filename, OptionsNetCDF::FileMode::replace, 2);
+    OptionsNetCDF sync_file(sync_filename);
+    Options options;
+    for (int i = 0; i < 10; ++i) {
+      options["field"].assignRepeat(Field2D(i));
+      file.write(options);
+      other_file.write(options);
+      sync_file.write(options);
+    }
+  }
+
+  for (const auto& name : {filename, other_filename, sync_filename}) {
+    Options data = OptionsNetCDF(name).read();
+    const auto field = data["field"].as<Tensor<BoutReal>>();
+    EXPECT_EQ(std::get<0>(field.shape()), 10);
+    EXPECT_DOUBLE_EQ(field(9, 1, 1), 9.0);
+  }
+  std::remove(other_filename.c_str());
+  std::remove(sync_filename.c_str());
+}
+
+TEST_F(OptionsNetCDFTest, VerifyTimestepsWhileWriting) {
+  Options options;
+  options["thing1"].assignRepeat(1.0);
+
+  OptionsNetCDF file(filename);
+  file.write(options);
+  file.write(options);
+  EXPECT_NO_THROW(file.verifyTimesteps());
+
+  Options other;
+  other["thing2"].assignRepeat(2.0);
+  file.write(other);
+  EXPECT_THROW(file.verifyTimesteps(), BoutException);
+}
+
+TEST_F(OptionsNetCDFTest, AppendAfterClose) {
+  {
+    Options options;
+    options["thing1"].assignRepeat(1.0);
+
+    OptionsNetCDF file(filename);
+    file.write(options);
+    file.write(options);
+  }
+  {
+    // Carries on from the time index saved when the file was closed
+    Options options;
+    options["thing1"].assignRepeat(2.0);
+    OptionsNetCDF(filename, OptionsNetCDF::FileMode::append).write(options);
+  }
+
+  Options data = OptionsNetCDF(filename).read();
+
+  const auto values = data["thing1"].as<Array<BoutReal>>();
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_DOUBLE_EQ(values[1], 1.0);
+  EXPECT_DOUBLE_EQ(values[2], 2.0);
+}
+
+TEST_F(OptionsNetCDFTest, WriteAfterRead) {
+  {
+    Options options;
+    options["thing1"].assignRepeat(1.0);
+
+    OptionsNetCDF file(filename);
+    file.write(options);
+    file.write(options);
+
+    // Closes the file for writing
+    EXPECT_EQ(file.readShape("thing1"), std::vector<int>{2});
+
+    // Carries on in the file, rather than replacing it
+    options["thing1"].assignRepeat(2.0);
+    file.write(options);
+  }
+
+  const auto values = OptionsNetCDF(filename).read()["thing1"].as<Array<BoutReal>>();
+  ASSERT_EQ(values.size(), 3);
+  EXPECT_DOUBLE_EQ(values[0], 1.0);
+  EXPECT_DOUBLE_EQ(values[1], 1.0);
+  EXPECT_DOUBLE_EQ(values[2], 2.0);
+}
+
+TEST_F(OptionsNetCDFTest, WriteWithoutGuardCells) {
+  const Field3D field = makeField<Field3D>([](Ind3D& i) { return i.y() + 0.1 * i.z(); });
+  {
+    Options options;
+    options["interior"] = field;
+    options["interior"].attributes["guard_cells"] = false;
+    options["all"] = field;
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  Options data = OptionsNetCDF(filename).read();
+
+  // X boundary cells are kept, but not Y guard cells
+  const auto interior = data["interior"].as<Tensor<BoutReal>>();
+  EXPECT_EQ(interior.shape(), std::make_tuple(nx, ny - 2, nz));
+  EXPECT_DOUBLE_EQ(interior(0, 0, 3), field(0, 1, 3));
+  EXPECT_DOUBLE_EQ(interior(2, 2, 6), field(2, 3, 6));
+
+  const auto all = data["all"].as<Tensor<BoutReal>>();
+  EXPECT_EQ(all.shape(), std::make_tuple(nx, ny, nz));
+}
+
+TEST_F(OptionsNetCDFTest, WriteFloats) {
+  const BoutReal third = 1. / 3;
+  {
+    Options options;
+    options["field"] = Field3D(third);
+    options["double_field"] = Field3D(third);
+    options["double_field"].attributes["precision"] = "double";
+    options["scalar"] = third;
+    options["t_array"].assignRepeat(third, "t", true);
+    Array<BoutReal> array(3);
+    std::fill(array.begin(), array.end(), third);
+    options["array"] = array;
+
+    OptionsNetCDF file(filename);
+    file.setDefaultAttributes({{"precision", "float"}});
+    file.write(options);
+  }
+
+  {
+    // Only the field is written as floats
+    netCDF::NcFile file(filename, netCDF::NcFile::read);
+    EXPECT_EQ(file.getVar("field").getType(), netCDF::ncFloat);
+    EXPECT_EQ(file.getVar("double_field").getType(), netCDF::ncDouble);
+    EXPECT_EQ(file.getVar("scalar").getType(), netCDF::ncDouble);
+    EXPECT_EQ(file.getVar("t_array").getType(), netCDF::ncDouble);
+    EXPECT_EQ(file.getVar("array").getType(), netCDF::ncDouble);
+  }
+
+  Options data = OptionsNetCDF(filename).read();
+
+  const BoutReal field = data["field"].as<Field3D>(bout::globals::mesh)(1, 1, 1);
+  EXPECT_NE(field, third);
+  EXPECT_FLOAT_EQ(field, third);
+  EXPECT_DOUBLE_EQ(data["double_field"].as<Field3D>(bout::globals::mesh)(1, 1, 1),
+                   third);
+  EXPECT_DOUBLE_EQ(data["scalar"].as<BoutReal>(), third);
+  EXPECT_DOUBLE_EQ(data["t_array"].as<Array<BoutReal>>()[0], third);
+}
+
+TEST_F(OptionsNetCDFTest, WriteCompressed) {
+  const Field3D field = makeField<Field3D>([](Ind3D& i) { return i.x() + 0.1 * i.z(); });
+  {
+    Options options;
+    options["field"] = field;
+    options["field"].attributes["compress"] = "zlib";
+    options["evolving"].assignRepeat(field);
+    options["evolving"].attributes["compress"] = "zlib";
+
+    OptionsNetCDF file(filename);
+    file.write(options);
+    file.write(options);
+  }
+
+  OptionsNetCDF file(filename);
+  Options data = file.read();
+
+  EXPECT_TRUE(IsFieldEqual(data["field"].as<Field3D>(bout::globals::mesh), field));
+  EXPECT_EQ(file.readShape("evolving"), (std::vector<int>{2, nx, ny, nz}));
+
+  // A file of one processor is chunked by the whole of each record
+  netCDF::NcFile ncfile(filename, netCDF::NcFile::read);
+  netCDF::NcVar::ChunkMode mode;
+  std::vector<std::size_t> chunks;
+  ncfile.getVar("field").getChunkingParameters(mode, chunks);
+  EXPECT_EQ(chunks, (std::vector<std::size_t>{nx, ny, nz}));
+  ncfile.getVar("evolving").getChunkingParameters(mode, chunks);
+  EXPECT_EQ(chunks, (std::vector<std::size_t>{1, nx, ny, nz}));
+}
+
+TEST_F(OptionsNetCDFTest, ReadShape) {
+  {
+    Options options;
+    options["field2d"] = Field2D(1.0);
+    options["field3d"] = Field3D(2.0);
+    options["value"] = 3;
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  OptionsNetCDF file(filename);
+  EXPECT_EQ(file.readShape("field2d"), (std::vector<int>{nx, ny}));
+  EXPECT_EQ(file.readShape("field3d"), (std::vector<int>{nx, ny, nz}));
+  EXPECT_TRUE(file.readShape("missing").empty());
+}
+
+TEST_F(OptionsNetCDFTest, ReadHyperslabMatrix) {
+  const Field2D field = makeField<Field2D>([](Ind2D& i) { return i.x() + 0.1 * i.y(); });
+  {
+    Options options;
+    options["field"] = field;
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  const auto part =
+      OptionsNetCDF(filename).readHyperslab("field", {1, 2}, {2, 3}).as<Matrix<BoutReal>>();
+
+  EXPECT_EQ(part.shape(), std::make_tuple(2, 3));
+  for (int x = 0; x < 2; ++x) {
+    for (int y = 0; y < 3; ++y) {
+      EXPECT_DOUBLE_EQ(part(x, y), field(x + 1, y + 2));
+    }
+  }
+}
+
+TEST_F(OptionsNetCDFTest, ReadHyperslabTensor) {
+  const Field3D field =
+      makeField<Field3D>([](Ind3D& i) { return i.x() + 0.1 * i.y() + 0.01 * i.z(); });
+  {
+    Options options;
+    options["field"] = field;
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  const auto part = OptionsNetCDF(filename)
+                        .readHyperslab("field", {1, 2, 3}, {2, 3, 4})
+                        .as<Tensor<BoutReal>>();
+
+  EXPECT_EQ(part.shape(), std::make_tuple(2, 3, 4));
+  for (int x = 0; x < 2; ++x) {
+    for (int y = 0; y < 3; ++y) {
+      for (int z = 0; z < 4; ++z) {
+        EXPECT_DOUBLE_EQ(part(x, y, z), field(x + 1, y + 2, z + 3));
+      }
+    }
+  }
+}
+
+TEST_F(OptionsNetCDFTest, ReadHyperslabErrors) {
+  {
+    Options options;
+    options["field"] = Field3D(1.0);
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  OptionsNetCDF file(filename);
+  EXPECT_THROW(file.readHyperslab("missing", {0, 0, 0}, {1, 1, 1}), BoutException);
+  EXPECT_THROW(file.readHyperslab("field", {0, 0}, {1, 1}), BoutException);
+}
+
+TEST_F(OptionsNetCDFTest, ReadMaxDims) {
+  {
+    Options options;
+    options["value"] = 4.5;
+    options["field"] = Field3D(1.0);
+    options["field"].attributes["units"] = "m";
+
+    OptionsNetCDF(filename).write(options);
+  }
+
+  Options data = OptionsNetCDF(filename).read(1);
+
+  EXPECT_DOUBLE_EQ(data["value"].as<BoutReal>(), 4.5);
+  // Only the attributes of larger variables are read
+  EXPECT_FALSE(data["field"].isSet());
+  EXPECT_EQ(data["field"].attributes["units"].as<std::string>(), "m");
+  EXPECT_EQ(data["field"].attributes["cell_location"].as<std::string>(),
+            toString(CELL_CENTRE));
+}
+
+/// Records the MPI-IO hints passed to MPI
+class HintsMpiWrapper : public MpiWrapper {
+public:
+  int MPI_Info_set(MPI_Info info, const char* key, const char* value) override {
+    hints[key] = value;
+    return MpiWrapper::MPI_Info_set(info, key, value);
+  }
+  std::map<std::string, std::string> hints;
+};
+
+TEST_F(OptionsNetCDFTest, WriteShared) {
+#if not NC_HAS_PARALLEL4
+  GTEST_SKIP() << "NetCDF built without parallel I/O";
+#endif
+  // Replaces the fixture's wrapper, which deletes it
+  auto* mpi = new HintsMpiWrapper();
+  delete bout::globals::mpi;
+  bout::globals::mpi = mpi;
+
+  const Field3D field = makeField<Field3D>([](Ind3D& i) { return i.y() + 0.1 * i.z(); });
+  {
+    Options options;
+    options["field"] = field;
+    options["value"] = 3;
+    options["rank"] = 0;
+    options["rank"].attributes["per_processor"] = true;
+
+    OptionsNetCDF(filename, bout::SharedFile{BoutComm::get(), {{"cb_nodes", "1"}}})
+        .write(options);
+  }
+  EXPECT_EQ(mpi->hints, (std::map<std::string, std::string>{{"cb_nodes", "1"}}));
+
+  Options data = OptionsNetCDF(filename).read();
+
+  EXPECT_EQ(data["value"], 3);
+  EXPECT_FALSE(data.isSet("rank"));
+  // Global array, without Y guard cells
+  const auto written = data["field"].as<Tensor<BoutReal>>();
+  EXPECT_EQ(written.shape(), std::make_tuple(nx, ny - 2, nz));
+  EXPECT_DOUBLE_EQ(written(2, 2, 6), field(2, 3, 6));
+}
+
+TEST_F(OptionsNetCDFTest, WriteSharedCompressed) {
+#if not NC_HAS_PARALLEL4
+  GTEST_SKIP() << "NetCDF built without parallel I/O";
+#endif
+  const Field3D field = makeField<Field3D>([](Ind3D& i) { return i.x() + 0.1 * i.z(); });
+  {
+    Options options;
+    options["evolving"].assignRepeat(field);
+    options["evolving"].attributes["compress"] = "zlib";
+
+    OptionsNetCDF file(filename, bout::SharedFile{BoutComm::get(), {}});
+    file.write(options);
+  }
+
+  // Chunked by the interior of one processor, without the X boundary
+  // cells, which only some processors write
+  netCDF::NcFile ncfile(filename, netCDF::NcFile::read);
+  netCDF::NcVar::ChunkMode mode;
+  std::vector<std::size_t> chunks;
+  ncfile.getVar("evolving").getChunkingParameters(mode, chunks);
+  EXPECT_EQ(chunks, (std::vector<std::size_t>{1, nx - 2, ny - 2, nz}));
+}
+
+TEST_F(OptionsNetCDFTest, WriteSharedMonitorOutput) {
+#if not NC_HAS_PARALLEL4
+  GTEST_SKIP() << "NetCDF built without parallel I/O";
+#endif
+  RunMetrics metrics;
+  metrics.wtime = 2.0;
+  metrics.ncalls = 4;
+  TimerImbalance imbalance;
+  imbalance.gather(*bout::globals::mesh);
+
+  // As written by BoutMonitor and the mesh
+  Options options;
+  metrics.maxOverProcessors().outputVars(options);
+  imbalance.outputVars(options);
+  options["PE_XIND"] = 1;
+  options["PE_XIND"].attributes["per_processor"] = true;
+
+  OptionsNetCDF(filename, bout::SharedFile{BoutComm::get(), {}}).write(options);
+
+  Options data = OptionsNetCDF(filename).read();
+
+  // Reduced over processors, so written
+  EXPECT_DOUBLE_EQ(data["wtime"].as<Array<BoutReal>>()[0], 2.0);
+  EXPECT_DOUBLE_EQ(data["ncalls"].as<Array<BoutReal>>()[0], 4);
+  EXPECT_DOUBLE_EQ(data["wtime_per_rhs"].as<Array<BoutReal>>()[0], 0.5);
+  EXPECT_TRUE(data["timing_imbalance"].isSet("local_nx"));
+  // Different on each processor, so skipped
+  EXPECT_FALSE(data.isSet("PE_XIND"));
+}
+
 #endif // BOUT_HAS_NETCDF
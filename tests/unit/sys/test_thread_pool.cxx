@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+
+#include "test_extras.hxx"
+#include "bout/boutexception.hxx"
+#include "bout/derivs.hxx"
+#include "bout/field3d.hxx"
+#include "bout/mesh.hxx"
+#include "bout/msg_stack.hxx"
+#include "bout/sys/timer.hxx"
+#include "bout/thread_pool.hxx"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/// Global mesh
+namespace bout {
+namespace globals {
+extern Mesh* mesh;
+} // namespace globals
+} // namespace bout
+
+// The unit tests use the global mesh
+using namespace bout::globals;
+using bout::TaskGroup;
+using bout::ThreadPool;
+
+TEST(ThreadPoolTest, Resize) {
+  ThreadPool pool;
+  EXPECT_EQ(pool.size(), 0);
+  pool.resize(3);
+  EXPECT_EQ(pool.size(), 3);
+  pool.resize(1);
+  EXPECT_EQ(pool.size(), 1);
+  pool.resize(0);
+  EXPECT_EQ(pool.size(), 0);
+}
+
+TEST(ThreadPoolTest, NoThreads) {
+  ThreadPool pool;
+  TaskGroup group(pool);
+
+  int count = 0;
+  group.run([&]() { ++count; });
+  // Run immediately
+  EXPECT_EQ(count, 1);
+  group.wait();
+  EXPECT_EQ(count, 1);
+}
+
+TEST(ThreadPoolTest, TaskGroup) {
+  ThreadPool pool;
+  pool.resize(3);
+
+  std::atomic<int> count{0};
+  TaskGroup group(pool);
+  for (int i = 0; i < 100; ++i) {
+    group.run([&]() { ++count; });
+  }
+  group.wait();
+  EXPECT_EQ(count, 100);
+}
+
+TEST(ThreadPoolTest, NestedGroups) {
+  ThreadPool pool;
+  pool.resize(2);
+
+  std::atomic<int> count{0};
+  TaskGroup outer(pool);
+  for (int i = 0; i < 10; ++i) {
+    outer.run([&]() {
+      TaskGroup inner(pool);
+      for (int j = 0; j < 10; ++j) {
+        inner.run([&]() { ++count; });
+      }
+      inner.wait();
+    });
+  }
+  outer.wait();
+  EXPECT_EQ(count, 100);
+}
+
+TEST(ThreadPoolTest, Exception) {
+  ThreadPool pool;
+  pool.resize(2);
+
+  std::atomic<int> count{0};
+  TaskGroup group(pool);
+  for (int i = 0; i < 10; ++i) {
+    group.run([&, i]() {
+      ++count;
+      if (i == 5) {
+        throw BoutException("Task failed");
+      }
+    });
+  }
+  EXPECT_THROW(group.wait(), BoutException);
+  // Other tasks still run
+  EXPECT_EQ(count, 10);
+  // Only thrown once
+  EXPECT_NO_THROW(group.wait());
+}
+
+TEST(ThreadPoolTest, UsesThreads) {
+  ThreadPool pool;
+  pool.resize(2);
+
+  const auto caller = std::this_thread::get_id();
+  std::atomic<bool> other_thread{false};
+  TaskGroup group(pool);
+  for (int i = 0; i < 20; ++i) {
+    group.run([&]() {
+      if (std::this_thread::get_id() != caller) {
+        other_thread = true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+  }
+  group.wait();
+  EXPECT_TRUE(other_thread);
+}
+
+class ParallelForTest : public FakeMeshFixture {
+public:
+  ~ParallelForTest() override { ThreadPool::getInstance().resize(0); }
+};
+
+TEST_F(ParallelForTest, NoThreads) {
+  Field3D result{0.0};
+  bout::parallelFor(result.getRegion("RGN_ALL"),
+                    [&](const Ind3D& i) { result[i] = i.x() + i.z(); });
+
+  for (const auto& i : result.getRegion("RGN_ALL")) {
+    EXPECT_DOUBLE_EQ(result[i], i.x() + i.z());
+  }
+}
+
+TEST_F(ParallelForTest, Threads) {
+  ThreadPool::getInstance().resize(3);
+
+  Field3D result{0.0};
+  bout::parallelFor(result.getRegion("RGN_NOBNDRY"),
+                    [&](const Ind3D& i) { result[i] += i.x() + i.z(); });
+
+  EXPECT_TRUE(IsFieldEqual(
+      result, makeField<Field3D>([](Ind3D& i) { return i.x() + i.z(); }),
+      "RGN_NOBNDRY"));
+}
+
+TEST_F(ParallelForTest, DerivativeTasks) {
+  const Field3D f =
+      makeField<Field3D>([](Ind3D& i) { return i.x() * i.x() + 0.1 * i.z() * i.z(); });
+  const Field3D expected_ddx = DDX(f);
+  const Field3D expected_ddz = DDZ(f);
+
+  ThreadPool::getInstance().resize(3);
+
+  // The operators push messages onto msg_stack and start timers, from
+  // threads outside any OpenMP region
+  const auto messages = msg_stack.getDump();
+  constexpr std::size_t ntasks = 16;
+  std::vector<Field3D> ddx(ntasks);
+  std::vector<Field3D> ddz(ntasks);
+  TaskGroup group;
+  for (std::size_t task = 0; task < ntasks; ++task) {
+    group.run([&, task]() {
+      Timer timer("derivative task");
+      ddx[task] = DDX(f);
+      ddz[task] = DDZ(f);
+    });
+  }
+  group.wait();
+
+  for (std::size_t task = 0; task < ntasks; ++task) {
+    EXPECT_TRUE(IsFieldEqual(ddx[task], expected_ddx, "RGN_NOBNDRY"));
+    EXPECT_TRUE(IsFieldEqual(ddz[task], expected_ddz, "RGN_NOBNDRY"));
+  }
+  EXPECT_EQ(msg_stack.getDump(), messages);
+  // Every timer has been stopped
+  const auto timer = Timer::getAllInfo().at("derivative task");
+  EXPECT_EQ(timer.counter, 0U);
+  EXPECT_FALSE(timer.running);
+  Timer::cleanup();
+}
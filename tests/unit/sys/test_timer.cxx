@@ -3,7 +3,9 @@
 
 #include "bout/sys/timer.hxx"
 
+#include <algorithm>
 #include <chrono>
+#include <sstream>
 #include <thread>
 
 namespace bout {
@@ -275,3 +277,101 @@ TEST(TimerTest, ListAllInfo) {
   EXPECT_THAT(cout_capture.str(), ContainsRegex("two *| 0 * | 2    | 0\\.\\d+"));
 }
 #endif
+
+namespace {
+/// Find the region with \p path, or nullptr
+const bout::timing::RegionTime*
+findRegion(const std::vector<bout::timing::RegionTime>& regions,
+           const std::string& path) {
+  const auto it = std::find_if(regions.begin(), regions.end(),
+                               [&](const auto& region) { return region.path == path; });
+  return (it == regions.end()) ? nullptr : &(*it);
+}
+} // namespace
+
+TEST(TimerTest, RegionId) {
+  const auto id = bout::timing::getRegionId("RegionId test");
+  EXPECT_EQ(bout::timing::getRegionId("RegionId test"), id);
+  EXPECT_NE(bout::timing::getRegionId("RegionId test 2"), id);
+  EXPECT_EQ(bout::timing::getRegionName(id), "RegionId test");
+}
+
+TEST(TimerTest, NestedRegions) {
+  bout::timing::resetRegions();
+
+  const auto start = Timer::clock_type::now();
+  {
+    BOUT_TIME_REGION("outer");
+    for (int i = 0; i < 3; ++i) {
+      BOUT_TIME_REGION("inner");
+      std::this_thread::sleep_for(bout::testing::sleep_length);
+    }
+  }
+  const Timer::seconds elapsed = Timer::clock_type::now() - start;
+  {
+    // Same region, but not inside "outer"
+    BOUT_TIME_REGION("inner");
+  }
+
+  const auto regions = bout::timing::getRegionTimes();
+
+  const auto* outer = findRegion(regions, "outer");
+  ASSERT_NE(outer, nullptr);
+  EXPECT_EQ(outer->depth, 0);
+  EXPECT_EQ(outer->hits, 1UL);
+  EXPECT_NEAR(outer->time, elapsed.count(), bout::testing::TimerTolerance);
+
+  const auto* inner = findRegion(regions, "outer/inner");
+  ASSERT_NE(inner, nullptr);
+  EXPECT_EQ(inner->depth, 1);
+  EXPECT_EQ(inner->hits, 3UL);
+  EXPECT_LE(inner->time, outer->time);
+  // Enclosed regions come after the region enclosing them
+  EXPECT_GT(inner, outer);
+
+  const auto* top_inner = findRegion(regions, "inner");
+  ASSERT_NE(top_inner, nullptr);
+  EXPECT_EQ(top_inner->hits, 1UL);
+}
+
+TEST(TimerTest, RegionThreads) {
+  bout::timing::resetRegions();
+
+  const auto work = []() {
+    BOUT_TIME_REGION("RegionThreads test");
+  };
+  std::thread first{work};
+  std::thread second{work};
+  first.join();
+  second.join();
+  work();
+
+  const auto regions = bout::timing::getRegionTimes();
+  const auto* region = findRegion(regions, "RegionThreads test");
+  ASSERT_NE(region, nullptr);
+  EXPECT_EQ(region->hits, 3UL);
+  EXPECT_EQ(region->threads, 3);
+}
+
+TEST(TimerTest, RegionTrace) {
+  bout::timing::resetRegions();
+  bout::timing::setTracing(true);
+  {
+    BOUT_TIME_REGION("trace \"quoted\"");
+  }
+  bout::timing::setTracing(false);
+  {
+    BOUT_TIME_REGION("not traced");
+  }
+
+  std::stringstream trace;
+  bout::timing::writeTrace(trace, 3);
+
+  using namespace ::testing;
+  EXPECT_THAT(trace.str(), StartsWith("{\"traceEvents\":["));
+  EXPECT_THAT(trace.str(), HasSubstr(R"("name":"trace \"quoted\"","ph":"X")"));
+  EXPECT_THAT(trace.str(), HasSubstr(R"("pid":3)"));
+  EXPECT_THAT(trace.str(), Not(HasSubstr("not traced")));
+
+  bout::timing::resetRegions();
+}